@@ -1,20 +1,18 @@
 #include "Area.h"
-#include <vector>
 
-
-  //Name: Area (Overloaded Constructor)
+  //Name: Area (View Constructor)
   //Precondition: Must have valid input for each part of a area
   // First int is the unique identifier for this particular area.
-  // The first string is the name of the area
-  // The second string is the description of the area
+  // The first string_view is the name of the area
+  // The second string_view is the description of the area
   // The last four ints are the unique identifier for adjacent areas
   //     (-1 = no path)
   // North, East, South, and West
-  //Postcondition: Creates a new area
-Area::Area(int id, string name, string desc, int north, int east, int south, int west) {
-    m_ID = id;
-    m_name = name;
-    m_desc = desc;
+  // The text must outlive the area
+  //Postcondition: Creates a new area that refers to the text in place
+  //  (nothing is copied)
+Area::Area(int id, string_view name, string_view desc, int north, int east, int south, int west)
+    : m_ID(id), m_name(name), m_desc(desc) {
     m_direction[0] = north;
     m_direction[1] = east;
     m_direction[2] = south;
@@ -22,20 +20,20 @@ Area::Area(int id, string name, string desc, int north, int east, int south, int
 }
   //Name: GetName
   //Precondition: Must have valid area
-  //Postcondition: Returns area name as string
-string Area::GetName() {
+  //Postcondition: Returns area name as a string_view (no copy)
+string_view Area::GetName() const {
     return m_name;
 }
   //Name: GetID
   //Precondition: Must have valid area
   //Postcondition: Returns area id as int
-int Area::GetID() {
+int Area::GetID() const {
     return m_ID;
 }
   //Name: GetDesc
   //Precondition: Must have valid area
-  //Postcondition: Returns area desc as string
-string Area::GetDesc() {
+  //Postcondition: Returns area desc as a string_view (no copy)
+string_view Area::GetDesc() const {
     return m_desc;
 }
 //Name: CheckDirection
@@ -44,7 +42,7 @@ string Area::GetDesc() {
 //returns the ID of the area in that direction
 //Postcondition: Returns id of area in that direction if the exit exists
 //If there is no exit in that direction, returns -1
-int Area::CheckDirection(char myDirection) {
+int Area::CheckDirection(char myDirection) const {
     int index = 0;
     //Map char to its corresponding int value
     if (myDirection == 'n' || myDirection == 'N') {
@@ -63,36 +61,21 @@ int Area::CheckDirection(char myDirection) {
 }
   //Name: PrintArea
   //Precondition: Area must be complete
-  //Postcondition: Outputs the area name, area desc, then possible exits
-void Area::PrintArea() {
+  //Postcondition: Writes the area name, area desc, then possible exits
+  //  to out
+void Area::PrintArea(OutputSink& out) const {
+    const char *directionNames[4] = {"North", "East", "South", "West"};
     //Print area name
-    cout << '\n' << m_name << '\n' << m_desc << endl;
-    cout << "Possible Exits: ";
-    
-    //Create a vector to hold all available paths
-    vector<string> availablePaths;
+    out << '\n' << m_name << '\n' << m_desc << '\n';
+    out << "Possible Exits: ";
+    //Display all available paths, seperated with commas
+    bool first = true;
     for (unsigned long i = 0; i < sizeof(m_direction)/sizeof(m_direction[0]); i++){
         //If path exists in that direction...
         if (m_direction[i] != -1) {
-            //Match the index with proper direction
-           if (i == 0) {
-                availablePaths.push_back("North");
-            } else if (i == 1) {
-                availablePaths.push_back("East");
-            } else if (i == 2) {
-                availablePaths.push_back("South");
-            } else if (i == 3) {
-                availablePaths.push_back("West");
-            }
-        }   
-    }
-    //Display all available paths in a clean manner.
-    for (unsigned long i = 0; i < availablePaths.size(); i++) {
-        cout << availablePaths[i];
-        if (availablePaths.size() > 1 && i != availablePaths.size() - 1) {
-            //Seperate available paths with comma
-            cout << ", ";
+            out << (first ? "" : ", ") << directionNames[i];
+            first = false;
         }
     }
-    cout << endl;
+    out << '\n';
 }
\ No newline at end of file
@@ -2,50 +2,58 @@
 #define AREA_H //Header Guard
 #include <iostream>
 #include <string>
+#include <string_view>
+#include "OutputSink.h"
 using namespace std;
 
 //Enum defining the directions in array n/N = 0, e/E = 1, s/S = 2, w/W = 3
 enum direction{n=0,N=0,e=1,E=1,s=2,S=2,w=3,W=3};
 
+//An Area is a small view of one area: its id, exits and views of its
+//name and description. The text lives in a World, a mapped file or the
+//lazy area cache, which must outlive the Area.
 class Area {
  public:
-  //Name: Area (Overloaded Constructor)
+  //Name: Area (View Constructor)
   //Precondition: Must have valid input for each part of a area
   // First int is the unique identifier for this particular area.
-  // The first string is the name of the area
-  // The second string is the description of the area
+  // The first string_view is the name of the area
+  // The second string_view is the description of the area
   // The last four ints are the unique identifier for adjacent areas
   //     (-1 = no path)
   // North, East, South, and West
-  //Postcondition: Creates a new area
-  Area(int, string, string, int, int, int, int);
+  // The text must outlive the area
+  //Postcondition: Creates a new area that refers to the text in place
+  //  (nothing is copied)
+  Area(int, string_view, string_view, int, int, int, int);
   //Name: GetName
   //Precondition: Must have valid area
-  //Postcondition: Returns area name as string
-  string GetName();
+  //Postcondition: Returns area name as a string_view (no copy)
+  string_view GetName() const;
   //Name: GetID
   //Precondition: Must have valid area
   //Postcondition: Returns area id as int
-  int GetID();
+  int GetID() const;
   //Name: GetDesc
   //Precondition: Must have valid area
-  //Postcondition: Returns area desc as string
-  string GetDesc();
+  //Postcondition: Returns area desc as a string_view (no copy)
+  string_view GetDesc() const;
   //Name: CheckDirection
   //Precondition: Must have valid area
   //You pass it a char (N/n, E/e, S/s, or W/w) and if that is a valid exit it
   //returns the ID of the area in that direction
   //Postcondition: Returns id of area in that direction if the exit exists
   //If there is no exit in that direction, returns -1
-  int CheckDirection(char myDirection);
+  int CheckDirection(char myDirection) const;
   //Name: PrintArea
   //Precondition: Area must be complete
-  //Postcondition: Outputs the area name, area desc, then possible exits
-  void PrintArea();
+  //Postcondition: Writes the area name, area desc, then possible exits
+  //  to out
+  void PrintArea(OutputSink& out) const;
  private:
   int m_ID; //Unique int for area number
-  string m_name; //Name of area
-  string m_desc; //Description of area
+  string_view m_name; //Name of area
+  string_view m_desc; //Description of area
   int m_direction[4]; //Array holding area to north, east, south, west (-1 if no exit)
 };
 
@@ -0,0 +1,72 @@
+#include "AreaCache.h"
+  // Name: AreaCache(int capacity)
+  // Description: Creates an empty cache.
+  // Preconditions: capacity >= 1.
+  // Postconditions: At most capacity areas will be kept.
+AreaCache::AreaCache(int capacity) : m_capacity(capacity < 1 ? 1 : capacity), m_misses(0) {}
+  // Name: Get(int index)
+  // Description: Looks up cached text and marks it most recently used.
+  // Preconditions: None.
+  // Postconditions: Returns the text, or nullptr on a miss. The pointer
+  //                 stays valid until the entry is evicted.
+const AreaText* AreaCache::Get(int index) {
+    unordered_map<int, list<pair<int, AreaText> >::iterator>::iterator found = m_where.find(index);
+    if (found == m_where.end()) {
+        return nullptr;
+    }
+    //Move the hit to the front without reallocating the list node
+    m_order.splice(m_order.begin(), m_order, found->second);
+    return &found->second->second;
+}
+  // Name: Put(int index, AreaText&& text)
+  // Description: Adds an area's text, evicting the least recently used
+  //              entry if the cache is full.
+  // Preconditions: index is not already cached.
+  // Postconditions: text is moved in; returns the cached copy.
+const AreaText* AreaCache::Put(int index, AreaText&& text) {
+    EvictTo(m_capacity - 1);
+    m_order.emplace_front(index, std::move(text));
+    m_where[index] = m_order.begin();
+    m_misses++;
+    return &m_order.front().second;
+}
+  // Name: SetCapacity(int capacity)
+  // Description: Changes the bound, evicting areas if needed.
+  // Preconditions: capacity >= 1.
+  // Postconditions: GetSize() <= capacity.
+void AreaCache::SetCapacity(int capacity) {
+    m_capacity = capacity < 1 ? 1 : capacity;
+    EvictTo(m_capacity);
+}
+  // Name: Clear()
+  // Description: Drops every cached entry.
+  // Preconditions: No pointers from Get/Put are still in use.
+  // Postconditions: Cache is empty.
+void AreaCache::Clear() {
+    EvictTo(0);
+}
+  // Name: GetSize() const
+  // Description: Reports how many areas are cached.
+  // Preconditions: None.
+  // Postconditions: Returns the number of cached areas.
+int AreaCache::GetSize() const {
+    return static_cast<int>(m_order.size());
+}
+  // Name: GetMisses() const
+  // Description: Reports how many Put calls (i.e. loads) have been made.
+  // Preconditions: None.
+  // Postconditions: Returns m_misses.
+long AreaCache::GetMisses() const {
+    return m_misses;
+}
+  // Name: EvictTo(int size)
+  // Description: Drops least recently used entries until size remain.
+  // Preconditions: size >= 0.
+  // Postconditions: GetSize() <= size.
+void AreaCache::EvictTo(int size) {
+    while (static_cast<int>(m_order.size()) > size) {
+        //Least recently used lives at the back
+        m_where.erase(m_order.back().first);
+        m_order.pop_back();
+    }
+}
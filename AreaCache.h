@@ -0,0 +1,71 @@
+#ifndef AREACACHE_H
+#define AREACACHE_H
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+using namespace std;
+
+//Text of one area read from the map file
+struct AreaText {
+  string m_name; //Area name
+  string m_desc; //Area description
+};
+
+//Bounded least-recently-used cache of area text, keyed by area index.
+//Used by the lazy world mode so only recently visited areas keep their
+//name and description in memory (exits live in the World).
+class AreaCache {
+public:
+  // Name: AreaCache(int capacity)
+  // Description: Creates an empty cache.
+  // Preconditions: capacity >= 1.
+  // Postconditions: At most capacity areas will be kept.
+  AreaCache(int capacity);
+  AreaCache(const AreaCache&) = delete;
+  AreaCache& operator=(const AreaCache&) = delete;
+  // Name: Get(int index)
+  // Description: Looks up cached text and marks it most recently used.
+  // Preconditions: None.
+  // Postconditions: Returns the text, or nullptr on a miss. The pointer
+  //                 stays valid until the entry is evicted.
+  const AreaText* Get(int index);
+  // Name: Put(int index, AreaText&& text)
+  // Description: Adds an area's text, evicting the least recently used
+  //              entry if the cache is full.
+  // Preconditions: index is not already cached.
+  // Postconditions: text is moved in; returns the cached copy.
+  const AreaText* Put(int index, AreaText&& text);
+  // Name: SetCapacity(int capacity)
+  // Description: Changes the bound, evicting areas if needed.
+  // Preconditions: capacity >= 1.
+  // Postconditions: GetSize() <= capacity.
+  void SetCapacity(int capacity);
+  // Name: Clear()
+  // Description: Drops every cached entry.
+  // Preconditions: No pointers from Get/Put are still in use.
+  // Postconditions: Cache is empty.
+  void Clear();
+  // Name: GetSize() const
+  // Description: Reports how many areas are cached.
+  // Preconditions: None.
+  // Postconditions: Returns the number of cached areas.
+  int GetSize() const;
+  // Name: GetMisses() const
+  // Description: Reports how many Put calls (i.e. loads) have been made.
+  // Preconditions: None.
+  // Postconditions: Returns m_misses.
+  long GetMisses() const;
+private:
+  // Name: EvictTo(int size)
+  // Description: Drops least recently used entries until size remain.
+  // Preconditions: size >= 0.
+  // Postconditions: GetSize() <= size.
+  void EvictTo(int size);
+  int m_capacity; //Maximum number of cached areas
+  long m_misses; //Number of areas loaded into the cache
+  list<pair<int, AreaText> > m_order; //Most recently used at the front
+  unordered_map<int, list<pair<int, AreaText> >::iterator> m_where; //Index -> list node
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef BENCH_H
+#define BENCH_H
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+using namespace std;
+
+//Minimal timing harness shared by the benchmark groups in bench_*.cpp.
+//Each Run repeats its body, counts heap allocations (operator new is
+//replaced in bench.cpp) and prints the fastest repetition, the median
+//and the 90th percentile in ns/op, plus allocations per op. Results are
+//also kept so main can write them as JSON for comparing releases.
+//Build: see README (bench target). Run: ./cavern_bench [group] [--reps N] [--json FILE]
+
+//Number of global operator new calls made so far (counted in bench.cpp)
+long AllocCount();
+
+//One timed benchmark
+struct BenchResult {
+  string m_group; //Group it ran in
+  string m_name; //Benchmark name
+  long m_ops; //Operations per repetition
+  int m_reps; //Repetitions timed
+  double m_best; //Fastest repetition (ns/op)
+  double m_median; //50th percentile (ns/op)
+  double m_p90; //90th percentile (ns/op)
+  double m_allocs; //Heap allocations per op, over all repetitions
+};
+
+class Bench {
+public:
+  // Name: Bench(const string& filter)
+  // Description: Creates a harness that only runs groups whose name
+  //              contains filter (empty filter runs everything).
+  // Preconditions: None.
+  // Postconditions: m_filter is set; runs default to 5 repetitions.
+  Bench(const string& filter) : m_filter(filter), m_reps(5) {}
+  // Name: Enabled(const string& group) const
+  // Description: Checks whether a benchmark group should run.
+  // Preconditions: None.
+  // Postconditions: Returns true if group matches the filter.
+  bool Enabled(const string& group) const {
+    return m_filter.empty() || group.find(m_filter) != string::npos;
+  }
+  // Name: SetGroup(const string& group)
+  // Description: Names the group the following results belong to.
+  // Preconditions: None.
+  // Postconditions: m_group is set.
+  void SetGroup(const string& group) {
+    m_group = group;
+  }
+  // Name: SetRepetitions(int reps)
+  // Description: Sets the repetitions of runs that do not pin their own.
+  // Preconditions: reps >= 1.
+  // Postconditions: m_reps is set.
+  void SetRepetitions(int reps) {
+    m_reps = reps;
+  }
+  // Name: Run(const string& name, long ops, F body, int reps)
+  // Description: Times body() reps times (0 = the default count) and
+  //              records and prints the result line.
+  // Preconditions: body performs ops operations per call.
+  // Postconditions: One result line is written to cout.
+  template <typename F>
+  void Run(const string& name, long ops, F body, int reps = 0) {
+    reps = reps > 0 ? reps : m_reps;
+    vector<double> samples;
+    long allocs = 0;
+    for (int i = 0; i < reps; i++) {
+      long before = AllocCount();
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      body();
+      chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+      allocs += AllocCount() - before;
+      samples.push_back(chrono::duration<double, nano>(stop - start).count() / (ops > 0 ? ops : 1));
+    }
+    Record(name, ops, samples, allocs);
+  }
+  // Name: PrintHeader() const
+  // Description: Prints the column titles of the result lines.
+  // Preconditions: None.
+  // Postconditions: One line is written to cout.
+  void PrintHeader() const;
+  // Name: WriteJson(const string& path) const
+  // Description: Writes every recorded result as a JSON document.
+  // Preconditions: path is writable.
+  // Postconditions: Returns false if the file could not be written.
+  bool WriteJson(const string& path) const;
+private:
+  // Name: Record(const string& name, long ops, vector<double>& samples, long allocs)
+  // Description: Summarizes one run's ns/op samples, stores and prints it.
+  // Preconditions: samples is not empty.
+  // Postconditions: m_results has the result; samples is sorted.
+  void Record(const string& name, long ops, vector<double>& samples, long allocs);
+  string m_filter; //Substring a group name must contain to run
+  string m_group; //Group of the results being recorded
+  int m_reps; //Default repetitions per run
+  vector<BenchResult> m_results; //Everything run so far
+};
+
+//Benchmark groups (one per bench_*.cpp file)
+void RunMapBenchmarks(Bench& bench);
+void RunLoadBenchmarks(Bench& bench);
+void RunWorldBenchmarks(Bench& bench);
+void RunCraftBenchmarks(Bench& bench);
+void RunRandomBenchmarks(Bench& bench);
+void RunOutputBenchmarks(Bench& bench);
+void RunSnapshotBenchmarks(Bench& bench);
+void RunJournalBenchmarks(Bench& bench);
+
+//Keeps the optimizer from discarding a computed value
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+#endif
@@ -0,0 +1,183 @@
+#include "Command.h"
+#include <cctype>
+#include <charconv>
+#include <sstream>
+#include <vector>
+
+//Verb spellings and what they mean
+struct VerbName {
+  const char *m_name;
+  CommandVerb m_verb;
+};
+
+const VerbName VERB_NAMES[] = {
+  {"look", CMD_LOOK}, {"l", CMD_LOOK},
+  {"move", CMD_MOVE}, {"go", CMD_MOVE},
+  {"gather", CMD_GATHER},
+  {"craft", CMD_CRAFT},
+  {"inventory", CMD_INVENTORY}, {"inv", CMD_INVENTORY}, {"i", CMD_INVENTORY},
+  {"travel", CMD_TRAVEL},
+  {"plan", CMD_PLAN},
+  {"craftable", CMD_CRAFTABLE},
+  {"name", CMD_NAME},
+  {"save", CMD_SAVE},
+  {"load", CMD_LOAD},
+  {"help", CMD_HELP},
+  {"quit", CMD_QUIT}, {"exit", CMD_QUIT}
+};
+
+//Keywords in GatherKind order
+const char *GATHER_NAMES[] = {"raw", "natural", "food", "hunt"};
+
+// Name: Lower(string text)
+// Description: ASCII lower case copy of text.
+// Preconditions: None.
+// Postconditions: Returns the copy.
+static string Lower(string text) {
+    for (unsigned long i = 0; i < text.size(); i++) {
+        text[i] = static_cast<char>(tolower(static_cast<unsigned char>(text[i])));
+    }
+    return text;
+}
+
+// Name: ParseNumber(const string& word, int& number)
+// Description: Parses word as a whole non-negative decimal number.
+// Preconditions: None.
+// Postconditions: Returns false if word is anything else.
+static bool ParseNumber(const string& word, int& number) {
+    if (word.empty() || !isdigit(static_cast<unsigned char>(word[0]))) {
+        return false;
+    }
+    const char *end = word.data() + word.size();
+    from_chars_result result = from_chars(word.data(), end, number);
+    return result.ec == errc() && result.ptr == end;
+}
+
+// Name: ParseDirection(const string& word)
+// Description: Maps n/e/s/w or north/east/south/west to an exit index.
+// Preconditions: word is lower case.
+// Postconditions: Returns 0 - 3 (N E S W), or -1.
+static int ParseDirection(const string& word) {
+    const char *names[] = {"north", "east", "south", "west"};
+    for (int i = 0; i < 4; i++) {
+        if (word == names[i] || (word.size() == 1 && word[0] == names[i][0])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Name: ParseCommand(const string& line, Command& command, string& error)
+// Description: Parses one line of the command language. A trailing
+//              number after a craft item is the batch size.
+// Preconditions: None.
+// Postconditions: Returns true and fills command (CMD_NONE for a blank
+//                 line or comment); otherwise returns false and error
+//                 says what is wrong. Names are not checked here.
+bool ParseCommand(const string& line, Command& command, string& error) {
+    command.m_verb = CMD_NONE;
+    command.m_text.clear();
+    command.m_number = 0;
+    //Split on whitespace, up to any comment
+    vector<string> words;
+    stringstream input(line.substr(0, line.find('#')));
+    string word;
+    while (input >> word) {
+        words.push_back(word);
+    }
+    if (words.empty()) {
+        return true;
+    }
+    string verb = Lower(words[0]);
+    //A bare direction is a move
+    if (words.size() == 1 && ParseDirection(verb) >= 0) {
+        command.m_verb = CMD_MOVE;
+        command.m_number = ParseDirection(verb);
+        return true;
+    }
+    bool known = false;
+    for (unsigned long i = 0; i < sizeof(VERB_NAMES) / sizeof(VERB_NAMES[0]) && !known; i++) {
+        if (verb == VERB_NAMES[i].m_name) {
+            command.m_verb = VERB_NAMES[i].m_verb;
+            known = true;
+        }
+    }
+    if (!known) {
+        error = "Unknown command: " + words[0] + " (try help)";
+        return false;
+    }
+    //Everything after the verb, joined back with single spaces
+    int count = static_cast<int>(words.size()) - 1;
+    string rest;
+    for (unsigned long i = 1; i < words.size(); i++) {
+        rest += (i > 1 ? " " : "") + words[i];
+    }
+    if (command.m_verb == CMD_MOVE) {
+        command.m_number = count == 1 ? ParseDirection(Lower(rest)) : -1;
+        if (command.m_number < 0) {
+            error = "Usage: move n|e|s|w";
+            return false;
+        }
+    } else if (command.m_verb == CMD_GATHER) {
+        command.m_number = -1;
+        for (int i = 0; i < 4 && count == 1; i++) {
+            if (Lower(rest) == GATHER_NAMES[i]) {
+                command.m_number = i;
+            }
+        }
+        if (command.m_number < 0) {
+            error = "Usage: gather raw|natural|food|hunt";
+            return false;
+        }
+    } else if (command.m_verb == CMD_CRAFT) {
+        command.m_number = 1;
+        //A trailing number is the batch size, not part of the name
+        if (count > 1 && ParseNumber(words.back(), command.m_number)) {
+            rest.erase(rest.size() - words.back().size() - 1);
+            count--;
+        }
+        if (count == 0 || command.m_number < 1) {
+            error = "Usage: craft <item> [count]";
+            return false;
+        }
+        command.m_text = rest;
+    } else if (command.m_verb == CMD_TRAVEL) {
+        if (count != 1 || !ParseNumber(rest, command.m_number)) {
+            error = "Usage: travel <area number>";
+            return false;
+        }
+    } else if (command.m_verb == CMD_PLAN || command.m_verb == CMD_NAME) {
+        if (count == 0) {
+            error = string("Usage: ") + (command.m_verb == CMD_PLAN ? "plan <item>" : "name <hero name>");
+            return false;
+        }
+        command.m_text = rest;
+    } else if (command.m_verb == CMD_SAVE || command.m_verb == CMD_LOAD) {
+        //The file is optional
+        command.m_text = rest;
+    } else if (count > 0) {
+        error = words[0] + " takes no arguments";
+        return false;
+    }
+    return true;
+}
+
+// Name: GetCommandHelp()
+// Description: One line per command, for the help command.
+// Preconditions: None.
+// Postconditions: Returns the summary.
+const char* GetCommandHelp() {
+    return "Commands:\n"
+           "  look\n"
+           "  move n|e|s|w\n"
+           "  gather raw|natural|food|hunt\n"
+           "  craft <item> [count]\n"
+           "  inventory\n"
+           "  travel <area number>\n"
+           "  plan <item>\n"
+           "  craftable\n"
+           "  name <hero name>\n"
+           "  save [file]\n"
+           "  load [file]\n"
+           "  quit\n";
+}
@@ -0,0 +1,66 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+#include <string>
+using namespace std;
+
+//Text command language, so a session can be driven from a script file,
+//a pipe or another program instead of the numbered menus. One command
+//per line; words are separated by spaces, verbs and keywords are not
+//case sensitive, and anything after '#' is a comment:
+//  look                      describe the current area
+//  move n|e|s|w              walk through an exit (also: go, or just n/e/s/w)
+//  gather raw|natural|food|hunt
+//  craft <item> [count]      item names are matched ignoring case
+//  inventory                 (also: inv, i)
+//  travel <area>             walk the shortest route to an area number
+//  plan <item>               raw materials for an item
+//  craftable                 items that can be crafted right now
+//  name <hero name>          rename the hero
+//  save [file]               save the hero (default: the --save file)
+//  load [file]               restore a saved hero
+//  help
+//  quit                      (also: exit)
+
+//What a command does
+enum CommandVerb {
+  CMD_NONE,      //Blank line or comment
+  CMD_LOOK,
+  CMD_MOVE,
+  CMD_GATHER,
+  CMD_CRAFT,
+  CMD_INVENTORY,
+  CMD_TRAVEL,
+  CMD_PLAN,
+  CMD_CRAFTABLE,
+  CMD_NAME,
+  CMD_SAVE,
+  CMD_LOAD,
+  CMD_HELP,
+  CMD_QUIT
+};
+
+//One parsed line
+struct Command {
+  CommandVerb m_verb;
+  string m_text; //Item or hero name (CMD_CRAFT, CMD_PLAN, CMD_NAME) or
+                //snapshot file (CMD_SAVE, CMD_LOAD; empty = default)
+  int m_number; //Exit index (CMD_MOVE), GatherKind (CMD_GATHER),
+                //count (CMD_CRAFT) or area (CMD_TRAVEL)
+};
+
+// Name: ParseCommand(const string& line, Command& command, string& error)
+// Description: Parses one line of the command language. A trailing
+//              number after a craft item is the batch size.
+// Preconditions: None.
+// Postconditions: Returns true and fills command (CMD_NONE for a blank
+//                 line or comment); otherwise returns false and error
+//                 says what is wrong. Names are not checked here.
+bool ParseCommand(const string& line, Command& command, string& error);
+
+// Name: GetCommandHelp()
+// Description: One line per command, for the help command.
+// Preconditions: None.
+// Postconditions: Returns the summary.
+const char* GetCommandHelp();
+
+#endif
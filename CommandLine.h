@@ -0,0 +1,27 @@
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+#include <cctype>
+#include <charconv>
+#include <cstring>
+using namespace std;
+
+//Option parsing shared by the programs' main functions. Numbers are
+//parsed with from_chars, so a bad value is reported instead of throwing
+//out of main.
+
+// Name: ParseNumber(const char* word, T& number)
+// Description: Parses word as a whole non-negative decimal number (or a
+//              non-negative decimal fraction when T is floating point).
+// Preconditions: word is a C string.
+// Postconditions: Returns false if word is anything else or out of range.
+template <typename T>
+bool ParseNumber(const char* word, T& number) {
+  if (!isdigit(static_cast<unsigned char>(word[0]))) {
+    return false;
+  }
+  const char *end = word + strlen(word);
+  from_chars_result result = from_chars(word, end, number);
+  return result.ec == errc() && result.ptr == end;
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include "CraftIndex.h"
+#include <algorithm>
+
+  // Name: CraftIndex(const vector<Item*>& items, int itemCount)
+  // Description: Builds the ingredient -> recipe index for items.
+  // Preconditions: Ids in items are < itemCount.
+  // Postconditions: The counters describe an empty inventory.
+CraftIndex::CraftIndex(const vector<Item*>& items, int itemCount)
+    : m_useStart(itemCount + 1, 0), m_needed(items.size(), 0), m_held(items.size(), 0),
+      m_slot(items.size(), -1) {
+    for (unsigned long r = 0; r < items.size(); r++) {
+        const vector<ItemNeed>& needs = items[r]->GetNeeds();
+        m_needed[r] = static_cast<int>(needs.size());
+        for (unsigned long i = 0; i < needs.size(); i++) {
+            m_useStart[needs[i].m_item + 1]++;
+        }
+    }
+    //Prefix sum, then fill each ingredient's slice
+    for (int item = 0; item < itemCount; item++) {
+        m_useStart[item + 1] += m_useStart[item];
+    }
+    m_uses.resize(m_useStart[itemCount]);
+    vector<int> fill(m_useStart.begin(), m_useStart.end() - 1);
+    for (unsigned long r = 0; r < items.size(); r++) {
+        const vector<ItemNeed>& needs = items[r]->GetNeeds();
+        for (unsigned long i = 0; i < needs.size(); i++) {
+            m_uses[fill[needs[i].m_item]++] = CraftUse{needs[i].m_count, static_cast<int>(r)};
+        }
+    }
+    //Sort each slice by need so an update scans only the crossed range
+    for (int item = 0; item < itemCount; item++) {
+        sort(m_uses.begin() + m_useStart[item], m_uses.begin() + m_useStart[item + 1],
+             [](const CraftUse& a, const CraftUse& b) { return a.m_count < b.m_count; });
+    }
+    Clear();
+}
+  // Name: Clear()
+  // Description: Resets the counters to an empty inventory.
+  // Preconditions: None.
+  // Postconditions: Only recipes without ingredients are craftable.
+void CraftIndex::Clear() {
+    fill(m_held.begin(), m_held.end(), 0);
+    fill(m_slot.begin(), m_slot.end(), -1);
+    m_craftable.clear();
+    for (int r = 0; r < GetRecipeCount(); r++) {
+        if (m_needed[r] == 0) {
+            SetCraftable(r, true);
+        }
+    }
+}
+  // Name: Update(ItemId item, int before, int after)
+  // Description: Applies one inventory change of item.
+  // Preconditions: before and after are the hero's counts for item.
+  // Postconditions: Recipes needing between before and after of item
+  //                 are updated; no other recipe is touched.
+void CraftIndex::Update(ItemId item, int before, int after) {
+    //Items past the index are not used by any recipe
+    if (before == after || item < 0 || item + 1 >= static_cast<ItemId>(m_useStart.size())) {
+        return;
+    }
+    //Needs in (low, high] are met on one side of the change only
+    int low = max(min(before, after), 0);
+    int high = max(before, after);
+    int delta = after > before ? 1 : -1;
+    vector<CraftUse>::const_iterator use = lower_bound(
+        m_uses.begin() + m_useStart[item], m_uses.begin() + m_useStart[item + 1], low + 1,
+        [](const CraftUse& a, int count) { return a.m_count < count; });
+    vector<CraftUse>::const_iterator end = m_uses.begin() + m_useStart[item + 1];
+    for (; use != end && use->m_count <= high; ++use) {
+        m_held[use->m_recipe] += delta;
+        SetCraftable(use->m_recipe, m_held[use->m_recipe] == m_needed[use->m_recipe]);
+    }
+}
+  // Name: IsCraftable(int recipe) const
+  // Description: Checks whether every ingredient of a recipe is held.
+  // Preconditions: 0 <= recipe < GetRecipeCount().
+  // Postconditions: Returns the cached answer.
+bool CraftIndex::IsCraftable(int recipe) const {
+    return m_slot[recipe] >= 0;
+}
+  // Name: GetCraftable() const
+  // Description: The recipes craftable right now (unordered).
+  // Preconditions: None.
+  // Postconditions: Returns the set as a list of recipe numbers.
+const vector<int>& CraftIndex::GetCraftable() const {
+    return m_craftable;
+}
+  // Name: GetRecipeCount() const
+  // Description: Reports how many recipes are indexed.
+  // Preconditions: None.
+  // Postconditions: Returns the recipe count.
+int CraftIndex::GetRecipeCount() const {
+    return static_cast<int>(m_needed.size());
+}
+  // Name: SetCraftable(int recipe, bool craftable)
+  // Description: Adds recipe to or removes it from m_craftable.
+  // Preconditions: 0 <= recipe < GetRecipeCount().
+  // Postconditions: m_craftable and m_slot agree.
+void CraftIndex::SetCraftable(int recipe, bool craftable) {
+    if (craftable && m_slot[recipe] < 0) {
+        m_slot[recipe] = static_cast<int>(m_craftable.size());
+        m_craftable.push_back(recipe);
+    } else if (!craftable && m_slot[recipe] >= 0) {
+        //Swap the last entry into the hole
+        int last = m_craftable.back();
+        m_craftable[m_slot[recipe]] = last;
+        m_slot[last] = m_slot[recipe];
+        m_craftable.pop_back();
+        m_slot[recipe] = -1;
+    }
+}
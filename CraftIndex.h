@@ -0,0 +1,69 @@
+#ifndef CRAFTINDEX_H
+#define CRAFTINDEX_H
+#include <vector>
+#include "Item.h"
+using namespace std;
+
+//Incremental "craftable now" set for one hero. An inverted index maps
+//each ingredient to the recipes that use it, sorted by how many each
+//recipe needs, and every recipe counts how many of its needs the hero
+//meets (the same test as Hero::CanCraft for one craft). An inventory
+//change only touches the recipes whose need lies between the old and new
+//count, so the craftable set is always current without re-checking every
+//recipe. Recipes are numbered by their position in the item list (the
+//Craft Item menu order).
+
+//One recipe using an ingredient
+struct CraftUse {
+  int m_count;  //How many of the ingredient the recipe needs
+  int m_recipe; //Recipe number
+};
+
+class CraftIndex {
+public:
+  // Name: CraftIndex(const vector<Item*>& items, int itemCount)
+  // Description: Builds the ingredient -> recipe index for items.
+  // Preconditions: Ids in items are < itemCount.
+  // Postconditions: The counters describe an empty inventory.
+  CraftIndex(const vector<Item*>& items, int itemCount);
+  // Name: Clear()
+  // Description: Resets the counters to an empty inventory.
+  // Preconditions: None.
+  // Postconditions: Only recipes without ingredients are craftable.
+  void Clear();
+  // Name: Update(ItemId item, int before, int after)
+  // Description: Applies one inventory change of item.
+  // Preconditions: before and after are the hero's counts for item.
+  // Postconditions: Recipes needing between before and after of item
+  //                 are updated; no other recipe is touched.
+  void Update(ItemId item, int before, int after);
+  // Name: IsCraftable(int recipe) const
+  // Description: Checks whether every ingredient of a recipe is held.
+  // Preconditions: 0 <= recipe < GetRecipeCount().
+  // Postconditions: Returns the cached answer.
+  bool IsCraftable(int recipe) const;
+  // Name: GetCraftable() const
+  // Description: The recipes craftable right now (unordered).
+  // Preconditions: None.
+  // Postconditions: Returns the set as a list of recipe numbers.
+  const vector<int>& GetCraftable() const;
+  // Name: GetRecipeCount() const
+  // Description: Reports how many recipes are indexed.
+  // Preconditions: None.
+  // Postconditions: Returns the recipe count.
+  int GetRecipeCount() const;
+private:
+  // Name: SetCraftable(int recipe, bool craftable)
+  // Description: Adds recipe to or removes it from m_craftable.
+  // Preconditions: 0 <= recipe < GetRecipeCount().
+  // Postconditions: m_craftable and m_slot agree.
+  void SetCraftable(int recipe, bool craftable);
+  vector<int> m_useStart; // CSR offsets into m_uses per ItemId
+  vector<CraftUse> m_uses; // Recipes using each ingredient, by need
+  vector<int> m_needed; // Distinct ingredients per recipe
+  vector<int> m_held; // Needs currently met per recipe
+  vector<int> m_craftable; // Recipes with every ingredient held
+  vector<int> m_slot; // Position in m_craftable (-1 = not craftable)
+};
+
+#endif
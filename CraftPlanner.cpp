@@ -0,0 +1,259 @@
+#include "CraftPlanner.h"
+#include <algorithm>
+
+// Name: AddBill(Bill& total, const Bill& part)
+// Description: Adds part into total (both sorted by ItemId).
+// Preconditions: None.
+// Postconditions: total is the saturated sum, still sorted.
+static void AddBill(Bill& total, const Bill& part) {
+    //First ingredient: a plain copy
+    if (total.empty()) {
+        total = part;
+        return;
+    }
+    Bill sum;
+    sum.reserve(total.size() + part.size());
+    unsigned long i = 0;
+    unsigned long j = 0;
+    while (i < total.size() || j < part.size()) {
+        if (j == part.size() || (i < total.size() && total[i].m_item < part[j].m_item)) {
+            sum.push_back(total[i++]);
+        } else if (i == total.size() || part[j].m_item < total[i].m_item) {
+            sum.push_back(part[j++]);
+        } else {
+            long long count = total[i].m_count + part[j].m_count;
+            sum.push_back(BillLine{total[i].m_item, count < BILL_LIMIT ? count : BILL_LIMIT});
+            i++;
+            j++;
+        }
+    }
+    total.swap(sum);
+}
+
+  // Name: CraftPlanner(const vector<Item*>& items, int itemCount)
+  // Description: Indexes the recipes and sorts the recipe graph.
+  // Preconditions: Ids in items are < itemCount; items outlive the planner.
+  // Postconditions: GetOrder and GetCycleItems are ready; no bill has
+  //                 been computed yet.
+CraftPlanner::CraftPlanner(const vector<Item*>& items, int itemCount)
+    : m_recipes(itemCount, nullptr), m_position(itemCount, -1), m_blocked(itemCount, 0),
+      m_bills(itemCount), m_done(itemCount, 0), m_computed(0), m_seen(itemCount, 0),
+      m_need(itemCount, 0) {
+    for (unsigned long i = 0; i < items.size(); i++) {
+        //First recipe for a product wins
+        if (m_recipes[items[i]->GetID()] == nullptr) {
+            m_recipes[items[i]->GetID()] = items[i];
+        }
+    }
+    //Kahn: an item is ready once every ingredient entry is ready
+    vector<int> waiting(itemCount, 0);
+    vector<vector<ItemId>> usedBy(itemCount);
+    for (ItemId item = 0; item < itemCount; item++) {
+        if (m_recipes[item] != nullptr) {
+            const vector<ItemId>& reqs = m_recipes[item]->GetReq();
+            waiting[item] = static_cast<int>(reqs.size());
+            for (unsigned long r = 0; r < reqs.size(); r++) {
+                usedBy[reqs[r]].push_back(item);
+            }
+        }
+    }
+    for (ItemId item = 0; item < itemCount; item++) {
+        if (waiting[item] == 0) {
+            m_order.push_back(item);
+        }
+    }
+    for (unsigned long head = 0; head < m_order.size(); head++) {
+        const vector<ItemId>& users = usedBy[m_order[head]];
+        for (unsigned long u = 0; u < users.size(); u++) {
+            if (--waiting[users[u]] == 0) {
+                m_order.push_back(users[u]);
+            }
+        }
+    }
+    for (unsigned long i = 0; i < m_order.size(); i++) {
+        m_position[m_order[i]] = static_cast<int>(i);
+    }
+    //Whatever never became ready is on or above a cycle
+    for (ItemId item = 0; item < itemCount; item++) {
+        if (waiting[item] > 0) {
+            m_blocked[item] = 1;
+            m_cycleItems.push_back(item);
+        }
+    }
+}
+  // Name: GetRecipe(ItemId item) const
+  // Description: Finds the recipe that makes item.
+  // Preconditions: 0 <= item < itemCount.
+  // Postconditions: Returns the Item, or nullptr for a raw material.
+const Item* CraftPlanner::GetRecipe(ItemId item) const {
+    return m_recipes[item];
+}
+  // Name: GetOrder() const
+  // Description: Every item not on a cycle, ingredients before products.
+  // Preconditions: None.
+  // Postconditions: Returns the topological order.
+const vector<ItemId>& CraftPlanner::GetOrder() const {
+    return m_order;
+}
+  // Name: GetCycleItems() const
+  // Description: Items Kahn's algorithm could not order: those on a
+  //              recipe cycle and those needing one, in ItemId order.
+  // Preconditions: None.
+  // Postconditions: Returns the list (empty for a proper DAG).
+const vector<ItemId>& CraftPlanner::GetCycleItems() const {
+    return m_cycleItems;
+}
+  // Name: GetBill(ItemId item)
+  // Description: Raw materials consumed by crafting item from scratch.
+  // Preconditions: 0 <= item < itemCount.
+  // Postconditions: Returns the memoized bill, or nullptr if item is on
+  //                 (or depends on) a cycle. Counts saturate at
+  //                 BILL_LIMIT.
+const Bill* CraftPlanner::GetBill(ItemId item) {
+    if (m_blocked[item]) {
+        return nullptr;
+    }
+    if (!m_done[item]) {
+        Compute(item);
+    }
+    return &m_bills[item];
+}
+  // Name: GetMissing(ItemId item, const Hero& hero, Bill& missing)
+  // Description: Raw materials the hero still lacks to craft one item.
+  //              Held ingredients are used up before their recipes are
+  //              expanded, crafted ones included; if no crafted item is
+  //              held it is the memoized bill minus the raw materials.
+  // Preconditions: 0 <= item < itemCount.
+  // Postconditions: Returns false if item has no bill; otherwise
+  //                 missing holds the shortfall (empty = ready).
+bool CraftPlanner::GetMissing(ItemId item, const Hero& hero, Bill& missing) {
+    missing.clear();
+    const Bill *bill = GetBill(item);
+    if (bill == nullptr) {
+        return false;
+    }
+    //A held crafted item can stand in for part of a recipe; without one
+    //only raw materials offset the memoized bill
+    const vector<int>& inventory = hero.GetInventory();
+    for (unsigned long i = 0; i < inventory.size() && i < m_recipes.size(); i++) {
+        if (m_recipes[i] != nullptr && inventory[i] > 0) {
+            Expand(item, hero, missing);
+            return true;
+        }
+    }
+    for (unsigned long i = 0; i < bill->size(); i++) {
+        long long need = (*bill)[i].m_count - hero.GetCount((*bill)[i].m_item);
+        if (need > 0) {
+            missing.push_back(BillLine{(*bill)[i].m_item, need});
+        }
+    }
+    return true;
+}
+  // Name: GetComputedCount() const
+  // Description: Reports how many bills have been computed so far.
+  // Preconditions: None.
+  // Postconditions: Returns the memo size.
+int CraftPlanner::GetComputedCount() const {
+    return m_computed;
+}
+  // Name: Expand(ItemId item, const Hero& hero, Bill& missing)
+  // Description: Fills missing by expanding item's recipe over the
+  //              items below it, products before ingredients, using the
+  //              hero's held units of each item first.
+  // Preconditions: item has a bill; missing is empty.
+  // Postconditions: missing is sorted by ItemId; m_need and m_seen are
+  //                 all zero.
+void CraftPlanner::Expand(ItemId item, const Hero& hero, Bill& missing) {
+    //Every item under item, each once
+    m_below.clear();
+    vector<ItemId> stack(1, item);
+    while (!stack.empty()) {
+        const Item *recipe = m_recipes[stack.back()];
+        stack.pop_back();
+        if (recipe == nullptr) {
+            continue;
+        }
+        const vector<ItemId>& reqs = recipe->GetReq();
+        for (unsigned long r = 0; r < reqs.size(); r++) {
+            if (!m_seen[reqs[r]]) {
+                m_seen[reqs[r]] = 1;
+                m_below.push_back(reqs[r]);
+                stack.push_back(reqs[r]);
+            }
+        }
+    }
+    //Every user of an item comes before it in this order, so its need is
+    //complete when it is reached
+    sort(m_below.begin(), m_below.end(), [this](ItemId a, ItemId b) {
+        return m_position[a] > m_position[b];
+    });
+    const vector<ItemId>& top = m_recipes[item]->GetReq();
+    for (unsigned long r = 0; r < top.size(); r++) {
+        m_need[top[r]]++;
+    }
+    for (unsigned long i = 0; i < m_below.size(); i++) {
+        ItemId next = m_below[i];
+        long long need = m_need[next] - hero.GetCount(next);
+        m_need[next] = 0;
+        m_seen[next] = 0;
+        if (need <= 0) {
+            continue;
+        }
+        const Item *recipe = m_recipes[next];
+        if (recipe == nullptr) {
+            missing.push_back(BillLine{next, need});
+            continue;
+        }
+        //Craft the rest: each ingredient entry is needed once per unit
+        const vector<ItemId>& reqs = recipe->GetReq();
+        for (unsigned long r = 0; r < reqs.size(); r++) {
+            long long count = m_need[reqs[r]] + need;
+            m_need[reqs[r]] = count < BILL_LIMIT ? count : BILL_LIMIT;
+        }
+    }
+    sort(missing.begin(), missing.end(), [](const BillLine& a, const BillLine& b) {
+        return a.m_item < b.m_item;
+    });
+}
+  // Name: Compute(ItemId item)
+  // Description: Fills the memo for item and every ingredient below it
+  //              (iterative post-order walk).
+  // Preconditions: item is not on or above a cycle.
+  // Postconditions: m_done[item] is set.
+void CraftPlanner::Compute(ItemId item) {
+    vector<ItemId> stack(1, item);
+    while (!stack.empty()) {
+        ItemId top = stack.back();
+        if (m_done[top]) {
+            stack.pop_back();
+            continue;
+        }
+        const Item *recipe = m_recipes[top];
+        bool ready = true;
+        if (recipe != nullptr) {
+            //Ingredients first
+            const vector<ItemId>& reqs = recipe->GetReq();
+            for (unsigned long r = 0; r < reqs.size(); r++) {
+                if (!m_done[reqs[r]]) {
+                    stack.push_back(reqs[r]);
+                    ready = false;
+                }
+            }
+        }
+        if (!ready) {
+            continue;
+        }
+        stack.pop_back();
+        if (recipe == nullptr) {
+            //A raw material bills itself
+            m_bills[top].push_back(BillLine{top, 1});
+        } else {
+            const vector<ItemId>& reqs = recipe->GetReq();
+            for (unsigned long r = 0; r < reqs.size(); r++) {
+                AddBill(m_bills[top], m_bills[reqs[r]]);
+            }
+        }
+        m_done[top] = 1;
+        m_computed++;
+    }
+}
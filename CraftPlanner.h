@@ -0,0 +1,103 @@
+#ifndef CRAFTPLANNER_H
+#define CRAFTPLANNER_H
+#include <vector>
+#include "Item.h"
+#include "Hero.h"
+using namespace std;
+
+const long long BILL_LIMIT = 1LL << 60; //Saturation point for bill counts
+
+//One line of a bill of materials
+struct BillLine {
+  ItemId m_item; //Raw material
+  long long m_count; //How many are needed
+};
+
+//Sparse bill of materials, sorted by ItemId
+typedef vector<BillLine> Bill;
+
+//Planner over the recipe graph (product -> ingredients). Crafting
+//consumes every ingredient, so an item's bill is the sum of its
+//ingredients' bills; items with no recipe are raw materials and bill
+//themselves. The graph is sorted topologically once (Kahn's algorithm);
+//items on a recipe cycle, or needing one that is, have no order and no
+//bill. Bills are computed on first request and memoized per item, so
+//later queries are a lookup. "What do I still need" is that lookup diffed
+//against the hero's inventory, unless the hero holds a crafted item:
+//then the recipe is expanded top-down in topological order, each item's
+//held units used up before its own recipe is. Only the first recipe for a
+//product is used.
+class CraftPlanner {
+public:
+  // Name: CraftPlanner(const vector<Item*>& items, int itemCount)
+  // Description: Indexes the recipes and sorts the recipe graph.
+  // Preconditions: Ids in items are < itemCount; items outlive the planner.
+  // Postconditions: GetOrder and GetCycleItems are ready; no bill has
+  //                 been computed yet.
+  CraftPlanner(const vector<Item*>& items, int itemCount);
+  // Name: GetRecipe(ItemId item) const
+  // Description: Finds the recipe that makes item.
+  // Preconditions: 0 <= item < itemCount.
+  // Postconditions: Returns the Item, or nullptr for a raw material.
+  const Item* GetRecipe(ItemId item) const;
+  // Name: GetOrder() const
+  // Description: Every item not on a cycle, ingredients before products.
+  // Preconditions: None.
+  // Postconditions: Returns the topological order.
+  const vector<ItemId>& GetOrder() const;
+  // Name: GetCycleItems() const
+  // Description: Items Kahn's algorithm could not order: those on a
+  //              recipe cycle and those needing one, in ItemId order.
+  // Preconditions: None.
+  // Postconditions: Returns the list (empty for a proper DAG).
+  const vector<ItemId>& GetCycleItems() const;
+  // Name: GetBill(ItemId item)
+  // Description: Raw materials consumed by crafting item from scratch.
+  // Preconditions: 0 <= item < itemCount.
+  // Postconditions: Returns the memoized bill, or nullptr if item is on
+  //                 (or depends on) a cycle. Counts saturate at
+  //                 BILL_LIMIT.
+  const Bill* GetBill(ItemId item);
+  // Name: GetMissing(ItemId item, const Hero& hero, Bill& missing)
+  // Description: Raw materials the hero still lacks to craft one item.
+  //              Held ingredients are used up before their recipes are
+  //              expanded, crafted ones included; if no crafted item is
+  //              held it is the memoized bill minus the raw materials.
+  // Preconditions: 0 <= item < itemCount.
+  // Postconditions: Returns false if item has no bill; otherwise
+  //                 missing holds the shortfall (empty = ready).
+  bool GetMissing(ItemId item, const Hero& hero, Bill& missing);
+  // Name: GetComputedCount() const
+  // Description: Reports how many bills have been computed so far.
+  // Preconditions: None.
+  // Postconditions: Returns the memo size.
+  int GetComputedCount() const;
+private:
+  // Name: Compute(ItemId item)
+  // Description: Fills the memo for item and every ingredient below it
+  //              (iterative post-order walk).
+  // Preconditions: item is not on or above a cycle.
+  // Postconditions: m_done[item] is set.
+  void Compute(ItemId item);
+  // Name: Expand(ItemId item, const Hero& hero, Bill& missing)
+  // Description: Fills missing by expanding item's recipe over the
+  //              items below it, products before ingredients, using the
+  //              hero's held units of each item first.
+  // Preconditions: item has a bill; missing is empty.
+  // Postconditions: missing is sorted by ItemId; m_need and m_seen are
+  //                 all zero.
+  void Expand(ItemId item, const Hero& hero, Bill& missing);
+  vector<const Item*> m_recipes; // Recipe per ItemId (nullptr = raw)
+  vector<ItemId> m_order; // Topological order, ingredients first
+  vector<int> m_position; // Index of each item in m_order
+  vector<ItemId> m_cycleItems; // Items with no topological position
+  vector<char> m_blocked; // On or above a cycle
+  vector<Bill> m_bills; // Memoized bills
+  vector<char> m_done; // Whether m_bills[item] is valid
+  int m_computed; // Bills computed
+  vector<ItemId> m_below; // Items under the current Expand target
+  vector<char> m_seen; // Whether an item is in m_below
+  vector<long long> m_need; // Units still to find per item (Expand)
+};
+
+#endif
@@ -3,13 +3,23 @@
 // Description: Creates a new Game
 // Preconditions: None
 // Postconditions: Initializes all game variables to defaults (constants)
-// including m_myHero (null), mapFile (passed value), craftFile (passed)
-// and starting area (START_AREA)
-Game::Game(string mFile, string cFile) {
-    m_myHero = nullptr;
-    m_areaFile = mFile;
-    m_craftFile = cFile;
-    m_curArea = START_AREA;
+// including m_player's hero (null), mapFile (passed value), craftFile
+// (passed) and starting area (START_AREA). File names are moved in.
+Game::Game(string mFile, string cFile)
+    : m_craftFile(std::move(cFile)), m_areaFile(std::move(mFile)), m_loadMode(LOAD_STREAM),
+      m_areaCache(LAZY_CACHE_SIZE), m_threadCount(0), m_seed(0), m_router(nullptr),
+      m_planner(nullptr), m_reportOnly(false), m_snapshots(nullptr),
+      m_replayOnly(false), m_replayLimit(0), m_fileCommands(true),
+      m_out(&GetConsole()), m_console(cin) {
+    m_player.m_hero = nullptr;
+    m_player.m_craftIndex = nullptr;
+    m_player.m_area = START_AREA;
+    m_player.m_out = m_out;
+    m_player.m_input = &m_console;
+    m_player.m_journal = nullptr;
+    m_player.m_router = nullptr;
+    m_player.m_planner = nullptr;
+    m_player.m_started = false;
 }
   // Name: ~Game
   // Description: Destructor
@@ -17,17 +27,27 @@ Game::Game(string mFile, string cFile) {
   // Postconditions: Deallocates anything dynamically allocated
   //                 in Game
 Game::~Game() {
+    //Deliver anything still buffered
+    m_out->Flush();
     //Delete hero
-    delete m_myHero;
+    delete m_player.m_hero;
     //Set hero pointer to null
-    m_myHero = nullptr;
-
-    for (unsigned long i = 0; i < m_areas.size(); i++) {
-        //Delete all dynamically allocated areas
-        delete m_areas[i];
-    }
-    //Clear areas vector
-    m_areas.clear();
+    m_player.m_hero = nullptr;
+    //Delete the route engine
+    delete m_router;
+    m_router = nullptr;
+    //Delete the crafting planner
+    delete m_planner;
+    m_planner = nullptr;
+    //Delete the craftable-now index (the hero is already gone)
+    delete m_player.m_craftIndex;
+    m_player.m_craftIndex = nullptr;
+    //Delete the snapshot encoder
+    delete m_snapshots;
+    m_snapshots = nullptr;
+    //Close the journal (writing anything it still holds)
+    delete m_player.m_journal;
+    m_player.m_journal = nullptr;
 
     for (unsigned long i = 0; i < m_items.size(); i++) {
         //delete all dynamically allocated items
@@ -37,30 +57,53 @@ Game::~Game() {
     m_items.clear();
 }
   // Name: LoadMap()
-  // Description: Reads area data from the map file and dynamically
-  //             creates Area objects. Inserts each new Area into
-  //             m_myMap in the order encountered.
+  // Description: Reads area data from the map file and adds each area
+  //             to m_world (text is copied into the world's arena) in
+  //             the order encountered.
   // Preconditions: m_mapFile is set to a valid filename;
   //             the file exists and is formatted correctly.
-  // Postconditions: m_myMap contains all loaded Area pointers;
+  // Postconditions: m_world contains all loaded areas;
   //             file stream is closed.
 void Game::LoadMap() {
     ifstream inputstream;
     //Open area file
     inputstream.open(m_areaFile);
-    //Dedicate space to hold information
-    string areaID, name, desc, northID, eastID, southID, westID;
-    //Loop line-by-line using delimiter (|) to extract information
-    while (getline(inputstream, areaID, DELIMITER) && getline(inputstream, name, DELIMITER) 
-            && getline(inputstream, desc, DELIMITER) && getline(inputstream, northID, DELIMITER)
-            && getline(inputstream, eastID, DELIMITER) && getline(inputstream, southID, DELIMITER) 
-            && getline(inputstream, westID, DELIMITER)) {
-                //Create a new Area object dynamically and push it to the back of the areas vector
-                Area *newArea = new Area(stoi(areaID), name, desc, stoi(northID), stoi(eastID), stoi(southID), stoi(westID));
-                m_areas.push_back(newArea);
+    //Read record-by-record until the file runs out
+    string name, desc;
+    AreaRecord record;
+    while (ReadArea(inputstream, name, desc, record)) {
+        //Append each new area to the world
+        m_world.AddArea(record.m_id, record.m_name, record.m_desc, record.m_exits);
     }
+    m_world.BuildAdjacency();
     //Close area file
     inputstream.close();
+}
+  // Name: ReadArea(istream& input, string& name, string& desc, AreaRecord& record)
+  // Description: Reads one '|' delimited area record (seven fields)
+  //              from input. The text is read into name and desc.
+  // Preconditions: input is positioned at the start of a record.
+  // Postconditions: Returns true and fills record (its views refer to
+  //              name and desc), or false if no complete record could
+  //              be read.
+bool Game::ReadArea(istream& input, string& name, string& desc, AreaRecord& record) {
+    //Dedicate space to hold information
+    string areaID, northID, eastID, southID, westID;
+    //Extract the seven fields using the delimiter (|)
+    if (getline(input, areaID, DELIMITER) && getline(input, name, DELIMITER)
+            && getline(input, desc, DELIMITER) && getline(input, northID, DELIMITER)
+            && getline(input, eastID, DELIMITER) && getline(input, southID, DELIMITER)
+            && getline(input, westID, DELIMITER)) {
+        record.m_id = stoi(areaID);
+        record.m_name = name;
+        record.m_desc = desc;
+        record.m_exits[0] = stoi(northID);
+        record.m_exits[1] = stoi(eastID);
+        record.m_exits[2] = stoi(southID);
+        record.m_exits[3] = stoi(westID);
+        return true;
+    }
+    return false;
 }
   // Name: LoadCraft()
   // Description: Reads crafting definitions from the craft file and
@@ -69,7 +112,8 @@ void Game::LoadMap() {
   // Preconditions: m_craftFile is set to a valid filename;
   //              the file exists and uses DELIMITER.
   // Postconditions: m_items contains new Item pointers for
-  //              every recipe; file stream is closed.
+  //              every recipe; every product and ingredient name is
+  //              interned in m_registry; file stream is closed.
 void Game::LoadCraft() {
     ifstream inputstream;
     //Open craft file
@@ -81,38 +125,458 @@ void Game::LoadCraft() {
     while(getline(inputstream, finishedProd, DELIMITER) && getline(inputstream, req1, DELIMITER)
        && getline(inputstream, req2, DELIMITER) && getline(inputstream, req3, DELIMITER)) {
         if (getline(inputstream, req4, DELIMITER) && getline(inputstream, endSpace, '\n')) {}
-        //Create vector to hold all requirements
-        vector<string> reqs = {req1, req2, req3, req4};
+        //Intern each real requirement ("None" marks an empty slot)
+        const string* fields[4] = {&req1, &req2, &req3, &req4};
+        vector<ItemId> reqs;
+        reqs.reserve(4);
+        for (int i = 0; i < 4; i++) {
+            if (*fields[i] != "None") {
+                reqs.push_back(m_registry.Intern(*fields[i]));
+            }
+        }
+        ItemId id = m_registry.Intern(finishedProd);
         //Create a new Item dynamically
-        Item *newItem = new Item(finishedProd, reqs);
+        Item *newItem = new Item(std::move(finishedProd), id, std::move(reqs));
         //Add item to items vector
         m_items.push_back(newItem);
        }
        //Close file
        inputstream.close();
 }
-  // Name: HeroCreation()
+  // Name: LoadMapMapped()
+  // Description: Same result as LoadMap, but maps the file into memory
+  //              and parses it in place: area names and descriptions
+  //              are views into the mapping and numbers are parsed with
+  //              from_chars, so no field is heap allocated.
+  // Preconditions: m_areaFile is set to a valid filename;
+  //             the file exists and is formatted correctly.
+  // Postconditions: m_world contains all loaded areas as views;
+  //             m_mapText keeps the file mapped for the game's lifetime.
+void Game::LoadMapMapped() {
+    //Map the whole file; the areas keep views into it
+    if (!m_mapText.Open(m_areaFile)) {
+        return;
+    }
+    string_view text = m_mapText.View();
+    size_t pos = 0;
+    AreaRecord record;
+    //Parse record-by-record straight out of the mapping
+    while (ParseAreaRecord(text, pos, record)) {
+        m_world.AddAreaView(record.m_id, record.m_name, record.m_desc, record.m_exits);
+    }
+    m_world.BuildAdjacency();
+}
+  // Name: LoadCraftMapped()
+  // Description: Same result as LoadCraft, but parses a memory mapping
+  //              of the craft file in place.
+  // Preconditions: m_craftFile is set to a valid filename.
+  // Postconditions: m_items and m_registry are filled as by LoadCraft;
+  //              the mapping is released once parsing ends.
+void Game::LoadCraftMapped() {
+    MappedFile craftText;
+    if (!craftText.Open(m_craftFile)) {
+        return;
+    }
+    string_view text = craftText.View();
+    size_t pos = 0;
+    CraftRecord record;
+    //One scratch string for registry lookups, reused for every name
+    string name;
+    while (ParseCraftRecord(text, pos, record)) {
+        vector<ItemId> reqs;
+        reqs.reserve(record.m_reqs.size());
+        for (unsigned long i = 0; i < record.m_reqs.size(); i++) {
+            name.assign(record.m_reqs[i]);
+            reqs.push_back(m_registry.Intern(name));
+        }
+        name.assign(record.m_product);
+        ItemId id = m_registry.Intern(name);
+        //Items own their names (the mapping is released below)
+        Item *newItem = new Item(string(record.m_product), id, std::move(reqs));
+        m_items.push_back(newItem);
+    }
+}
+  // Name: LoadMapIndex()
+  // Description: Lazy alternative to LoadMap. Scans the map file once
+  //              and keeps only ids and exits (in m_world, with empty
+  //              text) plus a file offset per area; names and
+  //              descriptions are read from the file on first visit and
+  //              kept in a bounded LRU cache (see GetArea).
+  // Preconditions: m_areaFile is set to a valid filename;
+  //             the file exists and is formatted correctly.
+  // Postconditions: m_areaOffsets holds one offset per area; the map
+  //             file stays open for on-demand reads.
+void Game::LoadMapIndex() {
+    //Scan through a temporary mapping; it is released when we return,
+    //so none of the text stays resident
+    MappedFile scan;
+    if (!scan.Open(m_areaFile)) {
+        return;
+    }
+    string_view text = scan.View();
+    size_t pos = 0;
+    size_t start = 0;
+    AreaRecord record;
+    while (ParseAreaRecord(text, pos, record)) {
+        m_areaOffsets.push_back(static_cast<long long>(start));
+        m_world.AddAreaView(record.m_id, string_view(), string_view(), record.m_exits);
+        start = pos;
+    }
+    m_areaOffsets.shrink_to_fit();
+    m_world.BuildAdjacency();
+    m_lazyStream.open(m_areaFile);
+}
+  // Name: LoadMapParallel(int threadCount)
+  // Description: Same result as LoadMapMapped, but splits the mapping
+  //              into chunks on record boundaries and parses the chunks
+  //              on a thread pool. Boundaries are found by counting
+  //              delimiters per chunk in parallel: a record starts after
+  //              every AREA_FIELDS-th '|', wherever newlines fall.
+  // Preconditions: m_areaFile is set to a valid filename;
+  //             the file exists and is formatted correctly.
+  // Postconditions: m_world holds the areas in file order (the same
+  //             order as LoadMap); m_mapText keeps the file mapped.
+  //             Throws invalid_argument on a malformed number.
+void Game::LoadMapParallel(int threadCount) {
+    if (!m_mapText.Open(m_areaFile)) {
+        return;
+    }
+    string_view text = m_mapText.View();
+    ThreadPool pool(threadCount);
+    //Split into byte ranges; small files become a single chunk
+    size_t chunkCount = static_cast<size_t>(pool.GetThreadCount()) * CHUNKS_PER_THREAD;
+    if (text.size() / MIN_CHUNK_BYTES < chunkCount) {
+        chunkCount = text.size() / MIN_CHUNK_BYTES;
+    }
+    if (chunkCount < 1) {
+        chunkCount = 1;
+    }
+    vector<size_t> bounds(chunkCount + 1);
+    for (size_t i = 0; i <= chunkCount; i++) {
+        bounds[i] = text.size() / chunkCount * i;
+    }
+    bounds[chunkCount] = text.size();
+    //Pass 1: delimiters per chunk, then a prefix sum gives the number of
+    //delimiters before each chunk
+    vector<size_t> before(chunkCount + 1, 0);
+    pool.ParallelFor(static_cast<int>(chunkCount), [&](int c) {
+        before[c + 1] = CountDelimiters(text.substr(bounds[c], bounds[c + 1] - bounds[c]), DELIMITER);
+    });
+    for (size_t i = 1; i <= chunkCount; i++) {
+        before[i] += before[i - 1];
+    }
+    //Pass 2: each chunk parses the records that start inside it (the
+    //last one may run past the chunk's end)
+    vector<vector<AreaRecord>> parsed(chunkCount);
+    auto parseChunk = [&](int c) {
+        size_t pos = bounds[c];
+        size_t partial = before[c] % AREA_FIELDS;
+        bool atStart = partial == 0 && (pos == 0 || text[pos - 1] == DELIMITER);
+        if (!atStart) {
+            //Skip the rest of the record that straddles the boundary
+            size_t skip = partial == 0 ? AREA_FIELDS : AREA_FIELDS - partial;
+            pos = SkipDelimiters(text, pos, DELIMITER, skip);
+        }
+        AreaRecord record;
+        while (pos < bounds[c + 1] && ParseAreaRecord(text, pos, record)) {
+            parsed[c].push_back(record);
+        }
+    };
+    pool.ParallelFor(static_cast<int>(chunkCount), parseChunk);
+    //Merge in chunk (file) order
+    size_t total = 0;
+    for (size_t i = 0; i < chunkCount; i++) {
+        total += parsed[i].size();
+    }
+    m_world.Reserve(m_world.GetSize() + static_cast<int>(total));
+    for (size_t i = 0; i < chunkCount; i++) {
+        for (unsigned long j = 0; j < parsed[i].size(); j++) {
+            const AreaRecord& record = parsed[i][j];
+            m_world.AddAreaView(record.m_id, record.m_name, record.m_desc, record.m_exits);
+        }
+    }
+    m_world.BuildAdjacency();
+}
+  // Name: LoadPack()
+  // Description: Opens m_areaFile as a world pack. Item names are
+  //              interned in pack order so ItemIds match the pack, and
+  //              Items are built from its pre-resolved recipes; areas
+  //              are views into the mapping, made on first visit.
+  // Preconditions: m_areaFile names a pack written by CompilePack.
+  // Postconditions: m_pack is open and m_items and m_registry are
+  //              filled; returns false if the pack is missing or invalid
+  //              (including an item id or ingredient run out of range).
+bool Game::LoadPack() {
+    if (!m_pack.Open(m_areaFile)) {
+        return false;
+    }
+    //Names are stored in ItemId order, so interning them in order
+    //reproduces the compiler's ids
+    string name;
+    for (int id = 0; id < m_pack.GetItemCount(); id++) {
+        name.assign(m_pack.GetItemName(id));
+        m_registry.Intern(name);
+    }
+    //Recipes already hold ItemIds; no name lookups needed, but a corrupt
+    //pack must not send an id or an ingredient run out of range
+    int itemCount = m_pack.GetItemCount();
+    for (int i = 0; i < m_pack.GetRecipeCount(); i++) {
+        const PackRecipe& recipe = m_pack.GetRecipe(i);
+        if (recipe.m_item < 0 || recipe.m_item >= itemCount
+                || uint64_t(recipe.m_firstReq) + recipe.m_reqCount > uint64_t(m_pack.GetReqCount())) {
+            return false;
+        }
+        const int32_t *reqs = m_pack.GetReqs(recipe);
+        for (uint32_t r = 0; r < recipe.m_reqCount; r++) {
+            if (reqs[r] < 0 || reqs[r] >= itemCount) {
+                return false;
+            }
+        }
+        vector<ItemId> reqIds(reqs, reqs + recipe.m_reqCount);
+        Item *newItem = new Item(m_registry.GetName(recipe.m_item), recipe.m_item,
+                                 std::move(reqIds));
+        m_items.push_back(newItem);
+    }
+    return true;
+}
+  // Name: GetArea(int index)
+  // Description: Returns the area at index, materializing it from the
+  //              map file in LOAD_LAZY mode or from the pack in
+  //              LOAD_PACK mode.
+  // Preconditions: Map has been loaded; 0 <= index < GetAreaCount().
+  // Postconditions: Returns a view of the area. In LOAD_LAZY mode its
+  //              text is only valid until the next GetArea call.
+Area Game::GetArea(int index) {
+    if (m_loadMode == LOAD_PACK) {
+        //View straight into the pack; nothing is copied
+        const int32_t *exits = m_pack.GetExits(index);
+        return Area(m_pack.GetAreaId(index), m_pack.GetAreaName(index),
+                    m_pack.GetAreaDesc(index), exits[0], exits[1], exits[2], exits[3]);
+    }
+    if (m_loadMode != LOAD_LAZY) {
+        return m_world.GetArea(index);
+    }
+    const AreaText *text = m_areaCache.Get(index);
+    if (text == nullptr) {
+        //First visit (or evicted): read just this record's text
+        AreaText loaded;
+        AreaRecord record;
+        m_lazyStream.clear();
+        m_lazyStream.seekg(m_areaOffsets[index]);
+        ReadArea(m_lazyStream, loaded.m_name, loaded.m_desc, record);
+        text = m_areaCache.Put(index, std::move(loaded));
+    }
+    const int32_t *exits = m_world.GetExits(index);
+    return Area(m_world.GetId(index), text->m_name, text->m_desc,
+                exits[0], exits[1], exits[2], exits[3]);
+}
+  // Name: GetAreaCount() const
+  // Description: Reports how many areas the loaded map has.
+  // Preconditions: Map has been loaded.
+  // Postconditions: Returns the number of areas.
+int Game::GetAreaCount() const {
+    if (m_loadMode == LOAD_PACK) {
+        return m_pack.IsOpen() ? m_pack.GetAreaCount() : 0;
+    }
+    return m_world.GetSize();
+}
+  // Name: GetWorld() const
+  // Description: Structure-of-arrays view of the loaded map, for
+  //              passes over the whole graph.
+  // Preconditions: Map has been loaded and not in LOAD_PACK mode (the
+  //              pack's exit table is used in place); in LOAD_LAZY mode
+  //              it has ids and exits but no text.
+  // Postconditions: Returns m_world.
+const World& Game::GetWorld() const {
+    return m_world;
+}
+  // Name: GetItems() const
+  // Description: The loaded recipes, in craft file order.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: Returns m_items.
+const vector<Item*>& Game::GetItems() const {
+    return m_items;
+}
+  // Name: GetRegistry() const
+  // Description: Item name <-> ItemId table for the loaded recipes.
+  // Preconditions: None.
+  // Postconditions: Returns m_registry.
+const ItemRegistry& Game::GetRegistry() const {
+    return m_registry;
+}
+  // Name: CheckWorld()
+  // Description: Validates the loaded map in parallel (see
+  //              ValidateWorld) and prints the report when the map is
+  //              invalid or m_reportOnly is set.
+  // Preconditions: Map has been loaded from text (packc has already
+  //              validated a pack).
+  // Postconditions: Returns true if the map is safe to play.
+bool Game::CheckWorld() {
+    ThreadPool pool(m_threadCount);
+    ValidationReport report = ValidateWorld(m_world, START_AREA, pool);
+    if (!report.IsValid() || m_reportOnly) {
+        PrintReport(*m_out, report);
+        m_out->Flush();
+    }
+    return report.IsValid();
+}
+  // Name: BuildRouter()
+  // Description: Builds the route engine (and its landmark tables on
+  //              large maps) over m_world; in LOAD_PACK mode it routes
+  //              over the pack's exits with the tables packc stored.
+  // Preconditions: Map has been loaded and checked.
+  // Postconditions: m_router is ready for Travel.
+void Game::BuildRouter() {
+    delete m_router;
+    if (m_loadMode == LOAD_PACK) {
+        //Nothing is built: a pack open stays O(1) however big the map
+        m_router = new Router(m_pack.GetExits(0), m_pack.GetAreaCount(), m_pack.GetLandmarks(),
+                              m_pack.GetLandmarkCount());
+    } else {
+        m_router = new Router(m_world);
+    }
+    m_player.m_router = m_router;
+}
+  // Name: NewRouter() const
+  // Description: Makes another route engine over the same exits that
+  //              borrows m_router's landmark tables, so a thread can
+  //              route without sharing m_router's search scratch.
+  // Preconditions: BuildRouter() has run; m_router outlives the result.
+  // Postconditions: Returns a new Router (the caller deletes it).
+Router* Game::NewRouter() const {
+    const int32_t *exits = m_loadMode == LOAD_PACK ? m_pack.GetExits(0) : m_world.GetExits(0);
+    return new Router(exits, GetAreaCount(), m_router->GetLandmarkTable(),
+                      m_router->GetLandmarkCount());
+}
+  // Name: GetRouter()
+  // Description: Route engine for the loaded map.
+  // Preconditions: BuildRouter() has run.
+  // Postconditions: Returns m_router.
+Router* Game::GetRouter() {
+    return m_router;
+}
+  // Name: BuildPlanner()
+  // Description: Builds the crafting planner over m_items.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: m_planner is ready for PlanItem.
+void Game::BuildPlanner() {
+    delete m_planner;
+    m_planner = new CraftPlanner(m_items, m_registry.GetSize());
+    m_player.m_planner = m_planner;
+}
+  // Name: NewPlanner() const
+  // Description: Makes another crafting planner over m_items, with its
+  //              own bill memo and scratch.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: Returns a new CraftPlanner (the caller deletes it).
+CraftPlanner* Game::NewPlanner() const {
+    return new CraftPlanner(m_items, m_registry.GetSize());
+}
+  // Name: BuildCraftIndex()
+  // Description: Builds the craftable-now index over m_items.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: m_player's craft index is ready to attach to the hero.
+void Game::BuildCraftIndex() {
+    delete m_player.m_craftIndex;
+    m_player.m_craftIndex = new CraftIndex(m_items, m_registry.GetSize());
+}
+  // Name: SetLazyCacheSize(int size)
+  // Description: Sets how many materialized areas LOAD_LAZY keeps.
+  // Preconditions: size >= 1.
+  // Postconditions: The area cache holds at most size areas.
+void Game::SetLazyCacheSize(int size) {
+    m_areaCache.SetCapacity(size);
+}
+  // Name: SetSeed(uint64_t seed)
+  // Description: Sets the seed the hero's random engine starts from.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_seed is set; equal seeds and input replay a session.
+void Game::SetSeed(uint64_t seed) {
+    m_seed = seed;
+}
+  // Name: SetThreadCount(int threadCount)
+  // Description: Sets the worker count for LOAD_PARALLEL.
+  // Preconditions: None (0 uses every hardware thread).
+  // Postconditions: m_threadCount is set.
+void Game::SetThreadCount(int threadCount) {
+    m_threadCount = threadCount;
+}
+  // Name: SetReportOnly(bool reportOnly)
+  // Description: Makes StartGame print the validation report and stop.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_reportOnly is set.
+void Game::SetReportOnly(bool reportOnly) {
+    m_reportOnly = reportOnly;
+}
+  // Name: SetOutput(OutputSink* out)
+  // Description: Chooses where the game and its hero print.
+  // Preconditions: Called before StartGame; out outlives the game.
+  // Postconditions: m_out is set; the default is GetConsole().
+void Game::SetOutput(OutputSink* out) {
+    m_out = out;
+    m_player.m_out = out;
+}
+  // Name: SetScript(const string& scriptFile)
+  // Description: Makes StartGame run the commands in scriptFile ("-"
+  //              for standard input) instead of the menus.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_scriptFile is set.
+void Game::SetScript(const string& scriptFile) {
+    m_scriptFile = scriptFile;
+}
+  // Name: SetSaveFile(const string& saveFile)
+  // Description: Makes StartGame resume the hero saved in saveFile (if
+  //              it exists) and checkpoint it after every command.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_saveFile is set.
+void Game::SetSaveFile(const string& saveFile) {
+    m_saveFile = saveFile;
+}
+  // Name: SetJournalFile(const string& journalFile)
+  // Description: Makes StartGame rebuild the session from journalFile
+  //              (if it exists) and append every action to it.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_journalFile is set.
+void Game::SetJournalFile(const string& journalFile) {
+    m_journalFile = journalFile;
+}
+  // Name: SetReplayOnly(long long limit)
+  // Description: Makes StartGame replay the first limit journal
+  //              actions (0 = all), show the result and stop.
+  // Preconditions: Called before StartGame, with a journal file set.
+  // Postconditions: m_replayOnly and m_replayLimit are set.
+void Game::SetReplayOnly(long long limit) {
+    m_replayOnly = true;
+    m_replayLimit = limit;
+}
+  // Name: SetLoadMode(LoadMode mode)
+  // Description: Chooses which loaders StartGame uses.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_loadMode is set.
+void Game::SetLoadMode(LoadMode mode) {
+    m_loadMode = mode;
+}
+  // Name: HeroCreation(GameSession& session)
   // Description: Prompts the player to enter a hero name and
-  //              constructs a new Hero.
-  // Preconditions: Standard input (cin) is available.
-  // Postconditions: m_myHero points to a newly allocated Hero
-  //              with the entered name.
-void Game::HeroCreation() {
+  //              gives it to the hero.
+  // Preconditions: Hero exists; session.m_input is set.
+  // Postconditions: The hero has the entered name.
+SessionTask Game::HeroCreation(GameSession& session) {
     string heroName;
-    cout << "Hero Name: ";
+    *session.m_out << "Hero Name: ";
     //Get hero name from user
-    getline(cin, heroName);
-    //Dynamically allocate new hero with such name
-    m_myHero = new Hero(heroName);
+    session.m_out->Flush();
+    co_await session.m_input->ReadLine(heroName);
+    session.m_hero->SetName(heroName);
 }
-  // Name: Look()
+  // Name: Look(GameSession& session)
   // Description: Displays the current Area’s name, description,
   //              and possible exits.
-  // Preconditions: m_curArea is a valid index into m_myMap.
+  // Preconditions: session.m_area is a valid area index.
   // Postconditions: Current area details are printed to stdout.
-void Game::Look() {
+void Game::Look(GameSession& session) {
     //Print info about current area
-    m_areas[m_curArea]->PrintArea();
+    GetArea(session.m_area).PrintArea(*session.m_out);
 }
   // Name: StartGame()
   // Description: Initializes game flow by loading map and crafting
@@ -122,142 +586,787 @@ void Game::Look() {
   // Postconditions: Game state is initialized and Action() is called.
 void Game::StartGame() {
     //Print welcome message
-    cout << "Welcome to UMBC Runescape!" << endl;
-    //Load passed-in map file
-    LoadMap();
-    //Load passed-in craft file
-    LoadCraft();
-    //Create Hero
-    HeroCreation();
+    *m_out << "Welcome to UMBC Runescape!" << '\n';
+    if (m_loadMode == LOAD_MAPPED) {
+        //Load both files through memory mappings
+        LoadMapMapped();
+        LoadCraftMapped();
+    } else if (m_loadMode == LOAD_LAZY) {
+        //Only index the map; areas are read as the hero reaches them
+        LoadMapIndex();
+        LoadCraftMapped();
+    } else if (m_loadMode == LOAD_PARALLEL) {
+        //Parse the map on a thread pool; the craft file is small
+        LoadMapParallel(m_threadCount);
+        LoadCraftMapped();
+    } else if (m_loadMode == LOAD_PACK) {
+        //Map and craft data both come from the pack
+        if (!LoadPack()) {
+            *m_out << "Could not open world pack " << m_areaFile << '\n';
+            return;
+        }
+    } else {
+        //Load passed-in map file
+        LoadMap();
+        //Load passed-in craft file
+        LoadCraft();
+    }
+    //Reject broken maps before anyone walks into them (packc refuses to
+    //pack one, so a pack is not checked again)
+    if (m_loadMode != LOAD_PACK && !CheckWorld()) {
+        *m_out << "This map cannot be played." << '\n';
+        return;
+    }
+    if (m_reportOnly) {
+        return;
+    }
+    //Precompute routing tables for Travel
+    BuildRouter();
+    //Sort the recipe graph for Plan Item
+    BuildPlanner();
+    BuildCraftIndex();
+    //A saved or journaled hero is resumed instead of asking for a new one
+    bool resume = (!m_saveFile.empty() && ifstream(m_saveFile).good())
+        || (!m_journalFile.empty() && ifstream(m_journalFile).good());
+    //Create Hero (scripts name it with the name command, not a prompt)
+    m_player.m_hero = new Hero(SCRIPT_HERO, m_registry, m_seed);
+    if (m_scriptFile.empty() && !resume && !m_replayOnly) {
+        //Console reads never suspend, so starting the task runs it through
+        SessionTask naming = HeroCreation(m_player);
+        naming.Start();
+    }
+    //Keep the craftable set current as the inventory changes
+    m_player.m_hero->SetCraftIndex(m_player.m_craftIndex);
+    m_player.m_hero->SetOutput(m_out);
     //Set current area to 0 at the beginning
-    m_curArea = 0;
+    m_player.m_area = 0;
+    m_snapshots = new SnapshotStore(m_registry);
+    //Refuse to play (and overwrite the save or journal) if they do not load
+    if (!ResumeSession(m_player)) {
+        return;
+    }
+    if (m_replayOnly) {
+        //Show the rebuilt session and stop
+        Look(m_player);
+        *m_out << "******* INVENTORY *******" << '\n';
+        m_player.m_hero->DisplayInventory();
+        return;
+    }
+    if (resume) {
+        *m_out << "Welcome back, " << m_player.m_hero->GetName() << "!" << '\n';
+    }
     //Present info about the beginning area
-    Look();
-    //Let user choose their action
-    Action();
+    Look(m_player);
+    if (m_scriptFile.empty()) {
+        //Let user choose their action
+        SessionTask menus = Action(m_player);
+        menus.Start();
+    } else if (m_scriptFile == "-") {
+        RunScript(m_player, cin);
+    } else {
+        ifstream script(m_scriptFile);
+        if (!script) {
+            *m_out << "Could not open script " << m_scriptFile << '\n';
+            return;
+        }
+        RunScript(m_player, script);
+    }
 }
-  // Name: Action()
+  // Name: Action(GameSession& session)
   // Description: Presents the player with the main menu
-  //              (Look, Move, Use Area, Craft, Inventory, Quit)
+  //              (Look, Move, Use Area, Craft, Inventory, Quit, Travel,
+  //              Plan, Craftable)
   //              and drives game interactions until the player quits.
   // Preconditions: Hero and map are initialized.
   // Postconditions: Continues looping until user selects Quit.
-void Game::Action() {
+SessionTask Game::Action(GameSession& session) {
     int option = 0;
     while (option < 1 || option > 6 || option != 6) {
         //Present choices
-        cout << "What would you like to do?" << endl;
-        cout << "1. Look" << endl;
-        cout << "2. Move" << endl;
-        cout << "3. Use Area" << endl;
-        cout << "4. Craft Item" << endl;
-        cout << "5. Display Inventory" << endl;
-        cout << "6. Quit" << endl;
+        *session.m_out << "What would you like to do?" << '\n';
+        *session.m_out << "1. Look" << '\n';
+        *session.m_out << "2. Move" << '\n';
+        *session.m_out << "3. Use Area" << '\n';
+        *session.m_out << "4. Craft Item" << '\n';
+        *session.m_out << "5. Display Inventory" << '\n';
+        *session.m_out << "6. Quit" << '\n';
+        *session.m_out << "7. Travel" << '\n';
+        *session.m_out << "8. Plan Item" << '\n';
+        *session.m_out << "9. Craftable Now" << '\n';
         //Capture choice
-        cin >> option;
+        session.m_out->Flush();
+        co_await session.m_input->Read(option);
         //Execute proper function based on choice
         if (option == 1) {
-            Look();
+            Look(session);
         } else if (option == 2) {
-            Move();
+            co_await Move(session);
         } else if (option == 3) {
-            UseArea();
+            co_await UseArea(session);
         } else if (option == 4) {
-            CraftItem();
+            co_await CraftItem(session);
         } else if (option == 5) {
             //Display inventory
-            cout << "******* INVENTORY *******" << endl;
-            m_myHero->DisplayInventory();
+            *session.m_out << "******* INVENTORY *******" << '\n';
+            session.m_hero->DisplayInventory();
         } else if (option == 6) {
             //Final goodbye message
-            cout << "Good bye!" << endl;
+            *session.m_out << "Good bye!" << '\n';
+        } else if (option == 7) {
+            co_await Travel(session);
+        } else if (option == 8) {
+            co_await PlanItem(session);
+        } else if (option == 9) {
+            ShowCraftable(session);
         } else {
             //If choice is out of range
-            cout << "Invalid choice. Try again" << endl;
+            *session.m_out << "Invalid choice. Try again" << '\n';
         }
+        //Keep the save file current after every choice
+        Checkpoint(session);
     }
 }
 
-  // Name: Move()
+  // Name: Move(GameSession& session)
   // Description: Prompts the player for a direction (N/E/S/W),
-  //              validates the move, updates m_curArea, and
+  //              validates the move, updates session.m_area, and
   //              calls Look() to show the new area.
-  // Preconditions: m_curArea is valid; m_myMap contains
-  //              adjacent Area pointers.
-  // Postconditions: m_curArea is updated to the new area index.
-void Game::Move() {
+  // Preconditions: session.m_area is valid; the map has
+  //              been loaded.
+  // Postconditions: session.m_area is updated to the new area index.
+SessionTask Game::Move(GameSession& session) {
     char desiredDirection;
     int newAreaID = 0;
     
     do {
-        cout << "Which direction? (N E S W)" << endl;
+        *session.m_out << "Which direction? (N E S W)" << '\n';
         //Get desired direction
-        cin >> desiredDirection;
+        session.m_out->Flush();
+        co_await session.m_input->Read(desiredDirection);
         //Check if the new direction is valid and continue to ask for direction until it is valid
-        newAreaID = m_areas[m_curArea]->CheckDirection(desiredDirection);
+        newAreaID = GetArea(session.m_area).CheckDirection(desiredDirection);
     } while (newAreaID == -1);
     //Set current area to the new area.
-    m_curArea = newAreaID;
+    EnterArea(session, newAreaID);
     //Present info about the new area
-    Look();
+    Look(session);
+}
+  // Name: Travel(GameSession& session)
+  // Description: Prompts for a destination area, finds a shortest route
+  //              with session.m_router and walks it, printing the directions.
+  // Preconditions: BuildRouter() has run; session.m_area is valid.
+  // Postconditions: session.m_area is the destination if it is reachable.
+SessionTask Game::Travel(GameSession& session) {
+    int destination = 0;
+    *session.m_out << "Travel to which area? (0 - " << GetAreaCount() - 1 << ")" << '\n';
+    session.m_out->Flush();
+    co_await session.m_input->Read(destination);
+    TravelTo(session, destination);
 }
-  // Name: CraftItem()
-  // Description: Displays all craftable items, prompts for a selection,
-  //              and attempts crafting via Hero’s CanCraft/Craft methods.
+  // Name: TravelTo(GameSession& session, int destination)
+  // Description: Finds a shortest route to destination with session.m_router
+  //              and walks it, printing the directions.
+  // Preconditions: BuildRouter() has run; session.m_area is valid.
+  // Postconditions: session.m_area is the destination if it is reachable.
+void Game::TravelTo(GameSession& session, int destination) {
+    const char *directionNames[EXIT_COUNT] = {"North", "East", "South", "West"};
+    if (destination < 0 || destination >= GetAreaCount()) {
+        *session.m_out << "There is no area " << destination << "." << '\n';
+        return;
+    }
+    vector<int> path;
+    if (!session.m_router->FindPath(session.m_area, destination, path)) {
+        *session.m_out << "There is no route to " << GetArea(destination).GetName() << "." << '\n';
+        return;
+    }
+    if (path.size() == 1) {
+        *session.m_out << "You are already there." << '\n';
+        return;
+    }
+    //Print the route with repeated steps folded ("East x3")
+    *session.m_out << "Route (" << path.size() - 1 << " moves): ";
+    int runDirection = -1;
+    int runLength = 0;
+    bool first = true;
+    for (unsigned long i = 0; i + 1 <= path.size(); i++) {
+        int direction = -1;
+        if (i + 1 < path.size()) {
+            const int32_t *exits = m_loadMode == LOAD_PACK ? m_pack.GetExits(path[i])
+                                                           : m_world.GetExits(path[i]);
+            for (int d = 0; d < EXIT_COUNT && direction < 0; d++) {
+                if (exits[d] == path[i + 1]) {
+                    direction = d;
+                }
+            }
+        }
+        if (direction == runDirection) {
+            runLength++;
+            continue;
+        }
+        if (runLength > 0) {
+            *session.m_out << (first ? "" : ", ") << directionNames[runDirection];
+            if (runLength > 1) {
+                *session.m_out << " x" << runLength;
+            }
+            first = false;
+        }
+        runDirection = direction;
+        runLength = 1;
+    }
+    *session.m_out << '\n';
+    //Walk the route and show where the hero ends up
+    EnterArea(session, destination);
+    Look(session);
+}
+  // Name: CraftItem(GameSession& session)
+  // Description: Displays all craftable items, prompts for a selection
+  //              and a batch size (when more than one is affordable),
+  //              and crafts the batch via Hero's Craft method.
   // Preconditions: m_items is populated with Item pointers.
   // Postconditions: If crafting succeeds, inventory is
   //              updated; otherwise prints error.
-void Game::CraftItem() {
+SessionTask Game::CraftItem(GameSession& session) {
     unsigned long craftChoice = 0;
     //Validate craft choice
     while (craftChoice <= 0 || craftChoice > m_items.size()) {
-        cout << "Which item would you like to craft?" << endl;
+        *session.m_out << "Which item would you like to craft?" << '\n';
         //Present a list of craftable items
         for (unsigned long i = 0; i < m_items.size(); i++) {
-            cout << i+1 << ". " << m_items[i]->GetName() << endl;
+            *session.m_out << i+1 << ". " << m_items[i]->GetName() << '\n';
         }
         //Get craft choice
-        cin >> craftChoice;
-    }
-    //Allocate a vector that holds the requirements of that chosen item
-    vector<string> requiredMaterials = m_items[craftChoice-1]->GetReq();
-    //Check if user has all required materials to craft that item
-    bool ableToCraft = m_myHero->CanCraft(requiredMaterials);
-    //If requirements are met...
-    if (ableToCraft) {
-        //Craft item
-        m_myHero->Craft(m_items[craftChoice-1]->GetName(), requiredMaterials);
-    } else {
+        session.m_out->Flush();
+        co_await session.m_input->Read(craftChoice);
+    }
+    const Item *chosen = m_items[craftChoice-1];
+    //Check if user has all required materials (cached by the index)
+    if (!session.m_craftIndex->IsCraftable(static_cast<int>(craftChoice-1))) {
         //Let user know that they are lacking on requirements
-        cout << "Cannot craft " << m_items[craftChoice-1]->GetName() << ". Missing Requirements." << endl;
+        *session.m_out << "Cannot craft " << chosen->GetName() << ". Missing Requirements." << '\n';
+        co_return;
+    }
+    //Offer a batch when the inventory covers more than one
+    int most = session.m_hero->MaxCraftable(*chosen);
+    int count = 1;
+    if (most > 1) {
+        do {
+            *session.m_out << "How many would you like to craft? (1 - " << most << ")" << '\n';
+            session.m_out->Flush();
+            co_await session.m_input->Read(count);
+        } while (count < 1 || count > most);
+    }
+    CraftRecipe(session, static_cast<int>(craftChoice - 1), count);
+}
+  // Name: PlanItem(GameSession& session)
+  // Description: Prompts for a craftable item and prints the raw
+  //              materials it takes from scratch and those still missing.
+  // Preconditions: BuildPlanner() has run; Hero exists.
+  // Postconditions: Nothing changes; the plan is printed.
+SessionTask Game::PlanItem(GameSession& session) {
+    unsigned long planChoice = 0;
+    //Validate plan choice
+    while (planChoice <= 0 || planChoice > m_items.size()) {
+        *session.m_out << "Which item would you like to plan?" << '\n';
+        for (unsigned long i = 0; i < m_items.size(); i++) {
+            *session.m_out << i+1 << ". " << m_items[i]->GetName() << '\n';
+        }
+        session.m_out->Flush();
+        co_await session.m_input->Read(planChoice);
+    }
+    PlanRecipe(session, static_cast<int>(planChoice-1));
+}
+  // Name: PlanRecipe(GameSession& session, int recipe)
+  // Description: Prints the raw materials m_items[recipe] takes from
+  //              scratch and those still missing once the hero's items,
+  //              crafted ones included, are used.
+  // Preconditions: BuildPlanner() has run; Hero exists;
+  //              0 <= recipe < m_items.size().
+  // Postconditions: Nothing changes; the plan is printed.
+void Game::PlanRecipe(GameSession& session, int recipe) {
+    const Item *target = m_items[recipe];
+    Bill missing;
+    //A recipe cycle has no finite bill
+    if (!session.m_planner->GetMissing(target->GetID(), *session.m_hero, missing)) {
+        *session.m_out << target->GetName() << " cannot be planned (its recipes form a cycle)." << '\n';
+        return;
+    }
+    //Full bill from scratch
+    const Bill *bill = session.m_planner->GetBill(target->GetID());
+    *session.m_out << "Raw materials for " << target->GetName() << ":" << '\n';
+    for (unsigned long i = 0; i < bill->size(); i++) {
+        *session.m_out << "  " << (*bill)[i].m_count << " x " << m_registry.GetName((*bill)[i].m_item) << '\n';
+    }
+    //What the inventory does not cover yet
+    if (missing.empty()) {
+        *session.m_out << "You have everything you need." << '\n';
+    } else {
+        *session.m_out << "Still needed:" << '\n';
+        for (unsigned long i = 0; i < missing.size(); i++) {
+            *session.m_out << "  " << missing[i].m_count << " x " << m_registry.GetName(missing[i].m_item) << '\n';
+        }
     }
 }
-  // Name: UseArea()
+  // Name: ShowCraftable(GameSession& session)
+  // Description: Lists only the items the hero can craft right now.
+  // Preconditions: The hero has session.m_craftIndex attached.
+  // Postconditions: Nothing changes; the list is printed in menu order.
+void Game::ShowCraftable(GameSession& session) {
+    //The set is unordered; show it in Craft Item numbering
+    vector<int> ready(session.m_craftIndex->GetCraftable());
+    sort(ready.begin(), ready.end());
+    if (ready.empty()) {
+        *session.m_out << "You cannot craft anything yet." << '\n';
+        return;
+    }
+    *session.m_out << "You can craft:" << '\n';
+    for (unsigned long i = 0; i < ready.size(); i++) {
+        *session.m_out << ready[i] + 1 << ". " << m_items[ready[i]]->GetName() << '\n';
+    }
+}
+  // Name: UseArea(GameSession& session)
   // Description: Prompts the player to choose a search action
   //              (Raw, Natural, Food, Hunt)
   //              and forwards that request to the Hero.
   // Preconditions: Hero exists and has methods Raw/Natural/Food/Hunt.
   // Postconditions: One gather action is performed and the result printed.
-void Game::UseArea() {
+SessionTask Game::UseArea(GameSession& session) {
     int lookOption = 0;
     //Display all choices
     do {
-        cout << "What would you like to look for?" << endl;
-        cout << "1. Raw Materials (Mining)" << endl;
-        cout << "2. Natural Resources (Woodcutting/Foraging)" << endl;
-        cout << "3. Food (Fishing/Farming)" << endl;
-        cout << "4. Hunt" << endl;
+        *session.m_out << "What would you like to look for?" << '\n';
+        *session.m_out << "1. Raw Materials (Mining)" << '\n';
+        *session.m_out << "2. Natural Resources (Woodcutting/Foraging)" << '\n';
+        *session.m_out << "3. Food (Fishing/Farming)" << '\n';
+        *session.m_out << "4. Hunt" << '\n';
         //Get choice
-        cin >> lookOption;
+        session.m_out->Flush();
+        co_await session.m_input->Read(lookOption);
     } while (lookOption <= 0 || lookOption > 4);
-    //Execute proper function based on the choice
-    if (lookOption == 1) {
-        m_myHero->Raw();
-    } else if (lookOption == 2) {
-        m_myHero->Natural();
-    } else if (lookOption == 3) {
-        m_myHero->Food();
+    //Options follow GatherKind order
+    GatherHere(session, static_cast<GatherKind>(lookOption - 1));
+}
+  // Name: SaveHero(GameSession& session, const string& path)
+  // Description: Saves the hero and current area as a snapshot.
+  // Preconditions: Hero exists; the snapshot store is built.
+  // Postconditions: Returns true if path was written; prints the result.
+bool Game::SaveHero(GameSession& session, const string& path) {
+    string error;
+    JournalMark mark = {0, 0};
+    //The journal must hold everything the snapshot says it includes
+    if (session.m_journal != nullptr) {
+        if (!session.m_journal->Flush(error)) {
+            *session.m_out << "Could not save: " << error << '\n';
+            return false;
+        }
+        mark = session.m_journal->GetMark();
+    }
+    if (!m_snapshots->Save(path, *session.m_hero, session.m_area, mark, error)) {
+        *session.m_out << "Could not save: " << error << '\n';
+        return false;
+    }
+    *session.m_out << "Saved " << session.m_hero->GetName() << " to " << path << "." << '\n';
+    return true;
+}
+  // Name: LoadHero(GameSession& session, const string& path)
+  // Description: Restores the hero's name, inventory and area from a
+  //              snapshot saved against the same craft file.
+  // Preconditions: Hero exists; the snapshot store is built.
+  // Postconditions: Returns true if restored; otherwise prints why and
+  //              nothing changes.
+bool Game::LoadHero(GameSession& session, const string& path) {
+    string error;
+    JournalMark mark;
+    if (!m_snapshots->Load(path, GetAreaCount(), *session.m_hero, session.m_area, mark, error)) {
+        *session.m_out << "Could not load " << path << ": " << error << '\n';
+        return false;
+    }
+    //The journal gets the whole loaded state, not a reference to the file
+    if (session.m_journal != nullptr) {
+        string snapshot;
+        m_snapshots->Encode(*session.m_hero, session.m_area, session.m_journal->GetMark(), snapshot);
+        session.m_journal->RecordRestore(snapshot);
+    }
+    return true;
+}
+  // Name: Checkpoint(GameSession& session)
+  // Description: Writes the journal records of the last command, then
+  //              saves the hero to m_saveFile if it has changed since
+  //              the last save (each only if its file is set).
+  // Preconditions: Hero exists; the snapshot store is built.
+  // Postconditions: m_journalFile and m_saveFile hold the current hero.
+void Game::Checkpoint(GameSession& session) {
+    string error;
+    JournalMark mark = {0, 0};
+    if (session.m_journal != nullptr) {
+        //A snapshot must never get ahead of the journal
+        if (!session.m_journal->Flush(error)) {
+            *session.m_out << "Could not write the journal: " << error << '\n';
+            return;
+        }
+        mark = session.m_journal->GetMark();
+    }
+    if (!m_saveFile.empty() && !m_snapshots->Checkpoint(m_saveFile, *session.m_hero, session.m_area, mark, error)) {
+        *session.m_out << "Could not save: " << error << '\n';
+    }
+}
+  // Name: RunScript(GameSession& session, istream& input)
+  // Description: Runs one command per line from input without
+  //              prompting, until quit or the end of input. A line that
+  //              does not parse is reported with its line number and
+  //              skipped.
+  // Preconditions: Hero and map are initialized.
+  // Postconditions: Every command before quit has been executed.
+void Game::RunScript(GameSession& session, istream& input) {
+    string line;
+    string error;
+    Command command;
+    int lineNumber = 0;
+    while (true) {
+        //Flush only when the next read may block, so a program feeding
+        //commands through a pipe sees each reply before it sends more
+        if (input.rdbuf()->in_avail() <= 0) {
+            session.m_out->Flush();
+        }
+        if (!getline(input, line)) {
+            return;
+        }
+        lineNumber++;
+        if (!ParseCommand(line, command, error)) {
+            *session.m_out << "Line " << lineNumber << ": " << error << '\n';
+        } else {
+            bool more = Execute(session, command);
+            //Keep the save file current after every command
+            Checkpoint(session);
+            if (!more) {
+                return;
+            }
+        }
+    }
+}
+  // Name: RunCommand(GameSession& session, const string& line)
+  // Description: Parses and executes one line of the command language.
+  // Preconditions: Hero and map are initialized.
+  // Postconditions: Returns false once the line is quit; a line that
+  //              does not parse is reported and ignored.
+bool Game::RunCommand(GameSession& session, const string& line) {
+    Command command;
+    string error;
+    if (!ParseCommand(line, command, error)) {
+        *session.m_out << error << '\n';
+        return true;
+    }
+    return Execute(session, command);
+}
+  // Name: RunCommand(const string& line)
+  // Description: Runs one line of the command language for the game's
+  //              own player (see StartGame).
+  // Preconditions: Hero and map are initialized.
+  // Postconditions: As RunCommand(m_player, line).
+bool Game::RunCommand(const string& line) {
+    return RunCommand(m_player, line);
+}
+  // Name: Execute(GameSession& session, const Command& command)
+  // Description: Performs a parsed command with the same game actions
+  //              (and messages) as the menus, minus the prompts.
+  // Preconditions: Hero and map are initialized.
+  // Postconditions: Returns false for quit, true otherwise.
+bool Game::Execute(GameSession& session, const Command& command) {
+    const char directionKeys[EXIT_COUNT] = {'N', 'E', 'S', 'W'};
+    if (command.m_verb == CMD_LOOK) {
+        Look(session);
+    } else if (command.m_verb == CMD_MOVE) {
+        int newAreaID = GetArea(session.m_area).CheckDirection(directionKeys[command.m_number]);
+        if (newAreaID == -1) {
+            *session.m_out << "You cannot go that way." << '\n';
+        } else {
+            EnterArea(session, newAreaID);
+            Look(session);
+        }
+    } else if (command.m_verb == CMD_GATHER) {
+        GatherHere(session, static_cast<GatherKind>(command.m_number));
+    } else if (command.m_verb == CMD_CRAFT || command.m_verb == CMD_PLAN) {
+        int recipe = FindRecipe(command.m_text);
+        if (recipe < 0) {
+            *session.m_out << "There is no recipe for " << command.m_text << "." << '\n';
+        } else if (command.m_verb == CMD_PLAN) {
+            PlanRecipe(session, recipe);
+        } else if (command.m_number > MAX_CRAFT_BATCH) {
+            *session.m_out << "Cannot craft " << command.m_number << " " << m_items[recipe]->GetName()
+                   << ". A batch is at most " << MAX_CRAFT_BATCH << "." << '\n';
+        } else if (!session.m_craftIndex->IsCraftable(recipe)) {
+            *session.m_out << "Cannot craft " << m_items[recipe]->GetName() << ". Missing Requirements." << '\n';
+        } else {
+            //The ingredients are there; say how many they cover, as the
+            //menu's batch prompt does
+            int most = session.m_hero->MaxCraftable(*m_items[recipe]);
+            if (command.m_number > most) {
+                *session.m_out << "Cannot craft " << command.m_number << " " << m_items[recipe]->GetName()
+                       << ". You can craft at most " << most << "." << '\n';
+            } else {
+                CraftRecipe(session, recipe, command.m_number);
+            }
+        }
+    } else if (command.m_verb == CMD_INVENTORY) {
+        *session.m_out << "******* INVENTORY *******" << '\n';
+        session.m_hero->DisplayInventory();
+    } else if (command.m_verb == CMD_TRAVEL) {
+        TravelTo(session, command.m_number);
+    } else if (command.m_verb == CMD_CRAFTABLE) {
+        ShowCraftable(session);
+    } else if (command.m_verb == CMD_NAME) {
+        session.m_hero->SetName(command.m_text);
+        if (session.m_journal != nullptr) {
+            session.m_journal->RecordName(command.m_text);
+        }
+    } else if ((command.m_verb == CMD_SAVE || command.m_verb == CMD_LOAD) && !m_fileCommands) {
+        *session.m_out << "Saving and loading are turned off here." << '\n';
+    } else if (command.m_verb == CMD_SAVE || command.m_verb == CMD_LOAD) {
+        string path = command.m_text.empty() ? m_saveFile : command.m_text;
+        if (path.empty()) {
+            *session.m_out << "No save file. Name one, or start with --save FILE." << '\n';
+        } else if (command.m_verb == CMD_SAVE) {
+            SaveHero(session, path);
+        } else if (LoadHero(session, path)) {
+            Look(session);
+        }
+    } else if (command.m_verb == CMD_HELP) {
+        *session.m_out << GetCommandHelp();
+    } else if (command.m_verb == CMD_QUIT) {
+        *session.m_out << "Good bye!" << '\n';
+        return false;
+    }
+    return true;
+}
+  // Name: SetFileCommands(bool allowed)
+  // Description: Turns the save and load commands on or off (a server
+  //              must not let players write files on its disk).
+  // Preconditions: None.
+  // Postconditions: m_fileCommands is set; the default is on.
+void Game::SetFileCommands(bool allowed) {
+    m_fileCommands = allowed;
+}
+  // Name: OpenSession(GameSession& session, uint64_t seed, OutputSink* out,
+  //                   SessionInput* input, Router* router,
+  //                   CraftPlanner* planner, SessionMode mode)
+  // Description: Makes a session with a new hero in the first area that
+  //              reads input and replies through out, running the
+  //              command loop or the menus. It routes and plans with
+  //              router and planner (see NewRouter and NewPlanner).
+  // Preconditions: The world and recipes are loaded and not lazy;
+  //                BuildRouter has run; out, input, router and planner
+  //                outlive the session.
+  // Postconditions: session is ready for StepSession (nothing has run).
+void Game::OpenSession(GameSession& session, uint64_t seed, OutputSink* out,
+                       SessionInput* input, Router* router, CraftPlanner* planner,
+                       SessionMode mode) {
+    session.m_hero = new Hero(SCRIPT_HERO, m_registry, seed);
+    session.m_craftIndex = new CraftIndex(m_items, m_registry.GetSize());
+    session.m_hero->SetCraftIndex(session.m_craftIndex);
+    session.m_hero->SetOutput(out);
+    session.m_area = START_AREA;
+    session.m_out = out;
+    session.m_input = input;
+    session.m_journal = nullptr;
+    session.m_router = router;
+    session.m_planner = planner;
+    //Tasks are lazy: this only makes the frame, StepSession runs it
+    session.m_task = mode == SESSION_MENUS ? PlaySession(session) : CommandSession(session);
+    session.m_started = false;
+}
+  // Name: StepSession(GameSession& session)
+  // Description: Runs session's game loop until it needs input its
+  //              SessionInput does not hold yet: the first call starts
+  //              it, later calls resume the read it waits in.
+  // Preconditions: session was opened by this Game; no other thread is
+  //                stepping it or using its router and planner. Other
+  //                sessions may step at the same time: the loop only
+  //                reads the Game.
+  // Postconditions: Returns false once the session has ended (quit);
+  //                 the replies are in session.m_out.
+bool Game::StepSession(GameSession& session) {
+    if (!session.m_started) {
+        session.m_started = true;
+        session.m_task.Start();
+    } else {
+        //Nothing to resume until a whole answer has arrived
+        coroutine_handle<> ready = session.m_input->TakeReady();
+        if (ready) {
+            ready.resume();
+        }
+    }
+    return !session.m_task.IsDone();
+}
+  // Name: CloseSession(GameSession& session)
+  // Description: Frees the session's game loop, hero and craft index.
+  // Preconditions: session was opened by this Game; it is not running.
+  // Postconditions: session holds no hero.
+void Game::CloseSession(GameSession& session) {
+    //The loop's frames go first; they may point at the hero
+    session.m_task = SessionTask();
+    delete session.m_hero;
+    session.m_hero = nullptr;
+    delete session.m_craftIndex;
+    session.m_craftIndex = nullptr;
+}
+  // Name: ResumeSession(GameSession& session)
+  // Description: Restores the hero from m_saveFile if it exists, then
+  //              replays the journal records taken after it (the whole
+  //              journal without a save) and opens the journal for
+  //              appending (a new journal starts with the hero as is).
+  // Preconditions: Hero exists; the snapshot store is built.
+  // Postconditions: Returns false, after printing why, if the save or
+  //              the journal cannot be used.
+bool Game::ResumeSession(GameSession& session) {
+    string error;
+    JournalMark mark = {0, 0};
+    bool saved = !m_saveFile.empty() && ifstream(m_saveFile).good();
+    if (saved && !m_snapshots->Load(m_saveFile, GetAreaCount(), *session.m_hero, session.m_area, mark, error)) {
+        *session.m_out << "Could not load " << m_saveFile << ": " << error << '\n';
+        return false;
+    }
+    if (m_journalFile.empty()) {
+        return true;
+    }
+    uint64_t end = 0;
+    if (ifstream(m_journalFile).good()) {
+        JournalReplayer replayer(m_registry, m_items, GetAreaCount());
+        if (!replayer.Open(m_journalFile, error)) {
+            *session.m_out << "Could not open journal " << m_journalFile << ": " << error << '\n';
+            return false;
+        }
+        //Only the records after the save are new to the hero
+        uint64_t from = replayer.GetStart();
+        if (saved && mark.m_id != replayer.GetId()) {
+            *session.m_out << m_saveFile << " was not saved from journal " << m_journalFile << "." << '\n';
+            return false;
+        } else if (saved) {
+            from = mark.m_offset;
+        }
+        //Replay silently and without the craft index, which is rebuilt once
+        NullSink quiet;
+        session.m_hero->SetOutput(&quiet);
+        session.m_hero->SetCraftIndex(nullptr);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        bool replayed = replayer.Replay(from, m_replayLimit, *session.m_hero, session.m_area, error);
+        long long micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        session.m_hero->SetCraftIndex(session.m_craftIndex);
+        session.m_hero->SetOutput(session.m_out);
+        if (!replayed) {
+            *session.m_out << "Could not replay journal " << m_journalFile << ": " << error << '\n';
+            return false;
+        }
+        *session.m_out << "Replayed " << replayer.GetApplied() << " actions from " << m_journalFile
+               << " in " << micros / 1000 << " ms." << '\n';
+        if (replayer.IsTorn()) {
+            *session.m_out << "The last action in the journal was incomplete and is dropped." << '\n';
+        }
+        end = replayer.GetEnd();
+    } else if (m_replayOnly) {
+        *session.m_out << "There is no journal " << m_journalFile << " to replay." << '\n';
+        return false;
+    }
+    if (m_replayOnly) {
+        return true;
+    }
+    session.m_journal = new Journal();
+    if (!session.m_journal->Open(m_journalFile, m_registry, end, error)) {
+        *session.m_out << "Could not open journal " << m_journalFile << ": " << error << '\n';
+        return false;
+    }
+    if (end == 0) {
+        //A new journal starts from the hero as it is now
+        string snapshot;
+        m_snapshots->Encode(*session.m_hero, session.m_area, session.m_journal->GetMark(), snapshot);
+        session.m_journal->RecordRestore(snapshot);
+    }
+    return true;
+}
+  // Name: PlaySession(GameSession& session)
+  // Description: A menu session: welcome, hero name, first area, then
+  //              the main menu until the player quits.
+  // Preconditions: Hero exists; session.m_input is set.
+  // Postconditions: The task ends once the player quits.
+SessionTask Game::PlaySession(GameSession& session) {
+    *session.m_out << "Welcome to UMBC Runescape!" << '\n';
+    co_await HeroCreation(session);
+    Look(session);
+    co_await Action(session);
+}
+  // Name: CommandSession(GameSession& session)
+  // Description: A command session: welcome and first area, then one
+  //              command per input line until quit.
+  // Preconditions: Hero exists; session.m_input is set.
+  // Postconditions: The task ends once a quit command runs.
+SessionTask Game::CommandSession(GameSession& session) {
+    *session.m_out << "Welcome to UMBC Runescape!" << '\n';
+    Look(session);
+    string line;
+    do {
+        co_await session.m_input->ReadLine(line);
+    } while (RunCommand(session, line));
+}
+  // Name: EnterArea(GameSession& session, int area)
+  // Description: Puts the hero in area and journals the move.
+  // Preconditions: 0 <= area < GetAreaCount().
+  // Postconditions: session.m_area is area.
+void Game::EnterArea(GameSession& session, int area) {
+    session.m_area = area;
+    if (session.m_journal != nullptr) {
+        session.m_journal->RecordMove(area);
+    }
+}
+  // Name: GatherHere(GameSession& session, GatherKind kind)
+  // Description: Has the hero gather and journals what was found.
+  // Preconditions: Hero exists.
+  // Postconditions: Returns the item found, or NO_ITEM.
+ItemId Game::GatherHere(GameSession& session, GatherKind kind) {
+    ItemId found = NO_ITEM;
+    if (kind == GATHER_RAW) {
+        found = session.m_hero->Raw();
+    } else if (kind == GATHER_NATURAL) {
+        found = session.m_hero->Natural();
+    } else if (kind == GATHER_FOOD) {
+        found = session.m_hero->Food();
     } else {
-        m_myHero->Hunt();
+        found = session.m_hero->Hunt();
+    }
+    //The outcome is recorded, so a replay needs no random engine
+    if (session.m_journal != nullptr) {
+        session.m_journal->RecordGather(kind, found);
+    }
+    return found;
+}
+  // Name: CraftRecipe(GameSession& session, int recipe, int count)
+  // Description: Has the hero craft a batch of m_items[recipe] and
+  //              journals it if it was made.
+  // Preconditions: 0 <= recipe < m_items.size().
+  // Postconditions: Returns the result of Hero::Craft.
+bool Game::CraftRecipe(GameSession& session, int recipe, int count) {
+    if (!session.m_hero->Craft(*m_items[recipe], count)) {
+        return false;
+    }
+    if (session.m_journal != nullptr) {
+        session.m_journal->RecordCraft(m_items[recipe]->GetID(), count);
+    }
+    return true;
+}
+  // Name: FindRecipe(const string& name) const
+  // Description: Finds the recipe whose product is name, ignoring case.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: Returns the index into m_items, or -1.
+int Game::FindRecipe(const string& name) const {
+    for (unsigned long i = 0; i < m_items.size(); i++) {
+        const string& itemName = m_items[i]->GetName();
+        if (itemName.size() != name.size()) {
+            continue;
+        }
+        bool same = true;
+        for (unsigned long j = 0; j < name.size() && same; j++) {
+            same = tolower(static_cast<unsigned char>(itemName[j])) == tolower(static_cast<unsigned char>(name[j]));
+        }
+        if (same) {
+            return static_cast<int>(i);
+        }
     }
+    return -1;
 }
\ No newline at end of file
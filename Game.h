@@ -5,14 +5,31 @@
 #include "Area.h"
 #include "Hero.h"
 #include "Item.h"
+#include "MappedFile.h"
+#include "MapRecord.h"
+#include "AreaCache.h"
+#include "WorldPack.h"
+#include "ThreadPool.h"
+#include "World.h"
+#include "Router.h"
+#include "CraftPlanner.h"
+#include "WorldValidator.h"
+#include "Command.h"
+#include "OutputSink.h"
+#include "Snapshot.h"
+#include "Journal.h"
+#include "Session.h"
 
 //Includes of required libraries
 #include <iostream>
+#include <chrono>
 #include <ctime>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <iomanip>
+#include <utility>
+#include <algorithm>
 
 using namespace std;
 
@@ -20,6 +37,46 @@ using namespace std;
 //GAME CONSTANTS
 const int START_AREA = 0; //starting area number
 const char DELIMITER = '|'; //delimiter for input file (map file)
+const int LAZY_CACHE_SIZE = 64; //areas kept in memory in LOAD_LAZY mode
+const int AREA_FIELDS = 7; //'|' terminated fields per map record
+const int CHUNKS_PER_THREAD = 4; //LOAD_PARALLEL chunks per worker (load balance)
+const size_t MIN_CHUNK_BYTES = 1 << 16; //smallest chunk worth a task
+const string SCRIPT_HERO = "Hero"; //hero name until a script's name command
+
+//How StartGame reads the map and craft files
+enum LoadMode {
+  LOAD_STREAM, //ifstream + getline per field (original loader)
+  LOAD_MAPPED, //mmap the files and parse in place (no per-field allocation)
+  LOAD_LAZY,   //index the map file; load each area's text on first visit
+  LOAD_PACK,   //map a compiled world pack (see packc.cpp); no parsing
+  LOAD_PARALLEL //mmap the map file and parse chunks of it on a thread pool
+};
+
+//What a session runs (see OpenSession)
+enum SessionMode {
+  SESSION_COMMANDS, //script commands, one per line (Command.h)
+  SESSION_MENUS //the numbered menus of the console game
+};
+
+//One player of a Game. The world, recipes and registry stay in the Game
+//and are only read while playing; everything a player changes lives
+//here: the hero, its craftable-now index, its position, its sinks and
+//its coroutine, which is suspended while it waits for the player's next
+//input. The router and planner keep search scratch, so they are lent by
+//the one thread that steps the session (see Server.h). StartGame plays
+//the Game's own session; a server opens one per connection.
+struct GameSession {
+  Hero* m_hero; //The session's hero (owned, see CloseSession)
+  CraftIndex* m_craftIndex; //Craftable-now index fed by m_hero (owned)
+  int m_area; //Current area
+  OutputSink* m_out; //Where the session's replies go (not owned)
+  SessionInput* m_input; //Where the session's input comes from (not owned)
+  Journal* m_journal; //Open journal (null without one)
+  Router* m_router; //Route engine used by Travel (not owned)
+  CraftPlanner* m_planner; //Planner used by Plan Item (not owned)
+  SessionTask m_task; //The session's game loop
+  bool m_started; //Whether m_task has been started
+};
 
 class Game {
 public:
@@ -27,8 +84,8 @@ public:
   // Description: Creates a new Game
   // Preconditions: None
   // Postconditions: Initializes all game variables to defaults (constants)
-  // including m_myHero (null), mapFile (passed value), craftFile (passed)
-  // and starting area (START_AREA)
+  // including m_player's hero (null), mapFile (passed value), craftFile
+  // (passed) and starting area (START_AREA). File names are moved in.
   Game(string, string);
   // Name: ~Game
   // Description: Destructor
@@ -37,12 +94,12 @@ public:
   //                 in Game
   ~Game();
   // Name: LoadMap()
-  // Description: Reads area data from the map file and dynamically
-  //             creates Area objects. Inserts each new Area into
-  //             m_myMap in the order encountered.
+  // Description: Reads area data from the map file and adds each area
+  //             to m_world (text is copied into the world's arena) in
+  //             the order encountered.
   // Preconditions: m_mapFile is set to a valid filename;
   //             the file exists and is formatted correctly.
-  // Postconditions: m_myMap contains all loaded Area pointers;
+  // Postconditions: m_world contains all loaded areas;
   //             file stream is closed.
   void LoadMap();
   // Name: LoadCraft()
@@ -52,21 +109,199 @@ public:
   // Preconditions: m_craftFile is set to a valid filename;
   //              the file exists and uses DELIMITER.
   // Postconditions: m_items contains new Item pointers for
-  //              every recipe; file stream is closed.
+  //              every recipe; every product and ingredient name is
+  //              interned in m_registry; file stream is closed.
   void LoadCraft();
-  // Name: HeroCreation()
+  // Name: LoadMapMapped()
+  // Description: Same result as LoadMap, but maps the file into memory
+  //              and parses it in place: area names and descriptions
+  //              are views into the mapping and numbers are parsed with
+  //              from_chars, so no field is heap allocated.
+  // Preconditions: m_areaFile is set to a valid filename;
+  //             the file exists and is formatted correctly.
+  // Postconditions: m_world contains all loaded areas as views;
+  //             m_mapText keeps the file mapped for the game's lifetime.
+  void LoadMapMapped();
+  // Name: LoadCraftMapped()
+  // Description: Same result as LoadCraft, but parses a memory mapping
+  //              of the craft file in place.
+  // Preconditions: m_craftFile is set to a valid filename.
+  // Postconditions: m_items and m_registry are filled as by LoadCraft;
+  //              the mapping is released once parsing ends.
+  void LoadCraftMapped();
+  // Name: LoadMapIndex()
+  // Description: Lazy alternative to LoadMap. Scans the map file once
+  //              and keeps only ids and exits (in m_world, with empty
+  //              text) plus a file offset per area; names and
+  //              descriptions are read from the file on first visit and
+  //              kept in a bounded LRU cache (see GetArea).
+  // Preconditions: m_areaFile is set to a valid filename;
+  //             the file exists and is formatted correctly.
+  // Postconditions: m_areaOffsets holds one offset per area; the map
+  //             file stays open for on-demand reads.
+  void LoadMapIndex();
+  // Name: LoadMapParallel(int threadCount)
+  // Description: Same result as LoadMapMapped, but splits the mapping
+  //              into chunks on record boundaries and parses the chunks
+  //              on a thread pool. Boundaries are found by counting
+  //              delimiters per chunk in parallel: a record starts after
+  //              every AREA_FIELDS-th '|', wherever newlines fall.
+  // Preconditions: m_areaFile is set to a valid filename;
+  //             the file exists and is formatted correctly.
+  // Postconditions: m_world holds the areas in file order (the same
+  //             order as LoadMap); m_mapText keeps the file mapped.
+  //             Throws invalid_argument on a malformed number.
+  void LoadMapParallel(int threadCount);
+  // Name: LoadPack()
+  // Description: Opens m_areaFile as a world pack. Item names are
+  //              interned in pack order so ItemIds match the pack, and
+  //              Items are built from its pre-resolved recipes; areas
+  //              are views into the mapping, made on first visit.
+  // Preconditions: m_areaFile names a pack written by CompilePack.
+  // Postconditions: m_pack is open and m_items and m_registry are
+  //              filled; returns false if the pack is missing or invalid
+  //              (including an item id or ingredient run out of range).
+  bool LoadPack();
+  // Name: GetArea(int index)
+  // Description: Returns the area at index, materializing it from the
+  //              map file in LOAD_LAZY mode or from the pack in
+  //              LOAD_PACK mode.
+  // Preconditions: Map has been loaded; 0 <= index < GetAreaCount().
+  // Postconditions: Returns a view of the area. In LOAD_LAZY mode its
+  //              text is only valid until the next GetArea call.
+  Area GetArea(int index);
+  // Name: GetAreaCount() const
+  // Description: Reports how many areas the loaded map has.
+  // Preconditions: Map has been loaded.
+  // Postconditions: Returns the number of areas.
+  int GetAreaCount() const;
+  // Name: GetWorld() const
+  // Description: Structure-of-arrays view of the loaded map, for
+  //              passes over the whole graph.
+  // Preconditions: Map has been loaded and not in LOAD_PACK mode (the
+  //              pack's exit table is used in place); in LOAD_LAZY mode
+  //              it has ids and exits but no text.
+  // Postconditions: Returns m_world.
+  const World& GetWorld() const;
+  // Name: GetItems() const
+  // Description: The loaded recipes, in craft file order.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: Returns m_items.
+  const vector<Item*>& GetItems() const;
+  // Name: GetRegistry() const
+  // Description: Item name <-> ItemId table for the loaded recipes.
+  // Preconditions: None.
+  // Postconditions: Returns m_registry.
+  const ItemRegistry& GetRegistry() const;
+  // Name: CheckWorld()
+  // Description: Validates the loaded map in parallel (see
+  //              ValidateWorld) and prints the report when the map is
+  //              invalid or m_reportOnly is set.
+  // Preconditions: Map has been loaded from text (packc has already
+  //              validated a pack).
+  // Postconditions: Returns true if the map is safe to play.
+  bool CheckWorld();
+  // Name: BuildRouter()
+  // Description: Builds the route engine (and its landmark tables on
+  //              large maps) over m_world; in LOAD_PACK mode it routes
+  //              over the pack's exits with the tables packc stored.
+  // Preconditions: Map has been loaded and checked.
+  // Postconditions: m_router is ready for Travel.
+  void BuildRouter();
+  // Name: GetRouter()
+  // Description: Route engine for the loaded map.
+  // Preconditions: BuildRouter() has run.
+  // Postconditions: Returns m_router.
+  Router* GetRouter();
+  // Name: NewRouter() const
+  // Description: Makes another route engine over the same exits that
+  //              borrows m_router's landmark tables, so a thread can
+  //              route without sharing m_router's search scratch.
+  // Preconditions: BuildRouter() has run; m_router outlives the result.
+  // Postconditions: Returns a new Router (the caller deletes it).
+  Router* NewRouter() const;
+  // Name: BuildPlanner()
+  // Description: Builds the crafting planner over m_items.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: m_planner is ready for PlanItem.
+  void BuildPlanner();
+  // Name: NewPlanner() const
+  // Description: Makes another crafting planner over m_items, with its
+  //              own bill memo and scratch.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: Returns a new CraftPlanner (the caller deletes it).
+  CraftPlanner* NewPlanner() const;
+  // Name: BuildCraftIndex()
+  // Description: Builds the craftable-now index over m_items.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: m_player's craft index is ready to attach to the hero.
+  void BuildCraftIndex();
+  // Name: SetLazyCacheSize(int size)
+  // Description: Sets how many materialized areas LOAD_LAZY keeps.
+  // Preconditions: size >= 1.
+  // Postconditions: The area cache holds at most size areas.
+  void SetLazyCacheSize(int size);
+  // Name: SetSeed(uint64_t seed)
+  // Description: Sets the seed the hero's random engine starts from.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_seed is set; equal seeds and input replay a session.
+  void SetSeed(uint64_t seed);
+  // Name: SetThreadCount(int threadCount)
+  // Description: Sets the worker count for LOAD_PARALLEL.
+  // Preconditions: None (0 uses every hardware thread).
+  // Postconditions: m_threadCount is set.
+  void SetThreadCount(int threadCount);
+  // Name: SetReportOnly(bool reportOnly)
+  // Description: Makes StartGame print the validation report and stop.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_reportOnly is set.
+  void SetReportOnly(bool reportOnly);
+  // Name: SetOutput(OutputSink* out)
+  // Description: Chooses where the game and its hero print.
+  // Preconditions: Called before StartGame; out outlives the game.
+  // Postconditions: m_out is set; the default is GetConsole().
+  void SetOutput(OutputSink* out);
+  // Name: SetScript(const string& scriptFile)
+  // Description: Makes StartGame run the commands in scriptFile ("-"
+  //              for standard input) instead of the menus.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_scriptFile is set.
+  void SetScript(const string& scriptFile);
+  // Name: SetSaveFile(const string& saveFile)
+  // Description: Makes StartGame resume the hero saved in saveFile (if
+  //              it exists) and checkpoint it after every command.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_saveFile is set.
+  void SetSaveFile(const string& saveFile);
+  // Name: SetJournalFile(const string& journalFile)
+  // Description: Makes StartGame rebuild the session from journalFile
+  //              (if it exists) and append every action to it.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_journalFile is set.
+  void SetJournalFile(const string& journalFile);
+  // Name: SetReplayOnly(long long limit)
+  // Description: Makes StartGame replay the first limit journal
+  //              actions (0 = all), show the result and stop.
+  // Preconditions: Called before StartGame, with a journal file set.
+  // Postconditions: m_replayOnly and m_replayLimit are set.
+  void SetReplayOnly(long long limit);
+  // Name: SetLoadMode(LoadMode mode)
+  // Description: Chooses which loaders StartGame uses.
+  // Preconditions: Called before StartGame.
+  // Postconditions: m_loadMode is set.
+  void SetLoadMode(LoadMode mode);
+  // Name: HeroCreation(GameSession& session)
   // Description: Prompts the player to enter a hero name and
-  //              constructs a new Hero.
-  // Preconditions: Standard input (cin) is available.
-  // Postconditions: m_myHero points to a newly allocated Hero
-  //              with the entered name.
-  void HeroCreation();
-  // Name: Look()
+  //              gives it to the hero.
+  // Preconditions: Hero exists; session.m_input is set.
+  // Postconditions: The hero has the entered name.
+  SessionTask HeroCreation(GameSession& session);
+  // Name: Look(GameSession& session)
   // Description: Displays the current Area’s name, description,
   //              and possible exits.
-  // Preconditions: m_curArea is a valid index into m_myMap.
+  // Preconditions: session.m_area is a valid area index.
   // Postconditions: Current area details are printed to stdout.
-  void Look();
+  void Look(GameSession& session);
   // Name: StartGame()
   // Description: Initializes game flow by loading map and crafting
   //              data, creating the hero, then showing the
@@ -74,42 +309,225 @@ public:
   // Preconditions: m_mapFile and m_craftFile are set; files exist.
   // Postconditions: Game state is initialized and Action() is called.
   void StartGame();
-  // Name: Action()
+  // Name: Action(GameSession& session)
   // Description: Presents the player with the main menu
-  //              (Look, Move, Use Area, Craft, Inventory, Quit)
+  //              (Look, Move, Use Area, Craft, Inventory, Quit, Travel)
   //              and drives game interactions until the player quits.
   // Preconditions: Hero and map are initialized.
   // Postconditions: Continues looping until user selects Quit.
-  void Action();
-  // Name: Move()
+  SessionTask Action(GameSession& session);
+  // Name: Move(GameSession& session)
   // Description: Prompts the player for a direction (N/E/S/W),
-  //              validates the move, updates m_curArea, and
+  //              validates the move, updates session.m_area, and
   //              calls Look() to show the new area.
-  // Preconditions: m_curArea is valid; m_myMap contains
-  //              adjacent Area pointers.
-  // Postconditions: m_curArea is updated to the new area index.
-  void Move();
-  // Name: CraftItem()
-  // Description: Displays all craftable items, prompts for a selection,
-  //              and attempts crafting via Hero’s CanCraft/Craft methods.
+  // Preconditions: session.m_area is valid; the map has
+  //              been loaded.
+  // Postconditions: session.m_area is updated to the new area index.
+  SessionTask Move(GameSession& session);
+  // Name: Travel(GameSession& session)
+  // Description: Prompts for a destination area, finds a shortest route
+  //              with session.m_router and walks it, printing the directions.
+  // Preconditions: BuildRouter() has run; session.m_area is valid.
+  // Postconditions: session.m_area is the destination if it is reachable.
+  SessionTask Travel(GameSession& session);
+  // Name: TravelTo(GameSession& session, int destination)
+  // Description: Finds a shortest route to destination with session.m_router
+  //              and walks it, printing the directions.
+  // Preconditions: BuildRouter() has run; session.m_area is valid.
+  // Postconditions: session.m_area is the destination if it is reachable.
+  void TravelTo(GameSession& session, int destination);
+  // Name: CraftItem(GameSession& session)
+  // Description: Displays all craftable items, prompts for a selection
+  //              and a batch size (when more than one is affordable),
+  //              and crafts the batch via Hero's Craft method.
   // Preconditions: m_items is populated with Item pointers.
   // Postconditions: If crafting succeeds, inventory is
   //              updated; otherwise prints error.
-  void CraftItem();
-  // Name: UseArea()
+  SessionTask CraftItem(GameSession& session);
+  // Name: PlanItem(GameSession& session)
+  // Description: Prompts for a craftable item and prints the raw
+  //              materials it takes from scratch and those still missing.
+  // Preconditions: BuildPlanner() has run; Hero exists.
+  // Postconditions: Nothing changes; the plan is printed.
+  SessionTask PlanItem(GameSession& session);
+  // Name: PlanRecipe(GameSession& session, int recipe)
+  // Description: Prints the raw materials m_items[recipe] takes from
+  //              scratch and those still missing once the hero's items,
+  //              crafted ones included, are used.
+  // Preconditions: BuildPlanner() has run; Hero exists;
+  //              0 <= recipe < m_items.size().
+  // Postconditions: Nothing changes; the plan is printed.
+  void PlanRecipe(GameSession& session, int recipe);
+  // Name: ShowCraftable(GameSession& session)
+  // Description: Lists only the items the hero can craft right now.
+  // Preconditions: The hero has session.m_craftIndex attached.
+  // Postconditions: Nothing changes; the list is printed in menu order.
+  void ShowCraftable(GameSession& session);
+  // Name: UseArea(GameSession& session)
   // Description: Prompts the player to choose a search action
   //              (Raw, Natural, Food, Hunt)
   //              and forwards that request to the Hero.
   // Preconditions: Hero exists and has methods Raw/Natural/Food/Hunt.
   // Postconditions: One gather action is performed and the result printed.
-  void UseArea();
+  SessionTask UseArea(GameSession& session);
+  // Name: SaveHero(GameSession& session, const string& path)
+  // Description: Saves the hero and current area as a snapshot.
+  // Preconditions: Hero exists; the snapshot store is built.
+  // Postconditions: Returns true if path was written; prints the result.
+  bool SaveHero(GameSession& session, const string& path);
+  // Name: LoadHero(GameSession& session, const string& path)
+  // Description: Restores the hero's name, inventory and area from a
+  //              snapshot saved against the same craft file.
+  // Preconditions: Hero exists; the snapshot store is built.
+  // Postconditions: Returns true if restored; otherwise prints why and
+  //              nothing changes.
+  bool LoadHero(GameSession& session, const string& path);
+  // Name: Checkpoint(GameSession& session)
+  // Description: Writes the journal records of the last command, then
+  //              saves the hero to m_saveFile if it has changed since
+  //              the last save (each only if its file is set).
+  // Preconditions: Hero exists; the snapshot store is built.
+  // Postconditions: m_journalFile and m_saveFile hold the current hero.
+  void Checkpoint(GameSession& session);
+  // Name: RunScript(GameSession& session, istream& input)
+  // Description: Runs one command per line from input without
+  //              prompting, until quit or the end of input. A line that
+  //              does not parse is reported with its line number and
+  //              skipped.
+  // Preconditions: Hero and map are initialized.
+  // Postconditions: Every command before quit has been executed.
+  void RunScript(GameSession& session, istream& input);
+  // Name: RunCommand(GameSession& session, const string& line)
+  // Description: Parses and executes one line of the command language.
+  // Preconditions: Hero and map are initialized.
+  // Postconditions: Returns false once the line is quit; a line that
+  //              does not parse is reported and ignored.
+  bool RunCommand(GameSession& session, const string& line);
+  // Name: RunCommand(const string& line)
+  // Description: Runs one line of the command language for the game's
+  //              own player (see StartGame).
+  // Preconditions: Hero and map are initialized.
+  // Postconditions: As RunCommand(m_player, line).
+  bool RunCommand(const string& line);
+  // Name: Execute(GameSession& session, const Command& command)
+  // Description: Performs a parsed command with the same game actions
+  //              (and messages) as the menus, minus the prompts.
+  // Preconditions: Hero and map are initialized.
+  // Postconditions: Returns false for quit, true otherwise.
+  bool Execute(GameSession& session, const Command& command);
+  // Name: SetFileCommands(bool allowed)
+  // Description: Turns the save and load commands on or off (a server
+  //              must not let players write files on its disk).
+  // Preconditions: None.
+  // Postconditions: m_fileCommands is set; the default is on.
+  void SetFileCommands(bool allowed);
+  // Name: OpenSession(GameSession& session, uint64_t seed, OutputSink* out,
+  //                   SessionInput* input, Router* router,
+  //                   CraftPlanner* planner, SessionMode mode)
+  // Description: Makes a session with a new hero in the first area that
+  //              reads input and replies through out, running the
+  //              command loop or the menus. It routes and plans with
+  //              router and planner (see NewRouter and NewPlanner).
+  // Preconditions: The world and recipes are loaded and not lazy;
+  //                BuildRouter has run; out, input, router and planner
+  //                outlive the session.
+  // Postconditions: session is ready for StepSession (nothing has run).
+  void OpenSession(GameSession& session, uint64_t seed, OutputSink* out,
+                   SessionInput* input, Router* router, CraftPlanner* planner,
+                   SessionMode mode);
+  // Name: StepSession(GameSession& session)
+  // Description: Runs session's game loop until it needs input its
+  //              SessionInput does not hold yet: the first call starts
+  //              it, later calls resume the read it waits in.
+  // Preconditions: session was opened by this Game; no other thread is
+  //                stepping it or using its router and planner. Other
+  //                sessions may step at the same time: the loop only
+  //                reads the Game.
+  // Postconditions: Returns false once the session has ended (quit);
+  //                 the replies are in session.m_out.
+  bool StepSession(GameSession& session);
+  // Name: CloseSession(GameSession& session)
+  // Description: Frees the session's game loop, hero and craft index.
+  // Preconditions: session was opened by this Game; it is not running.
+  // Postconditions: session holds no hero.
+  void CloseSession(GameSession& session);
 private:
-  Hero* m_myHero; // Hero pointer for Hero (Player)
-  vector<Area*> m_areas; // Vector for holding all areas in game
-  int m_curArea; // Current area that player (Hero) is in
+  // Name: ResumeSession(GameSession& session)
+  // Description: Restores the hero from m_saveFile if it exists, then
+  //              replays the journal records taken after it (the whole
+  //              journal without a save) and opens the journal for
+  //              appending (a new journal starts with the hero as is).
+  // Preconditions: Hero exists; the snapshot store is built.
+  // Postconditions: Returns false, after printing why, if the save or
+  //              the journal cannot be used.
+  bool ResumeSession(GameSession& session);
+  // Name: PlaySession(GameSession& session)
+  // Description: A menu session: welcome, hero name, first area, then
+  //              the main menu until the player quits.
+  // Preconditions: Hero exists; session.m_input is set.
+  // Postconditions: The task ends once the player quits.
+  SessionTask PlaySession(GameSession& session);
+  // Name: CommandSession(GameSession& session)
+  // Description: A command session: welcome and first area, then one
+  //              command per input line until quit.
+  // Preconditions: Hero exists; session.m_input is set.
+  // Postconditions: The task ends once a quit command runs.
+  SessionTask CommandSession(GameSession& session);
+  // Name: EnterArea(GameSession& session, int area)
+  // Description: Puts the hero in area and journals the move.
+  // Preconditions: 0 <= area < GetAreaCount().
+  // Postconditions: session.m_area is area.
+  void EnterArea(GameSession& session, int area);
+  // Name: GatherHere(GameSession& session, GatherKind kind)
+  // Description: Has the hero gather and journals what was found.
+  // Preconditions: Hero exists.
+  // Postconditions: Returns the item found, or NO_ITEM.
+  ItemId GatherHere(GameSession& session, GatherKind kind);
+  // Name: CraftRecipe(GameSession& session, int recipe, int count)
+  // Description: Has the hero craft a batch of m_items[recipe] and
+  //              journals it if it was made.
+  // Preconditions: 0 <= recipe < m_items.size().
+  // Postconditions: Returns the result of Hero::Craft.
+  bool CraftRecipe(GameSession& session, int recipe, int count);
+  // Name: FindRecipe(const string& name) const
+  // Description: Finds the recipe whose product is name, ignoring case.
+  // Preconditions: The craft file has been loaded.
+  // Postconditions: Returns the index into m_items, or -1.
+  int FindRecipe(const string& name) const;
+  // Name: ReadArea(istream& input, string& name, string& desc, AreaRecord& record)
+  // Description: Reads one '|' delimited area record (seven fields)
+  //              from input. The text is read into name and desc.
+  // Preconditions: input is positioned at the start of a record.
+  // Postconditions: Returns true and fills record (its views refer to
+  //              name and desc), or false if no complete record could
+  //              be read.
+  static bool ReadArea(istream& input, string& name, string& desc, AreaRecord& record);
+  World m_world; // Exits, ids and text of every area (empty for a pack)
   vector<Item*> m_items; // Vector of all craftable items
+  ItemRegistry m_registry; // Item name <-> ItemId table
   string m_craftFile; // Name of the input file for the craftable items
   string m_areaFile; // Name of the input file for the
+  LoadMode m_loadMode; // Loader used by StartGame
+  MappedFile m_mapText; // Mapped map file backing view areas (LOAD_MAPPED)
+  vector<long long> m_areaOffsets; // File offset of each record (LOAD_LAZY)
+  AreaCache m_areaCache; // Text of recently visited areas (LOAD_LAZY)
+  ifstream m_lazyStream; // Map file kept open for on-demand reads (LOAD_LAZY)
+  WorldPack m_pack; // Mapped world pack (LOAD_PACK)
+  int m_threadCount; // Parser threads (LOAD_PARALLEL)
+  uint64_t m_seed; // Seed for the hero's random engine
+  Router* m_router; // Shortest-path engine over m_world
+  CraftPlanner* m_planner; // Bill-of-materials planner over m_items
+  bool m_reportOnly; // Print the validation report instead of playing
+  string m_scriptFile; // Command script run instead of the menus ("-" = stdin)
+  string m_saveFile; // Snapshot resumed at start and kept current (optional)
+  SnapshotStore* m_snapshots; // Snapshot encoder over m_registry
+  string m_journalFile; // Action journal replayed at start and appended to (optional)
+  bool m_replayOnly; // Replay the journal and stop instead of playing
+  long long m_replayLimit; // Journal actions to replay (0 = all)
+  bool m_fileCommands; // Whether the save and load commands may touch files
+  OutputSink* m_out; // Where the game prints (not owned)
+  SessionInput m_console; // Menu input read from cin
+  GameSession m_player; // The console player: hero, area and journal (StartGame)
 };
 
 
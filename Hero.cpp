@@ -1,9 +1,13 @@
 #include "Hero.h"
-  // Name: Hero(const string& name)
+  // Name: Hero(const string& name, const ItemRegistry& registry, uint64_t seed)
   // Description: Constructs a new Hero with the specified name.
-  // Preconditions: name must be a valid, non‐empty string.
-  // Postconditions: m_name is initialized; inventory map is empty.
-Hero::Hero(const string& name) : m_name(name) {}
+  // Preconditions: name must be a valid, non‐empty string;
+  //                registry outlives the hero.
+  // Postconditions: m_name is initialized; inventory is empty;
+  //                 m_random is seeded with seed.
+Hero::Hero(const string& name, const ItemRegistry& registry, uint64_t seed)
+    : m_name(name), m_registry(&registry), m_craftIndex(nullptr), m_out(&GetConsole()),
+      m_random(seed), m_inventory(registry.GetSize(), -1) {}
   // Name: ~Hero()
   // Description: Destructor for Hero.
   // Preconditions: None.
@@ -13,8 +17,8 @@ Hero::~Hero() {}
   // Name: GetName()
   // Description: Retrieves the hero’s name.
   // Preconditions: None.
-  // Postconditions: Returns the value of m_name.
-string Hero::GetName() const {
+  // Postconditions: Returns a const reference to m_name.
+const string& Hero::GetName() const {
     return m_name;
 }
   // Name: SetName(const string& name)
@@ -23,127 +27,248 @@ string Hero::GetName() const {
   // Postconditions: m_name is set to the new value.
 void Hero::SetName(const string& name) {
     m_name = name;
+}
+  // Name: SetCraftIndex(CraftIndex* index)
+  // Description: Attaches the craftable-now index fed by inventory
+  //              changes (nullptr detaches it).
+  // Preconditions: index outlives the hero or is detached first.
+  // Postconditions: index is reset to the current inventory.
+void Hero::SetCraftIndex(CraftIndex* index) {
+    m_craftIndex = index;
+    if (m_craftIndex != nullptr) {
+        //Replay what is already held
+        m_craftIndex->Clear();
+        for (unsigned long i = 0; i < m_inventory.size(); i++) {
+            m_craftIndex->Update(static_cast<ItemId>(i), 0, GetCount(static_cast<ItemId>(i)));
+        }
+    }
 }
   // Name: DisplayInventory()
-  // Description: Prints the hero’s current inventory using overloaded << operator
-  // Preconditions: Inventory map has been initialized.
+  // Description: Prints the hero’s current inventory as name:count lines
+  //              in name order (same layout as the old Map output)
+  // Preconditions: Inventory has been initialized.
   // Postconditions: Inventory contents are displayed.
 void Hero::DisplayInventory() const {
-    cout << m_inventory << endl;
+    const vector<ItemId>& ordered = m_registry->GetSortedIds();
+    for (unsigned long i = 0; i < ordered.size(); i++) {
+        ItemId id = ordered[i];
+        //Only list items the hero has held at some point
+        if (id < static_cast<ItemId>(m_inventory.size()) && m_inventory[id] >= 0) {
+            *m_out << m_registry->GetName(id) << ":" << m_inventory[id] << '\n';
+        }
+    }
+    *m_out << '\n';
+}
+  // Name: SetOutput(OutputSink* out)
+  // Description: Chooses where messages and the inventory are printed
+  //              (a NullSink silences the hero).
+  // Preconditions: out is not null and outlives the hero.
+  // Postconditions: m_out is set; the default is GetConsole().
+void Hero::SetOutput(OutputSink* out) {
+    m_out = out;
+}
+  // Name: GetRandom()
+  // Description: The hero's random engine (drives gathering; tools may
+  //              draw their own decisions from it too).
+  // Preconditions: None.
+  // Postconditions: Returns m_random.
+Random& Hero::GetRandom() {
+    return m_random;
+}
+  // Name: CollectItem(ItemId item)
+  // Description: Increments the count for item, marking it as held.
+  // Preconditions: item is a valid id in the hero's registry.
+  // Postconditions: Inventory count for item is incremented by 1.
+void Hero::CollectItem(ItemId item) {
+    AddCount(item, 1);
 }
   // Name: CollectItem(const string& item)
-  // Description: If the item exists, in m_inventory, uses Update to increment quantity
-  //              If the item does not exist in m_inventory, inserts it.
-  // Preconditions: item must be a valid item name.
+  // Description: Looks the name up in the registry and collects it.
+  // Preconditions: item must be a registered item name.
   // Postconditions: Inventory count for item is incremented by 1.
-  // Note: Uses try and catch (const out_of_range&) and inserts if caught.
 void Hero::CollectItem(const string& item) {
-    try {
-        //Assuming item exists
-        int val = m_inventory.ValueAt(item);
-        //Update item's count
-        m_inventory.Update(item, val+1);
-    } catch (const out_of_range& e) {
-        //If item does not exist, simply insert it and set count to 1
-        m_inventory.Insert(item, 1);
+    ItemId id = m_registry->Lookup(item);
+    if (id != NO_ITEM) {
+        CollectItem(id);
     }
 }
-  // Name: CanCraft(const vector<string>& requirements)
-  // Description: Iterators through the requirements to see if they have quantity in m_inventory
-  // Preconditions: Requirements vector populated with item names.
-  // Postconditions: Returns true if every required item has count ≥1.
-  // Note: Uses try and catch (const out_of_range&) and returns false if caught.
-bool Hero::CanCraft(const vector<string>& requirements) const {
-    try {
-        for (unsigned long i = 0; i < requirements.size(); i++) {
-            //Check count of requirements
-            int val = m_inventory.ValueAt(requirements[i]);
-            //If any requirement is short, the item cannot be crafted
-            if (val < 1) {
-                return false;
+  // Name: GetCount(ItemId item) const
+  // Description: Reports how many of item the hero holds.
+  // Preconditions: None.
+  // Postconditions: Returns the count (0 if never collected).
+int Hero::GetCount(ItemId item) const {
+    if (item < 0 || item >= static_cast<ItemId>(m_inventory.size()) || m_inventory[item] < 0) {
+        return 0;
+    }
+    return m_inventory[item];
+}
+  // Name: GetInventory() const
+  // Description: The raw inventory, for saving it.
+  // Preconditions: None.
+  // Postconditions: Returns the count per ItemId (-1 = never collected).
+const vector<int>& Hero::GetInventory() const {
+    return m_inventory;
+}
+  // Name: RestoreInventory(vector<int>& counts)
+  // Description: Replaces the inventory with counts (laid out as by
+  //              GetInventory), telling the craft index only about the
+  //              items whose count changes.
+  // Preconditions: counts is indexed by the hero's registry ids.
+  // Postconditions: The inventory is counts; counts holds the old one.
+void Hero::RestoreInventory(vector<int>& counts) {
+    if (m_craftIndex != nullptr) {
+        unsigned long size = max(counts.size(), m_inventory.size());
+        for (unsigned long i = 0; i < size; i++) {
+            ItemId id = static_cast<ItemId>(i);
+            int after = i < counts.size() ? max(counts[i], 0) : 0;
+            if (GetCount(id) != after) {
+                m_craftIndex->Update(id, GetCount(id), after);
             }
         }
-    } catch (const out_of_range& e) {
-        return false;
     }
-    //Return true if all false-check tests fail
+    m_inventory.swap(counts);
+}
+  // Name: CanCraft(const Item& item, int count)
+  // Description: Checks every ingredient against count crafts of item,
+  //              honouring ingredients listed more than once.
+  // Preconditions: count >= 1.
+  // Postconditions: Returns true if every need x count is held.
+bool Hero::CanCraft(const Item& item, int count) const {
+    const vector<ItemNeed>& needs = item.GetNeeds();
+    for (unsigned long i = 0; i < needs.size(); i++) {
+        //If any requirement is short, the batch cannot be crafted
+        if (GetCount(needs[i].m_item) < static_cast<long long>(needs[i].m_count) * count) {
+            return false;
+        }
+    }
     return true;
 }
-  // Name: Craft(const string& result, const vector<string>& requirements)
-  // Description: Consumes the listed requirements and adds the
-  //              crafted "result" (iterates through requirements and Updates)
-  // Preconditions: Call to CanCraft(requirements) must return true.
-  // Postconditions: Each requirement’s count is decremented by 1;
-  //                 Result of crafting is added.
-void Hero::Craft(const string& result, const vector<string>& requirements) {
-    //Loop through requirements
-    for (unsigned long i = 0; i < requirements.size(); i++) {
-        //Obtain count
-        int val = m_inventory.ValueAt(requirements[i]);
-        //Decrement count as resource is being used
-        m_inventory.Update(requirements[i], val-1);
+  // Name: MaxCraftable(const Item& item) const
+  // Description: Largest batch of item the inventory allows, worked out
+  //              in 64-bit so every need x batch and the product's new
+  //              count still fit in an int.
+  // Preconditions: None.
+  // Postconditions: Returns 0..MAX_CRAFT_BATCH.
+int Hero::MaxCraftable(const Item& item) const {
+    //The products are added to an int count too
+    long long most = min(static_cast<long long>(MAX_CRAFT_BATCH),
+                         static_cast<long long>(INT_MAX) - GetCount(item.GetID()));
+    const vector<ItemNeed>& needs = item.GetNeeds();
+    for (unsigned long i = 0; i < needs.size(); i++) {
+        //A held count is an int, so need x most stays within one
+        most = min(most, static_cast<long long>(GetCount(needs[i].m_item)) / needs[i].m_count);
+    }
+    return static_cast<int>(most);
+}
+  // Name: Craft(const Item& item, int count)
+  // Description: Crafts count of item in one pass: consumes every need
+  //              x count and adds count results.
+  // Preconditions: None (the batch is checked first).
+  // Postconditions: Returns false and changes nothing if count is over
+  //                 MaxCraftable; otherwise prints the result.
+bool Hero::Craft(const Item& item, int count) {
+    //MaxCraftable also bounds every product below so it cannot overflow
+    if (count < 1 || count > MaxCraftable(item)) {
+        return false;
+    }
+    //Consume each ingredient once for the whole batch
+    const vector<ItemNeed>& needs = item.GetNeeds();
+    for (unsigned long i = 0; i < needs.size(); i++) {
+        long long used = static_cast<long long>(needs[i].m_count) * count;
+        AddCount(needs[i].m_item, -static_cast<int>(used));
     }
     //Print message of successful craft
-    cout << "Crafted: " << result << "!" << endl;
+    if (m_out->IsQuiet()) {
+        //Nothing to format
+    } else if (count == 1) {
+        *m_out << "Crafted: " << m_registry->GetName(item.GetID()) << "!" << '\n';
+    } else {
+        *m_out << "Crafted: " << count << " x " << m_registry->GetName(item.GetID()) << "!" << '\n';
+    }
     //Send result to user's collection
-    CollectItem(result);
+    AddCount(item.GetID(), count);
+    return true;
 }
   // Name: Raw()
   // Description: Simulates mining for raw materials. Passes values
   //              and calls Gather function.
-  // Preconditions: Random number generator seeded.
+  // Preconditions: None.
   // Postconditions: Possibly adds a random raw material
-  //                 to inventory or reports none found.
-void Hero::Raw() {
-    Gather(RawProducts, "You searched and found nothing.", "You mined and found some");
+  //                 to inventory or reports none found. Returns the
+  //                 item found or NO_ITEM.
+ItemId Hero::Raw() {
+    return Gather(m_registry->GetProducts(GATHER_RAW), "You searched and found nothing.", "You mined and found some");
 }
   // Name: Natural()
   // Description: Simulates foraging for natural resources. Passes values
   //              and calls Gather function.
-  // Preconditions: Random number generator seeded.
+  // Preconditions: None.
   // Postconditions: Possibly adds a random natural resource
-  //                 or reports none found.
-void Hero::Natural() {
-    Gather(NaturalProducts, "You searched and found nothing.", "You searched and harvested some");
+  //                 or reports none found. Returns the item or NO_ITEM.
+ItemId Hero::Natural() {
+    return Gather(m_registry->GetProducts(GATHER_NATURAL), "You searched and found nothing.", "You searched and harvested some");
 }
   // Name: Food()
   // Description: Simulates gathering food items. Passes values
   //              and calls Gather function.
-  // Preconditions: Random number generator seeded.
+  // Preconditions: None.
   // Postconditions: Possibly adds a random food item or reports none found.
-void Hero::Food() {
-    Gather(FoodProducts, "You searched and found nothing.", "You searched and harvested some");
+  //                 Returns the item or NO_ITEM.
+ItemId Hero::Food() {
+    return Gather(m_registry->GetProducts(GATHER_FOOD), "You searched and found nothing.", "You searched and harvested some");
 }
   // Name: Hunt()
   // Description: Simulates hunting for creature drops. Passes values
   //              and calls Gather function.
-  // Preconditions: Random number generator seeded.
+  // Preconditions: None.
   // Postconditions: Possibly adds a random creature drop
-  //                 or reports none found.
-void Hero::Hunt() {
-    Gather(HuntProducts, "You searched and found nothing.", "You searched and harvested some");
+  //                 or reports none found. Returns the item or NO_ITEM.
+ItemId Hero::Hunt() {
+    return Gather(m_registry->GetProducts(GATHER_HUNT), "You searched and found nothing.", "You searched and harvested some");
+}
+  // Name: AddCount(ItemId item, int delta)
+  // Description: Changes the count of item and tells the craft index.
+  // Preconditions: delta > 0, or the hero holds at least -delta.
+  // Postconditions: item is marked as held; its count moves by delta.
+void Hero::AddCount(ItemId item, int delta) {
+    //Registry may have grown since the hero was created
+    if (item >= static_cast<ItemId>(m_inventory.size())) {
+        m_inventory.resize(item + 1, -1);
+    }
+    int before = GetCount(item);
+    //First pickup turns "never collected" into a held count
+    if (m_inventory[item] < 0) {
+        m_inventory[item] = 0;
+    }
+    m_inventory[item] += delta;
+    if (m_craftIndex != nullptr) {
+        m_craftIndex->Update(item, before, m_inventory[item]);
+    }
 }
   // Name: Gather
   // Description: Randomly selects an item from vector products passed.
   //              If selection equals list size, prints 'noItemMsg';
   //              otherwise prints foundMsg + item and adds it
   //              to the hero's inventory.
-  // Preconditions: 'products' must contain valid item names.
+  // Preconditions: 'products' must contain valid item ids.
   // Postconditions: Inventory is incremented for the selected
-  //               item if found; message printed.
-void Hero::Gather(const vector<string>& products, const string& noItemMsg,
+  //               item if found; message printed. Returns the item
+  //               found or NO_ITEM.
+ItemId Hero::Gather(const vector<ItemId>& products, const string& noItemMsg,
     const string& foundMsg) {
-        //Generate a random number between 0 and 3 inclusive
-    unsigned long num = rand() % (products.size() + 1);
-    //If num is 3, that means that no item was found
+    //Pick 0..size inclusive (unbiased); size means nothing was found
+    unsigned long num = m_random.Below(static_cast<uint32_t>(products.size() + 1));
     if (num == products.size()) {
-        cout << noItemMsg << endl;
-    } else {
-        //If num is not 3, print item found.
-        string itemFound = products[num];
-        cout << foundMsg << " " << itemFound << "." << endl;
-        //Update user's collection after find
-        CollectItem(itemFound);
+        if (!m_out->IsQuiet()) {
+            *m_out << noItemMsg << '\n';
+        }
+        return NO_ITEM;
+    }
+    //Print the find and update user's collection
+    ItemId itemFound = products[num];
+    if (!m_out->IsQuiet()) {
+        *m_out << foundMsg << " " << m_registry->GetName(itemFound) << "." << '\n';
     }
-
+    CollectItem(itemFound);
+    return itemFound;
 }
\ No newline at end of file
@@ -5,25 +5,33 @@
 #include <vector>
 #include <stdexcept>
 #include <sstream>
-#include "Map.cpp"
+#include <algorithm>
+#include <climits>
+#include "ItemRegistry.h"
+#include "CraftIndex.h"
+#include "Random.h"
+#include "OutputSink.h"
 using namespace std;
 
-//The class that describes the hero!
+const int MAX_CRAFT_BATCH = 1000000; //Largest single craft batch
 
-//Constants
-//Things that can be found in an area
-const vector<string> RawProducts = {"Copper Ore","Iron Ore","Coal","Gemstone"};
-const vector<string> NaturalProducts = {"Log","Oak Log","Flax","Herb"};
-const vector<string> FoodProducts = {"Raw Fish","Grain","Vegetable","Meat"};
-const vector<string> HuntProducts = {"Bone","Leather","Hide","Claw"};
+//The class that describes the hero!
+//The inventory is a dense array of counts indexed by ItemId (see
+//ItemRegistry.h); item names are only used when printing. An attached
+//CraftIndex is told about every count change. Gather and craft messages
+//go to an optional output stream, and every hero owns its random engine,
+//so many heroes can run headless on separate threads and a seed replays
+//a session exactly.
 
 class Hero {
  public:
-  // Name: Hero(const string& name)
+  // Name: Hero(const string& name, const ItemRegistry& registry, uint64_t seed)
   // Description: Constructs a new Hero with the specified name.
-  // Preconditions: name must be a valid, non‐empty string.
-  // Postconditions: m_name is initialized; inventory map is empty.
-  Hero(const string& name);
+  // Preconditions: name must be a valid, non‐empty string;
+  //                registry outlives the hero.
+  // Postconditions: m_name is initialized; inventory is empty;
+  //                 m_random is seeded with seed.
+  Hero(const string& name, const ItemRegistry& registry, uint64_t seed);
   // Name: ~Hero()
   // Description: Destructor for Hero.
   // Preconditions: None.
@@ -33,78 +41,136 @@ class Hero {
   // Name: GetName()
   // Description: Retrieves the hero’s name.
   // Preconditions: None.
-  // Postconditions: Returns the value of m_name.
-  string GetName() const;
+  // Postconditions: Returns a const reference to m_name.
+  const string& GetName() const;
   // Name: SetName(const string& name)
   // Description: Updates the hero’s name.
   // Preconditions: name must be a valid string.
   // Postconditions: m_name is set to the new value.
   void SetName(const string& name);
+  // Name: SetCraftIndex(CraftIndex* index)
+  // Description: Attaches the craftable-now index fed by inventory
+  //              changes (nullptr detaches it).
+  // Preconditions: index outlives the hero or is detached first.
+  // Postconditions: index is reset to the current inventory.
+  void SetCraftIndex(CraftIndex* index);
+  // Name: SetOutput(OutputSink* out)
+  // Description: Chooses where messages and the inventory are printed
+  //              (a NullSink silences the hero).
+  // Preconditions: out is not null and outlives the hero.
+  // Postconditions: m_out is set; the default is GetConsole().
+  void SetOutput(OutputSink* out);
+  // Name: GetRandom()
+  // Description: The hero's random engine (drives gathering; tools may
+  //              draw their own decisions from it too).
+  // Preconditions: None.
+  // Postconditions: Returns m_random.
+  Random& GetRandom();
   // Name: DisplayInventory()
-  // Description: Prints the hero’s current inventory using overloaded << operator
-  // Preconditions: Inventory map has been initialized.
+  // Description: Prints the hero’s current inventory as name:count lines
+  //              in name order (same layout as the old Map output)
+  // Preconditions: Inventory has been initialized.
   // Postconditions: Inventory contents are displayed.
   void DisplayInventory() const;
+  // Name: CollectItem(ItemId item)
+  // Description: Increments the count for item, marking it as held.
+  // Preconditions: item is a valid id in the hero's registry.
+  // Postconditions: Inventory count for item is incremented by 1.
+  void CollectItem(ItemId item);
   // Name: CollectItem(const string& item)
-  // Description: If the item exists, in m_inventory, uses Update to increment quantity
-  //              If the item does not exist in m_inventory, inserts it.
-  // Preconditions: item must be a valid item name.
+  // Description: Looks the name up in the registry and collects it.
+  // Preconditions: item must be a registered item name.
   // Postconditions: Inventory count for item is incremented by 1.
-  // Note: Uses try and catch (const out_of_range&) and inserts if caught.
   void CollectItem(const string& item);
-  // Name: CanCraft(const vector<string>& requirements)
-  // Description: Iterators through the requirements to see if they have quantity in m_inventory
-  // Preconditions: Requirements vector populated with item names.
-  // Postconditions: Returns true if every required item has count ≥1.
-  // Note: Uses try and catch (const out_of_range&) and returns false if caught.
-  bool CanCraft(const vector<string>& requirements) const;
-  // Name: Craft(const string& result, const vector<string>& requirements)
-  // Description: Consumes the listed requirements and adds the
-  //              crafted "result" (iterates through requirements and Updates)
-  // Preconditions: Call to CanCraft(requirements) must return true.
-  // Postconditions: Each requirement’s count is decremented by 1;
-  //                 Result of crafting is added.
-  void Craft(const string& result, const vector<string>& requirements);
+  // Name: GetCount(ItemId item) const
+  // Description: Reports how many of item the hero holds.
+  // Preconditions: None.
+  // Postconditions: Returns the count (0 if never collected).
+  int GetCount(ItemId item) const;
+  // Name: GetInventory() const
+  // Description: The raw inventory, for saving it.
+  // Preconditions: None.
+  // Postconditions: Returns the count per ItemId (-1 = never collected).
+  const vector<int>& GetInventory() const;
+  // Name: RestoreInventory(vector<int>& counts)
+  // Description: Replaces the inventory with counts (laid out as by
+  //              GetInventory), telling the craft index only about the
+  //              items whose count changes.
+  // Preconditions: counts is indexed by the hero's registry ids.
+  // Postconditions: The inventory is counts; counts holds the old one.
+  void RestoreInventory(vector<int>& counts);
+  // Name: CanCraft(const Item& item, int count)
+  // Description: Checks every ingredient against count crafts of item,
+  //              honouring ingredients listed more than once.
+  // Preconditions: count >= 1.
+  // Postconditions: Returns true if every need x count is held.
+  bool CanCraft(const Item& item, int count) const;
+  // Name: MaxCraftable(const Item& item) const
+  // Description: Largest batch of item the inventory allows, worked out
+  //              in 64-bit so every need x batch and the product's new
+  //              count still fit in an int.
+  // Preconditions: None.
+  // Postconditions: Returns 0..MAX_CRAFT_BATCH.
+  int MaxCraftable(const Item& item) const;
+  // Name: Craft(const Item& item, int count)
+  // Description: Crafts count of item in one pass: consumes every need
+  //              x count and adds count results.
+  // Preconditions: None (the batch is checked first).
+  // Postconditions: Returns false and changes nothing if count is over
+  //                 MaxCraftable; otherwise prints the result.
+  bool Craft(const Item& item, int count);
   // Name: Raw()
   // Description: Simulates mining for raw materials. Passes values
   //              and calls Gather function.
-  // Preconditions: Random number generator seeded.
+  // Preconditions: None.
   // Postconditions: Possibly adds a random raw material
-  //                 to inventory or reports none found.
-  void Raw();
+  //                 to inventory or reports none found. Returns the
+  //                 item found or NO_ITEM.
+  ItemId Raw();
   // Name: Natural()
   // Description: Simulates foraging for natural resources. Passes values
   //              and calls Gather function.
-  // Preconditions: Random number generator seeded.
+  // Preconditions: None.
   // Postconditions: Possibly adds a random natural resource
-  //                 or reports none found.
-  void Natural();
+  //                 or reports none found. Returns the item or NO_ITEM.
+  ItemId Natural();
   // Name: Food()
   // Description: Simulates gathering food items. Passes values
   //              and calls Gather function.
-  // Preconditions: Random number generator seeded.
+  // Preconditions: None.
   // Postconditions: Possibly adds a random food item or reports none found.
-  void Food();
+  //                 Returns the item or NO_ITEM.
+  ItemId Food();
   // Name: Hunt()
   // Description: Simulates hunting for creature drops. Passes values
   //              and calls Gather function.
-  // Preconditions: Random number generator seeded.
+  // Preconditions: None.
   // Postconditions: Possibly adds a random creature drop
-  //                 or reports none found.
-  void Hunt();
+  //                 or reports none found. Returns the item or NO_ITEM.
+  ItemId Hunt();
 private:
+  // Name: AddCount(ItemId item, int delta)
+  // Description: Changes the count of item and tells the craft index.
+  // Preconditions: delta > 0, or the hero holds at least -delta.
+  // Postconditions: item is marked as held; its count moves by delta.
+  void AddCount(ItemId item, int delta);
   // Name: Gather
   // Description: Randomly selects an item from vector products passed.
   //              If selection equals list size, prints 'noItemMsg';
   //              otherwise prints foundMsg + item and adds it
   //              to the hero's inventory.
-  // Preconditions: 'products' must contain valid item names.
+  // Preconditions: 'products' must contain valid item ids.
   // Postconditions: Inventory is incremented for the selected
-  //               item if found; message printed.
-  void Gather(const vector<string>& products, const string& noItemMsg,
+  //               item if found; message printed. Returns the item
+  //               found or NO_ITEM.
+  ItemId Gather(const vector<ItemId>& products, const string& noItemMsg,
               const string& foundMsg);
   string m_name; //Name of the hero
-  Map<string,int> m_inventory; //Inventory of items
+  const ItemRegistry* m_registry; //Names for the ids in m_inventory
+  CraftIndex* m_craftIndex; //Craftable-now index (not owned, may be null)
+  OutputSink* m_out; //Message sink (not owned)
+  Random m_random; //Gathering engine
+  vector<int> m_inventory; //Count per ItemId (-1 = never collected)
 };
 
 #endif
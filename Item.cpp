@@ -1,33 +1,53 @@
 #include "Item.h"
-  // Name: Item(const string& name, const vector<string>& requirements)
-  // Description: Constructs a new Item with the given name and
-  //              a list of crafting requirements.
+#include <utility>
+#include <algorithm>
+  // Name: Item(string name, ItemId id, vector<ItemId> requirements)
+  // Description: Constructs a new Item with the given name, its
+  //              interned id and the ids of its crafting requirements.
   // Preconditions: ‘name’ must be a valid, non-empty string;
-  //                ‘requirements’ must contain valid item names.
-  // Postconditions: m_name is initialized to name;
-  //                 m_req is initialized to a copy of requirements.
-Item::Item(const string& name, const vector<string>& requirements) {
-    m_name = name;
-
-    for (unsigned long i = 0; i < requirements.size(); i++) {
-        //If there exists requirement, then append it to m_req
-        if (requirements[i] != "None") {
-            m_req.push_back(requirements[i]);
+  //                ‘id’ and ‘requirements’ come from the same ItemRegistry.
+  // Postconditions: m_name takes over name; m_id is set;
+  //                 m_req takes over requirements; m_needs holds them
+  //                 grouped with their multiplicities.
+Item::Item(string name, ItemId id, vector<ItemId> requirements)
+    : m_name(std::move(name)), m_id(id), m_req(std::move(requirements)) {
+    //Group repeated ingredients into one need each
+    vector<ItemId> sorted(m_req);
+    sort(sorted.begin(), sorted.end());
+    for (unsigned long i = 0; i < sorted.size(); i++) {
+        if (m_needs.empty() || m_needs.back().m_item != sorted[i]) {
+            m_needs.push_back(ItemNeed{sorted[i], 0});
         }
+        m_needs.back().m_count++;
     }
 }
   // Name: GetName()
   // Description: Retrieves the name of this item.
   // Preconditions: None.
-  // Postconditions: Returns the value of m_name.
-string Item::GetName() const {
+  // Postconditions: Returns a const reference to m_name.
+const string& Item::GetName() const {
     return m_name;
+}
+  // Name: GetID()
+  // Description: Retrieves the interned id of this item.
+  // Preconditions: None.
+  // Postconditions: Returns m_id.
+ItemId Item::GetID() const {
+    return m_id;
 }
   // Name: GetReq()
   // Description: Retrieves the list of crafting requirements for this item.
   // Preconditions: None.
   // Postconditions: Returns a const reference to m_req
-  //                 (the requirements vector).
-const vector<string>& Item::GetReq() const {
+  //                 (the requirement ids).
+const vector<ItemId>& Item::GetReq() const {
     return m_req;
+}
+  // Name: GetNeeds()
+  // Description: Retrieves the requirements grouped by ingredient (a
+  //              recipe listing Log twice needs two Logs).
+  // Preconditions: None.
+  // Postconditions: Returns a const reference to m_needs, in ItemId order.
+const vector<ItemNeed>& Item::GetNeeds() const {
+    return m_needs;
 }
\ No newline at end of file
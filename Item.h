@@ -2,32 +2,53 @@
 #define ITEM_H
 #include <string>
 #include <vector>
+#include "ItemRegistry.h"
 using namespace std;
 
+//One ingredient of a recipe with its multiplicity
+struct ItemNeed {
+  ItemId m_item; //Ingredient
+  int m_count;   //How many one craft consumes
+};
+
 class Item {
 public:
-  // Name: Item(const string& name, const vector<string>& requirements)
-  // Description: Constructs a new Item with the given name and
-  //              a list of crafting requirements.
+  // Name: Item(string name, ItemId id, vector<ItemId> requirements)
+  // Description: Constructs a new Item with the given name, its
+  //              interned id and the ids of its crafting requirements.
   // Preconditions: ‘name’ must be a valid, non-empty string;
-  //                ‘requirements’ must contain valid item names.
-  // Postconditions: m_name is initialized to name;
-  //                 m_req is initialized to a copy of requirements.
-  Item(const string& name, const vector<string>& requirements);
+  //                ‘id’ and ‘requirements’ come from the same ItemRegistry.
+  // Postconditions: m_name takes over name; m_id is set;
+  //                 m_req takes over requirements; m_needs holds them
+  //                 grouped with their multiplicities.
+  Item(string name, ItemId id, vector<ItemId> requirements);
   // Name: GetName()
   // Description: Retrieves the name of this item.
   // Preconditions: None.
-  // Postconditions: Returns the value of m_name.
-  string GetName() const;
+  // Postconditions: Returns a const reference to m_name.
+  const string& GetName() const;
+  // Name: GetID()
+  // Description: Retrieves the interned id of this item.
+  // Preconditions: None.
+  // Postconditions: Returns m_id.
+  ItemId GetID() const;
   // Name: GetReq()
   // Description: Retrieves the list of crafting requirements for this item.
   // Preconditions: None.
   // Postconditions: Returns a const reference to m_req
-  //                 (the requirements vector).
-  const vector<string>& GetReq() const;
+  //                 (the requirement ids).
+  const vector<ItemId>& GetReq() const;
+  // Name: GetNeeds()
+  // Description: Retrieves the requirements grouped by ingredient (a
+  //              recipe listing Log twice needs two Logs).
+  // Preconditions: None.
+  // Postconditions: Returns a const reference to m_needs, in ItemId order.
+  const vector<ItemNeed>& GetNeeds() const;
 private:
   string m_name;        // Name of item
-  vector<string> m_req; // Requirements by value
+  ItemId m_id;          // Interned id of item
+  vector<ItemId> m_req; // Requirement ids
+  vector<ItemNeed> m_needs; // Requirements with multiplicities
 };
 
 #endif
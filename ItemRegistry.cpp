@@ -0,0 +1,88 @@
+#include "ItemRegistry.h"
+#include <algorithm>
+
+const uint64_t FNV_OFFSET = 14695981039346656037ULL; //FNV-1a 64-bit basis
+const uint64_t FNV_PRIME = 1099511628211ULL; //FNV-1a 64-bit prime
+
+  // Name: ItemRegistry()
+  // Description: Creates a registry holding the gatherable products.
+  // Preconditions: None.
+  // Postconditions: Every name in the product tables is interned.
+ItemRegistry::ItemRegistry() : m_tableHash(FNV_OFFSET) {
+    const vector<string>* tables[4] = {&RawProducts, &NaturalProducts, &FoodProducts, &HuntProducts};
+    for (int kind = 0; kind < 4; kind++) {
+        for (unsigned long i = 0; i < tables[kind]->size(); i++) {
+            m_products[kind].push_back(Intern((*tables[kind])[i]));
+        }
+    }
+}
+  // Name: Intern(const string& name)
+  // Description: Returns the id for name, registering it if needed. A
+  //              new name is also placed in m_sorted and folded into
+  //              m_tableHash, so the const getters never write.
+  // Preconditions: name is non-empty.
+  // Postconditions: name is registered; returns its id.
+ItemId ItemRegistry::Intern(const string& name) {
+    //New names get the next dense id; one hash probe either way
+    ItemId next = static_cast<ItemId>(m_names.size());
+    ItemId id = m_ids.FindOrInsert(name, next);
+    if (id == next) {
+        m_names.push_back(name);
+        const vector<string>& names = m_names;
+        m_sorted.insert(upper_bound(m_sorted.begin(), m_sorted.end(), id,
+                                    [&names](ItemId a, ItemId b) { return names[a] < names[b]; }),
+                        id);
+        //Names end with a 0 byte so "ab","c" and "a","bc" hash differently
+        for (unsigned long i = 0; i <= name.size(); i++) {
+            m_tableHash = (m_tableHash ^ static_cast<uint8_t>(i < name.size() ? name[i] : 0)) * FNV_PRIME;
+        }
+    }
+    return id;
+}
+  // Name: Lookup(const string& name) const
+  // Description: Finds the id for name without registering it.
+  // Preconditions: None.
+  // Postconditions: Returns the id, or NO_ITEM if name is unknown.
+ItemId ItemRegistry::Lookup(const string& name) const {
+    ItemId id = NO_ITEM;
+    m_ids.TryGet(name, id);
+    return id;
+}
+  // Name: GetName(ItemId id) const
+  // Description: Maps an id back to its name (for display).
+  // Preconditions: 0 <= id < GetSize().
+  // Postconditions: Returns a const reference to the name.
+const string& ItemRegistry::GetName(ItemId id) const {
+    return m_names[id];
+}
+  // Name: GetSize() const
+  // Description: Reports how many names are registered.
+  // Preconditions: None.
+  // Postconditions: Returns the number of ids handed out.
+int ItemRegistry::GetSize() const {
+    return static_cast<int>(m_names.size());
+}
+  // Name: GetProducts(GatherKind kind) const
+  // Description: Ids of the items a gather action can find, in the same
+  //              order as the matching product table.
+  // Preconditions: kind is a valid GatherKind.
+  // Postconditions: Returns a const reference to the id list.
+const vector<ItemId>& ItemRegistry::GetProducts(GatherKind kind) const {
+    return m_products[kind];
+}
+  // Name: GetSortedIds() const
+  // Description: Every id ordered by name, for key-ordered display.
+  // Preconditions: None.
+  // Postconditions: Returns ids sorted by name (kept current by Intern).
+const vector<ItemId>& ItemRegistry::GetSortedIds() const {
+    return m_sorted;
+}
+  // Name: GetTableHash() const
+  // Description: FNV-1a hash of every name in id order. Saved files
+  //              that store ItemIds record it so they are only read
+  //              back against the same item table.
+  // Preconditions: None.
+  // Postconditions: Returns the hash (kept current by Intern).
+uint64_t ItemRegistry::GetTableHash() const {
+    return m_tableHash;
+}
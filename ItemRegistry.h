@@ -0,0 +1,83 @@
+#ifndef ITEMREGISTRY_H
+#define ITEMREGISTRY_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Map.cpp"
+using namespace std;
+
+//Compact integer handle for an item name (index into the registry)
+typedef int ItemId;
+const ItemId NO_ITEM = -1; //Returned when a name is not registered
+
+//Constants
+//Things that can be found in an area
+const vector<string> RawProducts = {"Copper Ore","Iron Ore","Coal","Gemstone"};
+const vector<string> NaturalProducts = {"Log","Oak Log","Flax","Herb"};
+const vector<string> FoodProducts = {"Raw Fish","Grain","Vegetable","Meat"};
+const vector<string> HuntProducts = {"Bone","Leather","Hide","Claw"};
+
+//Kinds of gathering, indexing the product tables above
+enum GatherKind {GATHER_RAW = 0, GATHER_NATURAL = 1, GATHER_FOOD = 2, GATHER_HUNT = 3};
+
+//Interns every item name (gatherable products, crafted products and
+//ingredients) to a dense ItemId so the rest of the game can compare and
+//index items by integer. Names are only needed for parsing and display.
+//Only Intern writes, so a loaded registry can be shared read-only
+//between threads.
+class ItemRegistry {
+public:
+  // Name: ItemRegistry()
+  // Description: Creates a registry holding the gatherable products.
+  // Preconditions: None.
+  // Postconditions: Every name in the product tables is interned.
+  ItemRegistry();
+  // Name: Intern(const string& name)
+  // Description: Returns the id for name, registering it if needed. A
+  //              new name is also placed in m_sorted and folded into
+  //              m_tableHash, so the const getters never write.
+  // Preconditions: name is non-empty.
+  // Postconditions: name is registered; returns its id.
+  ItemId Intern(const string& name);
+  // Name: Lookup(const string& name) const
+  // Description: Finds the id for name without registering it.
+  // Preconditions: None.
+  // Postconditions: Returns the id, or NO_ITEM if name is unknown.
+  ItemId Lookup(const string& name) const;
+  // Name: GetName(ItemId id) const
+  // Description: Maps an id back to its name (for display).
+  // Preconditions: 0 <= id < GetSize().
+  // Postconditions: Returns a const reference to the name.
+  const string& GetName(ItemId id) const;
+  // Name: GetSize() const
+  // Description: Reports how many names are registered.
+  // Preconditions: None.
+  // Postconditions: Returns the number of ids handed out.
+  int GetSize() const;
+  // Name: GetProducts(GatherKind kind) const
+  // Description: Ids of the items a gather action can find, in the same
+  //              order as the matching product table.
+  // Preconditions: kind is a valid GatherKind.
+  // Postconditions: Returns a const reference to the id list.
+  const vector<ItemId>& GetProducts(GatherKind kind) const;
+  // Name: GetSortedIds() const
+  // Description: Every id ordered by name, for key-ordered display.
+  // Preconditions: None.
+  // Postconditions: Returns ids sorted by name (kept current by Intern).
+  const vector<ItemId>& GetSortedIds() const;
+  // Name: GetTableHash() const
+  // Description: FNV-1a hash of every name in id order. Saved files
+  //              that store ItemIds record it so they are only read
+  //              back against the same item table.
+  // Preconditions: None.
+  // Postconditions: Returns the hash (kept current by Intern).
+  uint64_t GetTableHash() const;
+private:
+  Map<string, ItemId, HashStorage<string, ItemId> > m_ids; //Name -> id
+  vector<string> m_names; //Id -> name
+  vector<ItemId> m_products[4]; //Ids of each product table
+  vector<ItemId> m_sorted; //Ids ordered by name
+  uint64_t m_tableHash; //FNV-1a of every name in id order
+};
+
+#endif
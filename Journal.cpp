@@ -0,0 +1,375 @@
+#include "Journal.h"
+#include "Random.h"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const int MAX_JOURNAL_HEADER = 64; //Longest possible header (bytes)
+
+// Name: ParseHeader(string_view bytes, const ItemRegistry& registry,
+//                   uint64_t& id, uint64_t& start, string& error)
+// Description: Checks a journal header against the item table.
+// Preconditions: bytes starts at the beginning of the file.
+// Postconditions: Returns true and sets id and start (offset of the
+//                 first record); otherwise returns false and sets error.
+static bool ParseHeader(string_view bytes, const ItemRegistry& registry,
+                        uint64_t& id, uint64_t& start, string& error) {
+    const char *in = bytes.data();
+    const char *end = in + bytes.size();
+    if (bytes.size() < sizeof(JOURNAL_MAGIC) || memcmp(in, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        error = "not an action journal";
+        return false;
+    }
+    in += sizeof(JOURNAL_MAGIC);
+    uint64_t version = 0;
+    uint64_t tableSize = 0;
+    uint64_t tableHash = 0;
+    if (!GetVarint(in, end, version) || version != JOURNAL_VERSION) {
+        error = "unsupported journal version " + to_string(version);
+        return false;
+    }
+    if (!GetFixed64(in, end, id) || !GetVarint(in, end, tableSize) || !GetFixed64(in, end, tableHash)) {
+        error = "journal header is truncated";
+        return false;
+    }
+    if (tableSize != static_cast<uint64_t>(registry.GetSize()) || tableHash != registry.GetTableHash()) {
+        error = "journal was recorded with a different craft file";
+        return false;
+    }
+    start = static_cast<uint64_t>(in - bytes.data());
+    return true;
+}
+
+// Name: Where(long offset)
+// Description: Error suffix naming a record's position.
+// Preconditions: None.
+// Postconditions: Returns " (journal byte offset)".
+static string Where(long offset) {
+    return " (journal byte " + to_string(offset) + ")";
+}
+
+  // Name: Journal()
+  // Description: Creates a journal with no file open.
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false.
+Journal::Journal() : m_fd(-1), m_id(0), m_written(0) {}
+  // Name: ~Journal()
+  // Description: Flushes any held records and closes the file.
+  // Preconditions: None.
+  // Postconditions: The file is closed.
+Journal::~Journal() {
+    string error;
+    if (IsOpen()) {
+        Flush(error);
+    }
+    Close();
+}
+  // Name: Open(const string& path, const ItemRegistry& registry, uint64_t end, string& error)
+  // Description: With end 0, creates a new journal at path (replacing
+  //              any file there) with a fresh id. Otherwise path is an
+  //              existing journal whose last whole record ends at byte
+  //              end (JournalReplayer::GetEnd); anything after that is
+  //              cut off and records are appended from there.
+  // Preconditions: registry is the item table the records refer to.
+  // Postconditions: Returns true with the journal open; otherwise
+  //                 returns false and sets error.
+bool Journal::Open(const string& path, const ItemRegistry& registry, uint64_t end, string& error) {
+    Close();
+    m_path = path;
+    m_held.clear();
+    if (end == 0) {
+        m_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (m_fd < 0) {
+            error = "cannot create " + path;
+            return false;
+        }
+        //Any id will do as long as two journals are unlikely to share it
+        Random random(static_cast<uint64_t>(chrono::system_clock::now().time_since_epoch().count()));
+        m_id = random.Next() | 1;
+        char header[MAX_JOURNAL_HEADER];
+        char *out = header;
+        memcpy(out, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        out += sizeof(JOURNAL_MAGIC);
+        out = PutVarint(out, JOURNAL_VERSION);
+        out = PutFixed64(out, m_id);
+        out = PutVarint(out, static_cast<uint64_t>(registry.GetSize()));
+        out = PutFixed64(out, registry.GetTableHash());
+        m_written = 0;
+        m_held.assign(header, out);
+        return Flush(error);
+    }
+    m_fd = open(path.c_str(), O_RDWR | O_APPEND);
+    if (m_fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    char header[MAX_JOURNAL_HEADER];
+    ssize_t size = pread(m_fd, header, sizeof(header), 0);
+    uint64_t start = 0;
+    if (size < 0 || !ParseHeader(string_view(header, static_cast<size_t>(size)), registry, m_id, start, error)) {
+        error = size < 0 ? "cannot read " + path : error;
+        Close();
+        return false;
+    }
+    struct stat info;
+    if (end < start || fstat(m_fd, &info) != 0 || end > static_cast<uint64_t>(info.st_size)) {
+        error = "journal " + path + " changed while it was being replayed";
+        Close();
+        return false;
+    }
+    //Drop a record a crash left half written
+    if (end < static_cast<uint64_t>(info.st_size) && ftruncate(m_fd, static_cast<off_t>(end)) != 0) {
+        error = "cannot truncate " + path;
+        Close();
+        return false;
+    }
+    m_written = end;
+    return true;
+}
+  // Name: IsOpen() const
+  // Description: Reports whether records can be appended.
+  // Preconditions: None.
+  // Postconditions: Returns true after a successful Open.
+bool Journal::IsOpen() const {
+    return m_fd >= 0;
+}
+  // Name: GetMark() const
+  // Description: The journal id and the offset just past the last
+  //              recorded action, for the next snapshot.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the mark (held records included).
+JournalMark Journal::GetMark() const {
+    JournalMark mark;
+    mark.m_id = m_id;
+    mark.m_offset = m_written + m_held.size();
+    return mark;
+}
+  // Name: RecordMove(int area)
+  // Description: Records that the hero is now in area.
+  // Preconditions: IsOpen().
+  // Postconditions: The record is held until Flush.
+void Journal::RecordMove(int area) {
+    char record[1 + MAX_VARINT_BYTES];
+    record[0] = JOURNAL_MOVE;
+    char *out = PutVarint(record + 1, static_cast<uint64_t>(area));
+    m_held.append(record, out);
+}
+  // Name: RecordGather(GatherKind kind, ItemId item)
+  // Description: Records a gather and what it found (NO_ITEM = nothing).
+  // Preconditions: IsOpen().
+  // Postconditions: The record is held until Flush.
+void Journal::RecordGather(GatherKind kind, ItemId item) {
+    char record[1 + 2 * MAX_VARINT_BYTES];
+    record[0] = JOURNAL_GATHER;
+    char *out = PutVarint(record + 1, static_cast<uint64_t>(kind));
+    out = PutVarint(out, static_cast<uint64_t>(item + 1));
+    m_held.append(record, out);
+}
+  // Name: RecordCraft(ItemId item, int count)
+  // Description: Records a batch of count of item that was crafted.
+  // Preconditions: IsOpen().
+  // Postconditions: The record is held until Flush.
+void Journal::RecordCraft(ItemId item, int count) {
+    char record[1 + 2 * MAX_VARINT_BYTES];
+    record[0] = JOURNAL_CRAFT;
+    char *out = PutVarint(record + 1, static_cast<uint64_t>(item));
+    out = PutVarint(out, static_cast<uint64_t>(count));
+    m_held.append(record, out);
+}
+  // Name: RecordName(const string& name)
+  // Description: Records a rename.
+  // Preconditions: IsOpen().
+  // Postconditions: The record is held until Flush.
+void Journal::RecordName(const string& name) {
+    char record[1 + MAX_VARINT_BYTES];
+    record[0] = JOURNAL_NAME;
+    char *out = PutVarint(record + 1, name.size());
+    m_held.append(record, out);
+    m_held.append(name);
+}
+  // Name: RecordRestore(string_view snapshot)
+  // Description: Records that the session was replaced by a snapshot.
+  // Preconditions: IsOpen(); snapshot was built by a SnapshotStore.
+  // Postconditions: The record is held until Flush.
+void Journal::RecordRestore(string_view snapshot) {
+    char record[1 + MAX_VARINT_BYTES];
+    record[0] = JOURNAL_RESTORE;
+    char *out = PutVarint(record + 1, snapshot.size());
+    m_held.append(record, out);
+    m_held.append(snapshot.data(), snapshot.size());
+}
+  // Name: Flush(string& error)
+  // Description: Appends the held records to the file.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns false and sets error if the write failed.
+bool Journal::Flush(string& error) {
+    size_t done = 0;
+    while (done < m_held.size()) {
+        ssize_t written = write(m_fd, m_held.data() + done, m_held.size() - done);
+        if (written <= 0) {
+            //Keep what was not written; the next Flush tries again
+            m_held.erase(0, done);
+            m_written += done;
+            error = "cannot write " + m_path;
+            return false;
+        }
+        done += static_cast<size_t>(written);
+    }
+    m_written += done;
+    m_held.clear();
+    return true;
+}
+  // Name: Close()
+  // Description: Closes the file (held records are dropped).
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false.
+void Journal::Close() {
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+    m_fd = -1;
+    m_held.clear();
+}
+
+  // Name: JournalReplayer(const ItemRegistry& registry, const vector<Item*>& items, int areaCount)
+  // Description: Creates a replayer for sessions on a map of areaCount
+  //              areas with items as the recipes.
+  // Preconditions: registry, items outlive the replayer.
+  // Postconditions: No journal is open.
+JournalReplayer::JournalReplayer(const ItemRegistry& registry, const vector<Item*>& items, int areaCount)
+    : m_registry(&registry), m_recipes(registry.GetSize(), nullptr), m_areaCount(areaCount),
+      m_snapshots(registry), m_id(0), m_start(0), m_applied(0), m_end(0), m_torn(false) {
+    //Craft records name the product; find its recipe in O(1)
+    for (unsigned long i = 0; i < items.size(); i++) {
+        m_recipes[items[i]->GetID()] = items[i];
+    }
+}
+  // Name: Open(const string& path, string& error)
+  // Description: Maps a journal and checks its header against the
+  //              item table.
+  // Preconditions: None.
+  // Postconditions: Returns true if the journal can be replayed;
+  //                 otherwise returns false and sets error.
+bool JournalReplayer::Open(const string& path, string& error) {
+    if (!m_file.Open(path)) {
+        error = "cannot open " + path;
+        return false;
+    }
+    return ParseHeader(m_file.View(), *m_registry, m_id, m_start, error);
+}
+  // Name: GetId() const
+  // Description: Id of the open journal.
+  // Preconditions: Open succeeded.
+  // Postconditions: Returns the id.
+uint64_t JournalReplayer::GetId() const {
+    return m_id;
+}
+  // Name: GetStart() const
+  // Description: Offset of the first record.
+  // Preconditions: Open succeeded.
+  // Postconditions: Returns the header size.
+uint64_t JournalReplayer::GetStart() const {
+    return m_start;
+}
+  // Name: Replay(uint64_t from, long long limit, Hero& hero, int& area, string& error)
+  // Description: Applies the records starting at byte from, at most
+  //              limit of them (0 = all), to hero and area.
+  // Preconditions: Open succeeded; hero uses the item table; the hero's
+  //                output should be a NullSink (crafts print).
+  // Postconditions: Returns true when the records ran out (or limit was
+  //                 reached); GetApplied and GetEnd describe the run.
+  //                 Returns false and sets error on a record that is
+  //                 bad or does not fit the session.
+bool JournalReplayer::Replay(uint64_t from, long long limit, Hero& hero, int& area, string& error) {
+    string_view bytes = m_file.View();
+    m_applied = 0;
+    m_end = from;
+    m_torn = false;
+    if (from < m_start || from > bytes.size()) {
+        error = "journal has no record at byte " + to_string(from);
+        return false;
+    }
+    uint64_t itemCount = static_cast<uint64_t>(m_registry->GetSize());
+    const char *in = bytes.data() + from;
+    const char *end = bytes.data() + bytes.size();
+    while (in < end && (limit <= 0 || m_applied < limit)) {
+        const char *record = in;
+        int tag = static_cast<uint8_t>(*in++);
+        uint64_t first = 0;
+        uint64_t second = 0;
+        //Every record has at least one varint; gathers and crafts have two
+        bool whole = GetVarint(in, end, first)
+            && ((tag != JOURNAL_GATHER && tag != JOURNAL_CRAFT) || GetVarint(in, end, second))
+            && ((tag != JOURNAL_NAME && tag != JOURNAL_RESTORE) || first <= static_cast<uint64_t>(end - in));
+        if (!whole) {
+            //A partial record can only be the last one; stop before it
+            m_torn = true;
+            return true;
+        }
+        if (tag == JOURNAL_MOVE) {
+            if (first >= static_cast<uint64_t>(m_areaCount)) {
+                error = "area " + to_string(first) + " is not on this map" + Where(record - bytes.data());
+                return false;
+            }
+            area = static_cast<int>(first);
+        } else if (tag == JOURNAL_GATHER) {
+            if (first > GATHER_HUNT || second > itemCount) {
+                error = "bad gather record" + Where(record - bytes.data());
+                return false;
+            }
+            if (second > 0) {
+                hero.CollectItem(static_cast<ItemId>(second - 1));
+            }
+        } else if (tag == JOURNAL_CRAFT) {
+            if (first >= itemCount || m_recipes[first] == nullptr || second < 1 || second > MAX_CRAFT_BATCH) {
+                error = "bad craft record" + Where(record - bytes.data());
+                return false;
+            }
+            if (!hero.Craft(*m_recipes[first], static_cast<int>(second))) {
+                error = "cannot craft " + m_registry->GetName(static_cast<ItemId>(first)) + Where(record - bytes.data());
+                return false;
+            }
+        } else if (tag == JOURNAL_NAME) {
+            hero.SetName(string(in, first));
+            in += first;
+        } else if (tag == JOURNAL_RESTORE) {
+            JournalMark mark;
+            if (!m_snapshots.Decode(string_view(in, first), m_areaCount, hero, area, mark, error)) {
+                error += Where(record - bytes.data());
+                return false;
+            }
+            in += first;
+        } else {
+            error = "unknown record " + to_string(tag) + Where(record - bytes.data());
+            return false;
+        }
+        m_applied++;
+        m_end = static_cast<uint64_t>(in - bytes.data());
+    }
+    return true;
+}
+  // Name: GetApplied() const
+  // Description: Records applied by the last Replay.
+  // Preconditions: None.
+  // Postconditions: Returns the count.
+long long JournalReplayer::GetApplied() const {
+    return m_applied;
+}
+  // Name: GetEnd() const
+  // Description: Offset just past the last record the last Replay
+  //              applied (where appending may resume).
+  // Preconditions: None.
+  // Postconditions: Returns the offset.
+uint64_t JournalReplayer::GetEnd() const {
+    return m_end;
+}
+  // Name: IsTorn() const
+  // Description: Reports whether the last Replay stopped at an
+  //              incomplete record at the end of the file.
+  // Preconditions: None.
+  // Postconditions: Returns true if it did.
+bool JournalReplayer::IsTorn() const {
+    return m_torn;
+}
@@ -0,0 +1,196 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Hero.h"
+#include "Item.h"
+#include "ItemRegistry.h"
+#include "MappedFile.h"
+#include "Snapshot.h"
+using namespace std;
+
+//Action journal: an append-only binary log of every action that changes
+//a session, so it can be audited or rebuilt. Gathers record what the
+//random draw found, so a replay applies outcomes directly: it needs no
+//random engine and prints nothing. Each snapshot records the journal id
+//and how many journal bytes it already includes (a JournalMark), so a
+//session resumes from the snapshot plus the records after it.
+//
+//  char    magic[4]     JOURNAL_MAGIC
+//  varint  version      JOURNAL_VERSION
+//  uint64  id           Random id that snapshots refer to (little-endian)
+//  varint  itemCount    Item table the ItemIds belong to (as in snapshots)
+//  uint64  tableHash
+//then one record per action, a tag byte followed by varints:
+//  JOURNAL_MOVE     area                    the hero is now in area
+//  JOURNAL_GATHER   kind, item + 1          what a gather found (0 = nothing)
+//  JOURNAL_CRAFT    item, count             a batch that was crafted
+//  JOURNAL_NAME     length, name bytes      the hero was renamed
+//  JOURNAL_RESTORE  length, snapshot bytes  a snapshot was loaded
+//A new journal starts with a restore record of the hero it begins with.
+//A crash can leave part of a record at the end; replay stops before it
+//and Open cuts it off before appending.
+
+const char JOURNAL_MAGIC[4] = {'C', 'Q', 'J', 'L'};
+const uint32_t JOURNAL_VERSION = 1;
+
+//Record tags
+enum JournalTag {
+  JOURNAL_MOVE = 1,
+  JOURNAL_GATHER = 2,
+  JOURNAL_CRAFT = 3,
+  JOURNAL_NAME = 4,
+  JOURNAL_RESTORE = 5
+};
+
+//Writes records to the end of a journal file. Records collect in memory
+//and are written with one system call per Flush (the game flushes after
+//every command).
+class Journal {
+public:
+  // Name: Journal()
+  // Description: Creates a journal with no file open.
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false.
+  Journal();
+  // Name: ~Journal()
+  // Description: Flushes any held records and closes the file.
+  // Preconditions: None.
+  // Postconditions: The file is closed.
+  ~Journal();
+  // Name: Open(const string& path, const ItemRegistry& registry, uint64_t end, string& error)
+  // Description: With end 0, creates a new journal at path (replacing
+  //              any file there) with a fresh id. Otherwise path is an
+  //              existing journal whose last whole record ends at byte
+  //              end (JournalReplayer::GetEnd); anything after that is
+  //              cut off and records are appended from there.
+  // Preconditions: registry is the item table the records refer to.
+  // Postconditions: Returns true with the journal open; otherwise
+  //                 returns false and sets error.
+  bool Open(const string& path, const ItemRegistry& registry, uint64_t end, string& error);
+  // Name: IsOpen() const
+  // Description: Reports whether records can be appended.
+  // Preconditions: None.
+  // Postconditions: Returns true after a successful Open.
+  bool IsOpen() const;
+  // Name: GetMark() const
+  // Description: The journal id and the offset just past the last
+  //              recorded action, for the next snapshot.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the mark (held records included).
+  JournalMark GetMark() const;
+  // Name: RecordMove(int area)
+  // Description: Records that the hero is now in area.
+  // Preconditions: IsOpen().
+  // Postconditions: The record is held until Flush.
+  void RecordMove(int area);
+  // Name: RecordGather(GatherKind kind, ItemId item)
+  // Description: Records a gather and what it found (NO_ITEM = nothing).
+  // Preconditions: IsOpen().
+  // Postconditions: The record is held until Flush.
+  void RecordGather(GatherKind kind, ItemId item);
+  // Name: RecordCraft(ItemId item, int count)
+  // Description: Records a batch of count of item that was crafted.
+  // Preconditions: IsOpen().
+  // Postconditions: The record is held until Flush.
+  void RecordCraft(ItemId item, int count);
+  // Name: RecordName(const string& name)
+  // Description: Records a rename.
+  // Preconditions: IsOpen().
+  // Postconditions: The record is held until Flush.
+  void RecordName(const string& name);
+  // Name: RecordRestore(string_view snapshot)
+  // Description: Records that the session was replaced by a snapshot.
+  // Preconditions: IsOpen(); snapshot was built by a SnapshotStore.
+  // Postconditions: The record is held until Flush.
+  void RecordRestore(string_view snapshot);
+  // Name: Flush(string& error)
+  // Description: Appends the held records to the file.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns false and sets error if the write failed.
+  bool Flush(string& error);
+private:
+  // Name: Close()
+  // Description: Closes the file (held records are dropped).
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false.
+  void Close();
+  int m_fd; //Journal file (-1 = closed)
+  string m_path; //Journal file name, for errors
+  uint64_t m_id; //Journal id from the header
+  uint64_t m_written; //Bytes in the file
+  string m_held; //Records not yet written
+};
+
+//Rebuilds a session from a journal. The file is mapped and records are
+//applied straight to a hero: moves set the area, gathers collect the
+//recorded item, crafts run Hero::Craft (which checks that the journal
+//still matches the inventory) and restores decode the snapshot.
+class JournalReplayer {
+public:
+  // Name: JournalReplayer(const ItemRegistry& registry, const vector<Item*>& items, int areaCount)
+  // Description: Creates a replayer for sessions on a map of areaCount
+  //              areas with items as the recipes.
+  // Preconditions: registry, items outlive the replayer.
+  // Postconditions: No journal is open.
+  JournalReplayer(const ItemRegistry& registry, const vector<Item*>& items, int areaCount);
+  // Name: Open(const string& path, string& error)
+  // Description: Maps a journal and checks its header against the
+  //              item table.
+  // Preconditions: None.
+  // Postconditions: Returns true if the journal can be replayed;
+  //                 otherwise returns false and sets error.
+  bool Open(const string& path, string& error);
+  // Name: GetId() const
+  // Description: Id of the open journal.
+  // Preconditions: Open succeeded.
+  // Postconditions: Returns the id.
+  uint64_t GetId() const;
+  // Name: GetStart() const
+  // Description: Offset of the first record.
+  // Preconditions: Open succeeded.
+  // Postconditions: Returns the header size.
+  uint64_t GetStart() const;
+  // Name: Replay(uint64_t from, long long limit, Hero& hero, int& area, string& error)
+  // Description: Applies the records starting at byte from, at most
+  //              limit of them (0 = all), to hero and area.
+  // Preconditions: Open succeeded; hero uses the item table; the hero's
+  //                output should be a NullSink (crafts print).
+  // Postconditions: Returns true when the records ran out (or limit was
+  //                 reached); GetApplied and GetEnd describe the run.
+  //                 Returns false and sets error on a record that is
+  //                 bad or does not fit the session.
+  bool Replay(uint64_t from, long long limit, Hero& hero, int& area, string& error);
+  // Name: GetApplied() const
+  // Description: Records applied by the last Replay.
+  // Preconditions: None.
+  // Postconditions: Returns the count.
+  long long GetApplied() const;
+  // Name: GetEnd() const
+  // Description: Offset just past the last record the last Replay
+  //              applied (where appending may resume).
+  // Preconditions: None.
+  // Postconditions: Returns the offset.
+  uint64_t GetEnd() const;
+  // Name: IsTorn() const
+  // Description: Reports whether the last Replay stopped at an
+  //              incomplete record at the end of the file.
+  // Preconditions: None.
+  // Postconditions: Returns true if it did.
+  bool IsTorn() const;
+private:
+  const ItemRegistry* m_registry; //Item table the records refer to
+  vector<const Item*> m_recipes; //Recipe per ItemId (nullptr = none)
+  int m_areaCount; //Areas on the map
+  SnapshotStore m_snapshots; //Decodes restore records
+  MappedFile m_file; //The journal
+  uint64_t m_id; //Journal id
+  uint64_t m_start; //Offset of the first record
+  long long m_applied; //Records applied by the last Replay
+  uint64_t m_end; //Offset after the last applied record
+  bool m_torn; //Last Replay stopped at a partial record
+};
+
+#endif
@@ -3,21 +3,30 @@
 
 #include <iostream>
 #include <stdexcept>
-#include "Node.cpp"
+#include <utility>
+#include "MapStorage.cpp"
 using namespace std;
 
-template <typename K, typename V>
+//Map is an ordered key/value container whose storage is chosen by the
+//third template parameter (see MapStorage.cpp):
+//  Map<K,V>                          - sorted linked list (default),
+//                                      nodes drawn from a PoolAllocator
+//  Map<K,V,FlatStorage<K,V> >        - sorted contiguous vector
+//  Map<K,V,HashStorage<K,V> >        - open-addressing hash table
+//  Map<K,V,BTreeStorage<K,V> >       - B-tree
+//All storages keep the same public API and key-ordered output.
+template <typename K, typename V, typename S = ListStorage<K,V> >
 class Map {
 public:
   // Name: Map()
   // Description: Default constructs an empty map.
   // Preconditions: None.
-  // Postconditions: m_head is set to nullptr; m_size is initialized to 0.
+  // Postconditions: m_storage is empty.
   Map();
   // Name: ~Map()
   // Description: Destroys the map, freeing all nodes.
   // Preconditions: None.
-  // Postconditions: All nodes are deleted; m_head is nullptr; m_size is 0.
+  // Postconditions: All nodes are deleted; the map is empty.
   ~Map();
   // Name: Map(const Map& other)
   // Description: Copy constructor; deep copies another map’s contents.
@@ -28,14 +37,36 @@ public:
   // Description: Assignment operator; clears this map and deep copies other.
   // Preconditions: other is a valid Map<K,V>; self-assignment is handled.
   // Postconditions: This map contains a copy of other’s elements.
-  Map<K,V>& operator=(const Map& other);
+  Map<K,V,S>& operator=(const Map& other);
+  // Name: Map(Map&& other)
+  // Description: Move constructor; takes over other's nodes without
+  //              copying any of them.
+  // Preconditions: None.
+  // Postconditions: This map holds other's former contents;
+  //                 other is empty.
+  Map(Map&& other);
+  // Name: operator=(Map&& other)
+  // Description: Move assignment; frees this map's nodes and takes
+  //              over other's.
+  // Preconditions: None; self-assignment is handled.
+  // Postconditions: This map holds other's former contents;
+  //                 other is empty.
+  Map<K,V,S>& operator=(Map&& other);
   // Name: Insert(const K& key, const V& value)
   // Description: Inserts or updates a key → value pair, keeping
   //              nodes ordered by key.
   // Preconditions: key and value are valid; map may be empty.
   // Postconditions: New node inserted at sorted position, or
-  //                 existing node’s value updated; m_size adjusted.
+  //                 existing node’s value updated; size grows only
+  //                 when a new key is added.
   void Insert(const K& key, const V& value);
+  // Name: Insert(K&& key, V&& value)
+  // Description: As Insert above, but moves key and value into the node
+  //              instead of copying them.
+  // Preconditions: key and value may be left in a moved-from state.
+  // Postconditions: New node inserted at sorted position, or
+  //                 existing node’s value replaced.
+  void Insert(K&& key, V&& value);
   // Name: Update(const K& key, const V& value)
   // Description: Changes the value for an existing key.
   // Preconditions: key must exist in the map.
@@ -53,35 +84,72 @@ public:
   // Preconditions: key must exist in the map.
   // Postconditions: Returns pointer to the Node<K,V>;
   //                 throws out_of_range if not found.
+  // Note: For the flat, hash and B-tree storages the pointer is only
+  //       valid until the next insertion.
   Node<K,V>* At(const K& key) const;
+  // Name: Find(const K& key) const
+  // Description: Non-throwing lookup of the node for key.
+  // Preconditions: None.
+  // Postconditions: Returns pointer to the Node<K,V>, or nullptr if
+  //                 key is not in the map. One traversal.
+  Node<K,V>* Find(const K& key) const;
+  // Name: TryGet(const K& key, V& value) const
+  // Description: Non-throwing lookup that copies the value out.
+  // Preconditions: None.
+  // Postconditions: Returns true and sets value if key exists;
+  //                 returns false and leaves value untouched otherwise.
+  bool TryGet(const K& key, V& value) const;
+  // Name: FindOrInsert(const K& key, const V& initial)
+  // Description: Upsert helper; returns the value for key, inserting
+  //              initial first if key is missing. One traversal.
+  // Preconditions: None.
+  // Postconditions: key exists in the map; returns a reference to its
+  //                 value (valid under the same rules as At).
+  V& FindOrInsert(const K& key, const V& initial);
+  // Name: operator[](const K& key)
+  // Description: Returns the value for key, inserting a
+  //              default-constructed value if key is missing.
+  // Preconditions: V is default constructible.
+  // Postconditions: key exists in the map; returns a reference to its value.
+  V& operator[](const K& key);
+  // Name: Add(const K& key, const V& delta)
+  // Description: Counter update; adds delta to the value for key,
+  //              starting from V() if key is missing. One traversal.
+  // Preconditions: V supports +=.
+  // Postconditions: key exists in the map; returns its new value.
+  V Add(const K& key, const V& delta);
   // Name: GetSize() const
   // Description: Reports the number of key‑value pairs in the map.
   // Preconditions: None.
-  // Postconditions: Returns the value of m_size.
+  // Postconditions: Returns the number of stored nodes.
   int GetSize() const;
   // Name: IsEmpty() const
   // Description: Checks whether the map contains no elements.
   // Preconditions: None.
-  // Postconditions: Returns true if m_size == 0
-  //                 (m_head == nullptr); false otherwise.
+  // Postconditions: Returns true if the map holds no nodes;
+  //                 false otherwise.
   bool IsEmpty() const;
   // Name: Display() const
   // Description: Prints each key:value pair to cout, one per line.
   // Preconditions: ostream cout is available.
   // Postconditions: Map contents are written to standard output.
   void Display() const;
+  // Name: GetStorage() const
+  // Description: Gives read access to the storage policy, e.g. to read
+  //              ListStorage's allocator stats.
+  // Preconditions: None.
+  // Postconditions: Returns m_storage.
+  const S& GetStorage() const;
   // Name: operator<<
   // Description: Streams all key:value pairs into os, one per line.
   // Preconditions: os is a valid ostream; map is a valid Map<K,V>.
   // Postconditions: os contains serialized map contents;
   //                returns os by reference.
   // PROVIDED
-  friend ostream& operator<<(ostream& os, const Map<K, V>& map){
-    Node<K,V>* current = map.m_head;
-    while (current != nullptr) {
-      os << current->GetKey() << ":" << current->GetValue() << endl;
-      current = current->GetNext();
-    }
+  friend ostream& operator<<(ostream& os, const Map<K, V, S>& map){
+    map.m_storage.ForEach([&os](const Node<K,V>& current) {
+      os << current.GetKey() << ":" << current.GetValue() << endl;
+    });
     return os;
   }
 private:
@@ -90,10 +158,9 @@ private:
   //              freeing their memory and resetting the map.
   // Preconditions: None.
   // Postconditions: All dynamically allocated nodes are deleted;
-  //                 m_head is set to nullptr; m_size is reset to 0.
+  //                 the map is empty.
   void Clear();
-  Node<K,V>* m_head; //Pointer to the first node in the Map
-  int m_size; //Tracks the size of the Map (number of nodes)
+  S m_storage; //Storage policy holding the nodes
 };
 #endif
 //********IMPLEMENT MAP.CPP HERE DUE TO TEMPLATED CLASS*********
@@ -101,169 +168,185 @@ private:
   // Name: Map()
   // Description: Default constructs an empty map.
   // Preconditions: None.
-  // Postconditions: m_head is set to nullptr; m_size is initialized to 0.
-template<typename K, typename V>
-Map<K, V>::Map() : m_head(nullptr), m_size(0) {}
+  // Postconditions: m_storage is empty.
+template<typename K, typename V, typename S>
+Map<K, V, S>::Map() {}
   // Name: Insert(const K& key, const V& value)
   // Description: Inserts or updates a key → value pair, keeping
   //              nodes ordered by key.
   // Preconditions: key and value are valid; map may be empty.
   // Postconditions: New node inserted at sorted position, or
-  //                 existing node’s value updated; m_size adjusted.
-template<typename K, typename V>
-void Map<K, V>::Insert(const K& key, const V& value) {
-    // If map is empty, create a new node as the first element.
-    if (m_size == 0) {
-        Node<K, V> *newNode = new Node<K, V>(key, value);
-        m_head = newNode; 
-    } else if (m_size == 1) {  // If there's only one node, we need to decide where to insert.
-        Node<K, V> *curr = m_head;
-        if (curr->GetKey() < key) { // Insert after the current node if key is larger.
-            Node<K, V> *newNode = new Node<K, V>(key, value);
-            curr->SetNext(newNode);
-        } else {  // Insert before the current node if key is smaller.
-            Node<K, V> *newNode = new Node<K, V>(key, value);
-            newNode->SetNext(m_head);
-            m_head = newNode;
-        }
-        // For more than one node, search for key and insert at the correct position.
-    } else {
-        //Match check
-        bool matchFound = false;
-        
-        Node<K, V>* curr = m_head;
-        while (curr != nullptr) {
-              // If key is found, update its value.
-            if (curr->GetKey() == key) {
-                curr->SetValue(value);
-                matchFound = true;
-            }
-             // Move to the next node.
-            curr = curr->GetNext();
-        }
-         // If no match was found, insert at the correct position.
-        if (!matchFound) {
-            Node<K, V>* curr = m_head;
-            Node<K, V>* prev = m_head;
-            curr = curr->GetNext();
-
-            // Insert before the first node if key is smaller.
-            if (key < prev->GetKey()) {
-                Node<K, V> *newNode = new Node<K, V>(key, value);
-                newNode->SetNext(m_head);
-                m_head = newNode;
-            // Find the right spot in the sorted list.
-            } else {
-                while (curr != nullptr && key > curr->GetKey()) {
-                    curr = curr->GetNext();
-                    prev = prev->GetNext();
-                }
-                Node<K, V> *newNode = new Node<K, V>(key, value);
-                newNode->SetNext(prev->GetNext());
-                prev->SetNext(newNode);
-            }
-        }
+  //                 existing node’s value updated; size grows only
+  //                 when a new key is added.
+template<typename K, typename V, typename S>
+void Map<K, V, S>::Insert(const K& key, const V& value) {
+    bool inserted = false;
+    //Single traversal: either finds the existing node or creates it
+    Node<K, V> *node = m_storage.Emplace(key, value, inserted);
+    //If key already existed, overwrite its value
+    if (!inserted) {
+        node->SetValue(value);
+    }
+}
+  // Name: Insert(K&& key, V&& value)
+  // Description: As Insert above, but moves key and value into the node
+  //              instead of copying them.
+  // Preconditions: key and value may be left in a moved-from state.
+  // Postconditions: New node inserted at sorted position, or
+  //                 existing node’s value replaced.
+template<typename K, typename V, typename S>
+void Map<K, V, S>::Insert(K&& key, V&& value) {
+    bool inserted = false;
+    //value is only consumed by Emplace when a node is created
+    Node<K, V> *node = m_storage.Emplace(std::move(key), std::move(value), inserted);
+    if (!inserted) {
+        node->SetValue(std::move(value));
     }
-    m_size++; 
 }
   // Name: Display() const
   // Description: Prints each key:value pair to cout, one per line.
   // Preconditions: ostream cout is available.
   // Postconditions: Map contents are written to standard output.
-template<typename K, typename V>
-void Map<K, V>::Display() const {
-    Node<K, V> *curr = m_head;
-    while (curr != nullptr) {
+template<typename K, typename V, typename S>
+void Map<K, V, S>::Display() const {
+    m_storage.ForEach([](const Node<K, V>& curr) {
         // Display each key-value pair
-        cout << *curr << " ";
-        // Move to the next node
-        curr = curr->GetNext();
-    }
+        cout << curr << " ";
+    });
     cout << endl;
+}
+  // Name: GetStorage() const
+  // Description: Gives read access to the storage policy, e.g. to read
+  //              ListStorage's allocator stats.
+  // Preconditions: None.
+  // Postconditions: Returns m_storage.
+template<typename K, typename V, typename S>
+const S& Map<K, V, S>::GetStorage() const {
+    return m_storage;
+}
+  // Name: Find(const K& key) const
+  // Description: Non-throwing lookup of the node for key.
+  // Preconditions: None.
+  // Postconditions: Returns pointer to the Node<K,V>, or nullptr if
+  //                 key is not in the map. One traversal.
+template<typename K, typename V, typename S>
+Node<K,V>* Map<K, V, S>::Find(const K& key) const {
+    return m_storage.Find(key);
+}
+  // Name: TryGet(const K& key, V& value) const
+  // Description: Non-throwing lookup that copies the value out.
+  // Preconditions: None.
+  // Postconditions: Returns true and sets value if key exists;
+  //                 returns false and leaves value untouched otherwise.
+template<typename K, typename V, typename S>
+bool Map<K, V, S>::TryGet(const K& key, V& value) const {
+    Node<K, V> *node = m_storage.Find(key);
+    if (node == nullptr) {
+        return false;
+    }
+    value = node->GetValue();
+    return true;
+}
+  // Name: FindOrInsert(const K& key, const V& initial)
+  // Description: Upsert helper; returns the value for key, inserting
+  //              initial first if key is missing. One traversal.
+  // Preconditions: None.
+  // Postconditions: key exists in the map; returns a reference to its
+  //                 value (valid under the same rules as At).
+template<typename K, typename V, typename S>
+V& Map<K, V, S>::FindOrInsert(const K& key, const V& initial) {
+    bool inserted = false;
+    return m_storage.Emplace(key, initial, inserted)->GetValue();
+}
+  // Name: operator[](const K& key)
+  // Description: Returns the value for key, inserting a
+  //              default-constructed value if key is missing.
+  // Preconditions: V is default constructible.
+  // Postconditions: key exists in the map; returns a reference to its value.
+template<typename K, typename V, typename S>
+V& Map<K, V, S>::operator[](const K& key) {
+    return FindOrInsert(key, V());
+}
+  // Name: Add(const K& key, const V& delta)
+  // Description: Counter update; adds delta to the value for key,
+  //              starting from V() if key is missing. One traversal.
+  // Preconditions: V supports +=.
+  // Postconditions: key exists in the map; returns its new value.
+template<typename K, typename V, typename S>
+V Map<K, V, S>::Add(const K& key, const V& delta) {
+    bool inserted = false;
+    //A missing key is created holding delta directly
+    Node<K, V> *node = m_storage.Emplace(key, delta, inserted);
+    if (!inserted) {
+        node->GetValue() += delta;
+    }
+    return node->GetValue();
 }
   // Name: GetSize() const
   // Description: Reports the number of key‑value pairs in the map.
   // Preconditions: None.
-  // Postconditions: Returns the value of m_size.
-template<typename K, typename V>
-int Map<K, V>::GetSize() const {
-    return m_size;
+  // Postconditions: Returns the number of stored nodes.
+template<typename K, typename V, typename S>
+int Map<K, V, S>::GetSize() const {
+    return m_storage.Size();
 }
   // Name: Map(const Map& other)
   // Description: Copy constructor; deep copies another map’s contents.
   // Preconditions: other must be a valid Map<K,V>.
   // Postconditions: This map contains the same key/value pairs, in order.
-template<typename K, typename V>
-Map<K, V>::Map(const Map& other) {
-    //Reset 'this' map to prepare it for copy
-    this->m_head = nullptr;
-    this->m_size = 0;
-    
-    Node<K, V> *curr = other.m_head;
-    // Traverse the other map and insert each element
-    while (curr != nullptr) {
-        //Obtain key and value
-        K key = curr->GetKey();
-        V value = curr->GetValue();
-        this->Insert(key, value);
-        curr = curr->GetNext();
-    }
-}
+template<typename K, typename V, typename S>
+Map<K, V, S>::Map(const Map& other) : m_storage(other.m_storage) {}
   // Name: IsEmpty() const
   // Description: Checks whether the map contains no elements.
   // Preconditions: None.
-  // Postconditions: Returns true if m_size == 0
-  //                 (m_head == nullptr); false otherwise.
-template<typename K, typename V>
-bool Map<K, V>::IsEmpty() const {
-    //If m_head points to null, that means the map is empty
-    if (m_head == nullptr) {
-        return true;
-    }
-    return false;
+  // Postconditions: Returns true if the map holds no nodes;
+  //                 false otherwise.
+template<typename K, typename V, typename S>
+bool Map<K, V, S>::IsEmpty() const {
+    return m_storage.Size() == 0;
 }
   // Name: Clear()
   // Description: Deletes all nodes in the linked list,
   //              freeing their memory and resetting the map.
   // Preconditions: None.
   // Postconditions: All dynamically allocated nodes are deleted;
-  //                 m_head is set to nullptr; m_size is reset to 0.
-template<typename K, typename V>
-void Map<K, V>::Clear() {
-    Node<K, V> *curr = m_head;
-     // Traverse each node and delete it
-    while (curr != nullptr) {
-        m_head = curr;
-        curr = curr->GetNext();
-        // Delete current node
-        delete m_head;
-    }
-    // Reset head pointer
-    m_head = nullptr;
-    // Reset size
-    m_size = 0;
+  //                 the map is empty.
+template<typename K, typename V, typename S>
+void Map<K, V, S>::Clear() {
+    m_storage.Clear();
 }
   // Name: operator=(const Map& other)
   // Description: Assignment operator; clears this map and deep copies other.
   // Preconditions: other is a valid Map<K,V>; self-assignment is handled.
   // Postconditions: This map contains a copy of other’s elements.
-template<typename K, typename V>
-Map<K, V>& Map<K, V>::operator=(const Map<K, V>& other) {
+template<typename K, typename V, typename S>
+Map<K, V, S>& Map<K, V, S>::operator=(const Map<K, V, S>& other) {
     // If assigning to itself, just return the map
     if (this == &other) {
         return *this;
     }
-    // Clear this map before copying
-    if (this->IsEmpty() == false) {
-        this->Clear();
-    }
-    Node<K, V> *curr = other.m_head;
-    // Copy each element from the other map
-    while (curr != nullptr) {
-        K key = curr->GetKey();
-        V value = curr->GetValue();
-        this->Insert(key, value);
-        curr = curr->GetNext();
+    //Storage copies other's nodes in order without re-searching
+    m_storage = other.m_storage;
+    return *this;
+}
+  // Name: Map(Map&& other)
+  // Description: Move constructor; takes over other's nodes without
+  //              copying any of them.
+  // Preconditions: None.
+  // Postconditions: This map holds other's former contents;
+  //                 other is empty.
+template<typename K, typename V, typename S>
+Map<K, V, S>::Map(Map&& other) : m_storage(std::move(other.m_storage)) {}
+  // Name: operator=(Map&& other)
+  // Description: Move assignment; frees this map's nodes and takes
+  //              over other's.
+  // Preconditions: None; self-assignment is handled.
+  // Postconditions: This map holds other's former contents;
+  //                 other is empty.
+template<typename K, typename V, typename S>
+Map<K, V, S>& Map<K, V, S>::operator=(Map<K, V, S>&& other) {
+    if (this != &other) {
+        m_storage = std::move(other.m_storage);
     }
     return *this;
 }
@@ -272,67 +355,44 @@ Map<K, V>& Map<K, V>::operator=(const Map<K, V>& other) {
   // Preconditions: key must exist in the map.
   // Postconditions: Corresponding node’s value is set to
   //                 value; throws out_of_range if key not found.
-template<typename K, typename V>
-void Map<K, V>::Update(const K& key, const V& value) {
-    Node<K, V> *curr = m_head;
-    // Traverse the list and find the key
-    while (curr != nullptr) {
-        if (curr->GetKey() == key) {
-            // Update the value
-            curr->SetValue(value);
-            return;
-        }
-        // Move to the next node
-        curr = curr->GetNext();
+template<typename K, typename V, typename S>
+void Map<K, V, S>::Update(const K& key, const V& value) {
+    Node<K, V> *node = m_storage.Find(key);
+    if (node == nullptr) {
+        // Key wasn't found, throw exception
+        throw out_of_range("Key not found");
     }
-    // Key wasn't found, throw exception
-    throw out_of_range("Key not found");
+    node->SetValue(value);
 }
   // Name: ValueAt(const K& key) const
   // Description: Retrieves a const reference to the value for key.
   // Preconditions: key must exist in the map.
   // Postconditions: Returns reference to the value;
   //                 throws out_of_range if not found.
-template<typename K, typename V>
-const V& Map<K, V>::ValueAt(const K& key) const {
-    Node<K, V> *curr = m_head;
-    // Traverse to find the key
-    while (curr != nullptr) {
-        if (curr->GetKey() == key) {
-            // Return the value if key found
-            return curr->GetValue();
-        }
-        curr = curr->GetNext();
-    }
-    // Key wasn't found, throw exception
-    throw out_of_range("Key not found");
+template<typename K, typename V, typename S>
+const V& Map<K, V, S>::ValueAt(const K& key) const {
+    return At(key)->GetValue();
 }
   // Name: At(const K& key) const
   // Description: Returns a pointer to the node for key.
   // Preconditions: key must exist in the map.
   // Postconditions: Returns pointer to the Node<K,V>;
   //                 throws out_of_range if not found.
-template<typename K, typename V>
-Node<K,V>* Map<K, V>::At(const K& key) const {
-    Node<K, V> *curr = m_head;
-    // Traverse the list to find the key
-    while (curr != nullptr) {
-        if (curr->GetKey() == key) {
-            // Return the pointer to the node
-            return curr;
-        }
-        curr = curr->GetNext();
+template<typename K, typename V, typename S>
+Node<K,V>* Map<K, V, S>::At(const K& key) const {
+    Node<K, V> *node = m_storage.Find(key);
+    if (node == nullptr) {
+        // Key not found, throw exception
+        throw out_of_range("Key not found");
     }
-    // Key not found, throw exception
-    throw out_of_range("Key not found");
+    return node;
 }
   // Name: ~Map()
   // Description: Destroys the map, freeing all nodes.
   // Preconditions: None.
-  // Postconditions: All nodes are deleted; m_head is nullptr; m_size is 0.
-template<typename K, typename V>
-Map<K, V>::~Map() {
+  // Postconditions: All nodes are deleted; the map is empty.
+template<typename K, typename V, typename S>
+Map<K, V, S>::~Map() {
     // Call Clear to free memory
     Clear();
-
 }
@@ -0,0 +1,134 @@
+#include "MapRecord.h"
+#include <charconv>
+#include <stdexcept>
+
+// Name: IsSpace(char c)
+// Description: Whitespace test used when trimming numeric fields.
+// Preconditions: None.
+// Postconditions: Returns true for space, tab, CR and LF.
+static bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Name: ParseInt(string_view field, int& value)
+// Description: Parses a decimal int with from_chars, ignoring
+//              surrounding whitespace (as stoi did for the stream loader).
+// Preconditions: None.
+// Postconditions: Returns true and sets value if field is a number.
+bool ParseInt(string_view field, int& value) {
+    //Trim whitespace (the first field of a record starts after a newline)
+    while (!field.empty() && IsSpace(field.front())) {
+        field.remove_prefix(1);
+    }
+    while (!field.empty() && IsSpace(field.back())) {
+        field.remove_suffix(1);
+    }
+    const char *end = field.data() + field.size();
+    from_chars_result result = from_chars(field.data(), end, value);
+    return result.ec == errc() && result.ptr == end && !field.empty();
+}
+
+// Name: NextField(string_view text, size_t& pos, char delim, string_view& field)
+// Description: Reads the characters from pos up to the next delim.
+// Preconditions: pos <= text.size().
+// Postconditions: Returns false if no delim remains; otherwise sets
+//                 field and moves pos just past the delim.
+bool NextField(string_view text, size_t& pos, char delim, string_view& field) {
+    size_t stop = text.find(delim, pos);
+    if (stop == string_view::npos) {
+        return false;
+    }
+    field = text.substr(pos, stop - pos);
+    pos = stop + 1;
+    return true;
+}
+
+// Name: CountDelimiters(string_view text, char delim)
+// Description: Counts occurrences of delim in text.
+// Preconditions: None.
+// Postconditions: Returns the count.
+size_t CountDelimiters(string_view text, char delim) {
+    size_t count = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        count += text[i] == delim;
+    }
+    return count;
+}
+
+// Name: SkipDelimiters(string_view text, size_t pos, char delim, size_t count)
+// Description: Finds the position just past the count-th delim at or
+//              after pos.
+// Preconditions: pos <= text.size(); count >= 1.
+// Postconditions: Returns that position, or npos if text runs out.
+size_t SkipDelimiters(string_view text, size_t pos, char delim, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        pos = text.find(delim, pos);
+        if (pos == string_view::npos) {
+            return pos;
+        }
+        pos++;
+    }
+    return pos;
+}
+
+// Name: ParseAreaRecord(string_view text, size_t& pos, AreaRecord& record)
+// Description: Parses the next seven fields starting at pos.
+// Preconditions: pos <= text.size().
+// Postconditions: Returns false when no complete record remains;
+//                 throws invalid_argument on a malformed number.
+bool ParseAreaRecord(string_view text, size_t& pos, AreaRecord& record) {
+    string_view fields[7];
+    size_t cursor = pos;
+    for (int i = 0; i < 7; i++) {
+        if (!NextField(text, cursor, '|', fields[i])) {
+            //Trailing newline or a truncated record: nothing more to load
+            return false;
+        }
+    }
+    bool ok = ParseInt(fields[0], record.m_id);
+    for (int i = 0; i < 4; i++) {
+        ok = ParseInt(fields[3 + i], record.m_exits[i]) && ok;
+    }
+    if (!ok) {
+        throw invalid_argument("Malformed number in map file");
+    }
+    record.m_name = fields[1];
+    record.m_desc = fields[2];
+    pos = cursor;
+    return true;
+}
+
+// Name: ParseCraftRecord(string_view text, size_t& pos, CraftRecord& record)
+// Description: Parses the next non-blank line starting at pos.
+// Preconditions: pos <= text.size().
+// Postconditions: Returns false at end of text; otherwise fills record
+//                 (m_reqs is reused, so steady-state parsing does not
+//                 allocate) and moves pos past the line.
+bool ParseCraftRecord(string_view text, size_t& pos, CraftRecord& record) {
+    while (pos < text.size()) {
+        size_t stop = text.find('\n', pos);
+        if (stop == string_view::npos) {
+            stop = text.size();
+        }
+        string_view line = text.substr(pos, stop - pos);
+        pos = stop < text.size() ? stop + 1 : stop;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        //Split the line on '|'; the first field is the product
+        record.m_reqs.clear();
+        size_t cursor = 0;
+        string_view field;
+        if (!NextField(line, cursor, '|', record.m_product)) {
+            //Blank (or delimiter-less) line
+            continue;
+        }
+        while (NextField(line, cursor, '|', field)) {
+            if (!field.empty() && field != "None") {
+                record.m_reqs.push_back(field);
+            }
+        }
+        return true;
+    }
+    return false;
+}
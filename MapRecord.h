@@ -0,0 +1,62 @@
+#ifndef MAPRECORD_H
+#define MAPRECORD_H
+#include <string_view>
+#include <vector>
+using namespace std;
+
+//In-place parsers for the '|' delimited map and craft formats. They work
+//on a string_view of the whole file (usually a MappedFile) and hand back
+//views into it, so no field is copied or heap allocated.
+
+//One area record: id|name|desc|north|east|south|west|
+struct AreaRecord {
+  int m_id; //Unique area id
+  string_view m_name; //Area name (view into the source text)
+  string_view m_desc; //Area description (view into the source text)
+  int m_exits[4]; //North, East, South, West (-1 = no exit)
+};
+
+//One craft line: product|req|req|...| ("None" entries are dropped)
+struct CraftRecord {
+  string_view m_product; //Crafted product name
+  vector<string_view> m_reqs; //Requirement names, in file order
+};
+
+// Name: ParseInt(string_view field, int& value)
+// Description: Parses a decimal int with from_chars, ignoring
+//              surrounding whitespace (as stoi did for the stream loader).
+// Preconditions: None.
+// Postconditions: Returns true and sets value if field is a number.
+bool ParseInt(string_view field, int& value);
+// Name: NextField(string_view text, size_t& pos, char delim, string_view& field)
+// Description: Reads the characters from pos up to the next delim.
+// Preconditions: pos <= text.size().
+// Postconditions: Returns false if no delim remains; otherwise sets
+//                 field and moves pos just past the delim.
+bool NextField(string_view text, size_t& pos, char delim, string_view& field);
+// Name: CountDelimiters(string_view text, char delim)
+// Description: Counts occurrences of delim in text.
+// Preconditions: None.
+// Postconditions: Returns the count.
+size_t CountDelimiters(string_view text, char delim);
+// Name: SkipDelimiters(string_view text, size_t pos, char delim, size_t count)
+// Description: Finds the position just past the count-th delim at or
+//              after pos.
+// Preconditions: pos <= text.size(); count >= 1.
+// Postconditions: Returns that position, or npos if text runs out.
+size_t SkipDelimiters(string_view text, size_t pos, char delim, size_t count);
+// Name: ParseAreaRecord(string_view text, size_t& pos, AreaRecord& record)
+// Description: Parses the next seven fields starting at pos.
+// Preconditions: pos <= text.size().
+// Postconditions: Returns false when no complete record remains;
+//                 throws invalid_argument on a malformed number.
+bool ParseAreaRecord(string_view text, size_t& pos, AreaRecord& record);
+// Name: ParseCraftRecord(string_view text, size_t& pos, CraftRecord& record)
+// Description: Parses the next non-blank line starting at pos.
+// Preconditions: pos <= text.size().
+// Postconditions: Returns false at end of text; otherwise fills record
+//                 (m_reqs is reused, so steady-state parsing does not
+//                 allocate) and moves pos past the line.
+bool ParseCraftRecord(string_view text, size_t& pos, CraftRecord& record);
+
+#endif
@@ -0,0 +1,816 @@
+#ifndef MAPSTORAGE_CPP
+#define MAPSTORAGE_CPP
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "Node.cpp"
+#include "NodePool.cpp"
+using namespace std;
+
+//Storage policies for Map<K,V,S>. Every policy stores its elements as
+//Node<K,V> objects and provides the same small interface:
+//  Node<K,V>* Find(const K& key) const       - nullptr if key is absent
+//  Node<K,V>* Emplace(key, value, inserted)  - finds key or inserts it
+//                                              (one traversal either way);
+//                                              key/value are forwarded into
+//                                              the new node, never copied
+//                                              when passed as rvalues
+//  void Clear()                              - removes every element
+//  int Size() const                          - number of elements
+//  void ForEach(F visit) const               - visits nodes in key order
+//Node pointers returned by ListStorage stay valid until the node is
+//removed. The other policies keep nodes inline, so a pointer is only
+//valid until the next insertion.
+
+//*************************ListStorage*************************
+//Singly linked list kept sorted by key. O(n) lookups and inserts, but
+//nodes never move. Node memory comes from the allocator A (see
+//NodePool.cpp); the default pool carves nodes out of contiguous chunks
+//and frees them all at once in Clear().
+template <typename K, typename V, typename A = PoolAllocator<Node<K,V> > >
+class ListStorage {
+public:
+  // Name: ListStorage()
+  // Description: Constructs an empty list.
+  // Preconditions: None.
+  // Postconditions: m_head is nullptr; m_size is 0.
+  ListStorage();
+  // Name: ListStorage(const ListStorage& other)
+  // Description: Deep copies other's nodes in a single pass.
+  // Preconditions: other is a valid ListStorage.
+  // Postconditions: This list holds copies of other's nodes, in order.
+  ListStorage(const ListStorage& other);
+  // Name: operator=(const ListStorage& other)
+  // Description: Clears this list and deep copies other.
+  // Preconditions: other is a valid ListStorage; self-assignment is handled.
+  // Postconditions: This list holds copies of other's nodes, in order.
+  ListStorage& operator=(const ListStorage& other);
+  // Name: ListStorage(ListStorage&& other)
+  // Description: Takes over other's nodes (and their memory) in O(1).
+  // Preconditions: None.
+  // Postconditions: other is empty.
+  ListStorage(ListStorage&& other);
+  // Name: operator=(ListStorage&& other)
+  // Description: Frees this list and takes over other's nodes in O(1).
+  // Preconditions: None.
+  // Postconditions: other is empty.
+  ListStorage& operator=(ListStorage&& other);
+  // Name: ~ListStorage()
+  // Description: Deletes every node.
+  // Preconditions: None.
+  // Postconditions: All nodes are freed.
+  ~ListStorage();
+  // Name: Find(const K& key) const
+  // Description: Walks the sorted list looking for key, stopping early
+  //              once a larger key is reached.
+  // Preconditions: None.
+  // Postconditions: Returns the node holding key, or nullptr.
+  Node<K,V>* Find(const K& key) const;
+  // Name: Emplace(KK&& key, VV&& value, bool& inserted)
+  // Description: Finds key or links a new node at its sorted position.
+  // Preconditions: None.
+  // Postconditions: Returns the node for key; inserted is true if the
+  //                 node was created by this call.
+  template <typename KK, typename VV>
+  Node<K,V>* Emplace(KK&& key, VV&& value, bool& inserted);
+  // Name: Clear()
+  // Description: Deletes every node.
+  // Preconditions: None.
+  // Postconditions: m_head is nullptr; m_size is 0.
+  void Clear();
+  // Name: Size() const
+  // Description: Reports the number of nodes.
+  // Preconditions: None.
+  // Postconditions: Returns m_size.
+  int Size() const;
+  // Name: ForEach(F visit) const
+  // Description: Calls visit(node) for each node in key order.
+  // Preconditions: visit accepts a const Node<K,V>&.
+  // Postconditions: Every node has been visited once.
+  template <typename F>
+  void ForEach(F visit) const;
+  // Name: GetAllocator() const
+  // Description: Gives access to the node allocator (for its stats).
+  // Preconditions: None.
+  // Postconditions: Returns m_alloc.
+  const A& GetAllocator() const;
+private:
+  // Name: NewNode(KK&& key, VV&& value, Node<K,V>* next)
+  // Description: Constructs a node in memory from m_alloc, forwarding
+  //              key and value into it.
+  // Preconditions: None.
+  // Postconditions: Returns the new node.
+  template <typename KK, typename VV>
+  Node<K,V>* NewNode(KK&& key, VV&& value, Node<K,V>* next);
+  // Name: CopyFrom(const ListStorage& other)
+  // Description: Appends copies of other's nodes to an empty list.
+  // Preconditions: This list is empty.
+  // Postconditions: This list holds copies of other's nodes, in order.
+  void CopyFrom(const ListStorage& other);
+  Node<K,V>* m_head; //Pointer to the first (smallest key) node
+  int m_size; //Number of nodes in the list
+  A m_alloc; //Source of node memory
+};
+
+//*************************FlatStorage*************************
+//Contiguous vector kept sorted by key. Binary search lookups and
+//cache-friendly in-order walks; inserts shift the tail of the vector.
+//Best for small and medium maps that are read far more than written.
+template <typename K, typename V>
+class FlatStorage {
+public:
+  // Name: Find(const K& key) const
+  // Description: Binary searches the sorted vector for key.
+  // Preconditions: None.
+  // Postconditions: Returns the node holding key, or nullptr.
+  Node<K,V>* Find(const K& key) const;
+  // Name: Emplace(KK&& key, VV&& value, bool& inserted)
+  // Description: Finds key or inserts a new node at its sorted position.
+  // Preconditions: None.
+  // Postconditions: Returns the node for key; inserted is true if the
+  //                 node was created by this call.
+  template <typename KK, typename VV>
+  Node<K,V>* Emplace(KK&& key, VV&& value, bool& inserted);
+  // Name: Clear()
+  // Description: Removes every node.
+  // Preconditions: None.
+  // Postconditions: m_nodes is empty.
+  void Clear();
+  // Name: Size() const
+  // Description: Reports the number of nodes.
+  // Preconditions: None.
+  // Postconditions: Returns m_nodes.size().
+  int Size() const;
+  // Name: ForEach(F visit) const
+  // Description: Calls visit(node) for each node in key order.
+  // Preconditions: visit accepts a const Node<K,V>&.
+  // Postconditions: Every node has been visited once.
+  template <typename F>
+  void ForEach(F visit) const;
+private:
+  // Name: LowerBound(const K& key) const
+  // Description: Finds the index of the first node whose key is not
+  //              less than key.
+  // Preconditions: None.
+  // Postconditions: Returns an index in [0, m_nodes.size()].
+  unsigned long LowerBound(const K& key) const;
+  mutable vector<Node<K,V> > m_nodes; //Nodes sorted by key
+};
+
+//*************************HashStorage*************************
+//Open-addressing hash table (linear probing) over a dense node vector.
+//The table holds indices into m_nodes, so probing touches small ints and
+//the nodes themselves stay contiguous. O(1) lookups and inserts; key
+//order is produced by sorting only when the map is walked.
+template <typename K, typename V, typename H = hash<K> >
+class HashStorage {
+public:
+  // Name: HashStorage()
+  // Description: Constructs an empty table.
+  // Preconditions: None.
+  // Postconditions: No slots are allocated until the first insert.
+  HashStorage();
+  // Name: Find(const K& key) const
+  // Description: Probes the slot table for key.
+  // Preconditions: None.
+  // Postconditions: Returns the node holding key, or nullptr.
+  Node<K,V>* Find(const K& key) const;
+  // Name: Emplace(KK&& key, VV&& value, bool& inserted)
+  // Description: Finds key or appends a new node and claims the empty
+  //              slot the probe ended on. The table grows only when a
+  //              new key is added.
+  // Preconditions: None.
+  // Postconditions: Returns the node for key; inserted is true if the
+  //                 node was created by this call.
+  template <typename KK, typename VV>
+  Node<K,V>* Emplace(KK&& key, VV&& value, bool& inserted);
+  // Name: Clear()
+  // Description: Removes every node and empties the slot table.
+  // Preconditions: None.
+  // Postconditions: Size() is 0; slot capacity is kept for reuse.
+  void Clear();
+  // Name: Size() const
+  // Description: Reports the number of nodes.
+  // Preconditions: None.
+  // Postconditions: Returns m_nodes.size().
+  int Size() const;
+  // Name: ForEach(F visit) const
+  // Description: Calls visit(node) for each node in key order
+  //              (sorts node pointers first).
+  // Preconditions: visit accepts a const Node<K,V>&.
+  // Postconditions: Every node has been visited once.
+  template <typename F>
+  void ForEach(F visit) const;
+private:
+  // Name: Probe(const K& key) const
+  // Description: Walks the probe sequence for key.
+  // Preconditions: m_slots is non-empty.
+  // Postconditions: Returns the slot holding key, or the first empty
+  //                 slot in its probe sequence.
+  unsigned long Probe(const K& key) const;
+  // Name: Grow()
+  // Description: Doubles the slot table and re-inserts every node index.
+  // Preconditions: None.
+  // Postconditions: Load factor is at most one half.
+  void Grow();
+  mutable vector<Node<K,V> > m_nodes; //Nodes in insertion order
+  vector<int> m_slots; //Indices into m_nodes, -1 for an empty slot
+  H m_hash; //Hash function for K
+};
+
+//*************************BTreeStorage************************
+//B-tree of minimum degree T. Each tree node keeps up to 2T-1 sorted
+//Node<K,V> elements inline, so lookups do O(log n) short binary searches
+//over contiguous memory and inserts never shift more than one tree node.
+//Best for large maps with a steady stream of new keys.
+template <typename K, typename V, int T = 16>
+class BTreeStorage {
+public:
+  // Name: BTreeStorage()
+  // Description: Constructs an empty tree.
+  // Preconditions: None.
+  // Postconditions: m_root is nullptr; m_size is 0.
+  BTreeStorage();
+  // Name: BTreeStorage(const BTreeStorage& other)
+  // Description: Deep copies other's tree structure.
+  // Preconditions: other is a valid BTreeStorage.
+  // Postconditions: This tree holds copies of other's nodes.
+  BTreeStorage(const BTreeStorage& other);
+  // Name: operator=(const BTreeStorage& other)
+  // Description: Frees this tree and deep copies other.
+  // Preconditions: other is valid; self-assignment is handled.
+  // Postconditions: This tree holds copies of other's nodes.
+  BTreeStorage& operator=(const BTreeStorage& other);
+  // Name: BTreeStorage(BTreeStorage&& other)
+  // Description: Takes over other's tree in O(1).
+  // Preconditions: None.
+  // Postconditions: other is empty.
+  BTreeStorage(BTreeStorage&& other);
+  // Name: operator=(BTreeStorage&& other)
+  // Description: Frees this tree and takes over other's in O(1).
+  // Preconditions: None.
+  // Postconditions: other is empty.
+  BTreeStorage& operator=(BTreeStorage&& other);
+  // Name: ~BTreeStorage()
+  // Description: Frees every tree node.
+  // Preconditions: None.
+  // Postconditions: All memory is released.
+  ~BTreeStorage();
+  // Name: Find(const K& key) const
+  // Description: Descends from the root, binary searching each node.
+  // Preconditions: None.
+  // Postconditions: Returns the node holding key, or nullptr.
+  Node<K,V>* Find(const K& key) const;
+  // Name: Emplace(KK&& key, VV&& value, bool& inserted)
+  // Description: Descends once, splitting full tree nodes on the way
+  //              down, and either finds key or inserts it in a leaf.
+  // Preconditions: None.
+  // Postconditions: Returns the node for key; inserted is true if the
+  //                 node was created by this call.
+  template <typename KK, typename VV>
+  Node<K,V>* Emplace(KK&& key, VV&& value, bool& inserted);
+  // Name: Clear()
+  // Description: Frees every tree node.
+  // Preconditions: None.
+  // Postconditions: m_root is nullptr; m_size is 0.
+  void Clear();
+  // Name: Size() const
+  // Description: Reports the number of elements.
+  // Preconditions: None.
+  // Postconditions: Returns m_size.
+  int Size() const;
+  // Name: ForEach(F visit) const
+  // Description: Calls visit(node) for each element in key order.
+  // Preconditions: visit accepts a const Node<K,V>&.
+  // Postconditions: Every element has been visited once.
+  template <typename F>
+  void ForEach(F visit) const;
+private:
+  struct BNode {
+    vector<Node<K,V> > items; //Sorted elements (at most 2T-1)
+    vector<BNode*> kids; //Children (empty for a leaf, else items+1)
+  };
+  // Name: SplitChild(BNode* parent, unsigned long i)
+  // Description: Splits the full child parent->kids[i] around its median,
+  //              moving the median up into parent.
+  // Preconditions: parent is not full; parent->kids[i] is full.
+  // Postconditions: parent gains one item and one child.
+  void SplitChild(BNode* parent, unsigned long i);
+  // Name: Search(const BNode* node, const K& key, unsigned long& pos)
+  // Description: Binary searches one tree node for key.
+  // Preconditions: node is not nullptr.
+  // Postconditions: pos is the first index whose key is not less than
+  //                 key; returns true if that item's key equals key.
+  static bool Search(const BNode* node, const K& key, unsigned long& pos);
+  // Name: CopyTree(const BNode* node)
+  // Description: Recursively deep copies a subtree.
+  // Preconditions: None.
+  // Postconditions: Returns the new subtree root (nullptr for nullptr).
+  static BNode* CopyTree(const BNode* node);
+  // Name: FreeTree(BNode* node)
+  // Description: Recursively frees a subtree.
+  // Preconditions: None.
+  // Postconditions: node and all its descendants are deleted.
+  static void FreeTree(BNode* node);
+  // Name: Walk(const BNode* node, F& visit)
+  // Description: In-order traversal of a subtree.
+  // Preconditions: node is not nullptr.
+  // Postconditions: visit has been called on every item in the subtree.
+  template <typename F>
+  static void Walk(const BNode* node, F& visit);
+  BNode* m_root; //Root tree node (nullptr when empty)
+  int m_size; //Number of elements
+};
+
+#endif
+
+//*************************ListStorage*************************
+
+template <typename K, typename V, typename A>
+ListStorage<K, V, A>::ListStorage() : m_head(nullptr), m_size(0) {}
+
+template <typename K, typename V, typename A>
+ListStorage<K, V, A>::ListStorage(const ListStorage& other) : m_head(nullptr), m_size(0) {
+    CopyFrom(other);
+}
+
+template <typename K, typename V, typename A>
+ListStorage<K, V, A>& ListStorage<K, V, A>::operator=(const ListStorage& other) {
+    if (this != &other) {
+        Clear();
+        CopyFrom(other);
+    }
+    return *this;
+}
+
+template <typename K, typename V, typename A>
+ListStorage<K, V, A>::ListStorage(ListStorage&& other)
+    : m_head(other.m_head), m_size(other.m_size), m_alloc(std::move(other.m_alloc)) {
+    other.m_head = nullptr;
+    other.m_size = 0;
+}
+
+template <typename K, typename V, typename A>
+ListStorage<K, V, A>& ListStorage<K, V, A>::operator=(ListStorage&& other) {
+    if (this != &other) {
+        Clear();
+        m_head = other.m_head;
+        m_size = other.m_size;
+        m_alloc = std::move(other.m_alloc);
+        other.m_head = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+template <typename K, typename V, typename A>
+ListStorage<K, V, A>::~ListStorage() {
+    Clear();
+}
+
+template <typename K, typename V, typename A>
+void ListStorage<K, V, A>::CopyFrom(const ListStorage& other) {
+    //other is already sorted, so append at the tail instead of re-searching
+    Node<K, V> *tail = nullptr;
+    for (Node<K, V> *curr = other.m_head; curr != nullptr; curr = curr->GetNext()) {
+        Node<K, V> *newNode = NewNode(curr->GetKey(), curr->GetValue(), nullptr);
+        if (tail == nullptr) {
+            m_head = newNode;
+        } else {
+            tail->SetNext(newNode);
+        }
+        tail = newNode;
+    }
+    m_size = other.m_size;
+}
+
+template <typename K, typename V, typename A>
+Node<K, V>* ListStorage<K, V, A>::Find(const K& key) const {
+    Node<K, V> *curr = m_head;
+    //List is sorted, so stop as soon as we pass where key would be
+    while (curr != nullptr && curr->GetKey() < key) {
+        curr = curr->GetNext();
+    }
+    if (curr != nullptr && curr->GetKey() == key) {
+        return curr;
+    }
+    return nullptr;
+}
+
+template <typename K, typename V, typename A>
+template <typename KK, typename VV>
+Node<K, V>* ListStorage<K, V, A>::Emplace(KK&& key, VV&& value, bool& inserted) {
+    Node<K, V> *prev = nullptr;
+    Node<K, V> *curr = m_head;
+    //Find the first node whose key is not less than key
+    while (curr != nullptr && curr->GetKey() < key) {
+        prev = curr;
+        curr = curr->GetNext();
+    }
+    //Key already present
+    if (curr != nullptr && curr->GetKey() == key) {
+        inserted = false;
+        return curr;
+    }
+    //Link a new node between prev and curr
+    Node<K, V> *newNode = NewNode(std::forward<KK>(key), std::forward<VV>(value), curr);
+    if (prev == nullptr) {
+        m_head = newNode;
+    } else {
+        prev->SetNext(newNode);
+    }
+    m_size++;
+    inserted = true;
+    return newNode;
+}
+
+template <typename K, typename V, typename A>
+template <typename KK, typename VV>
+Node<K, V>* ListStorage<K, V, A>::NewNode(KK&& key, VV&& value, Node<K, V>* next) {
+    return new (m_alloc.Allocate()) Node<K, V>(std::forward<KK>(key), std::forward<VV>(value), next);
+}
+
+template <typename K, typename V, typename A>
+void ListStorage<K, V, A>::Clear() {
+    //A pool holding trivially destructible nodes needs no per-node work
+    if (!A::BULK_FREE || !is_trivially_destructible<Node<K, V> >::value) {
+        Node<K, V> *curr = m_head;
+        //Traverse each node, destroy it and hand back its memory
+        while (curr != nullptr) {
+            Node<K, V> *next = curr->GetNext();
+            curr->~Node<K, V>();
+            m_alloc.Deallocate(curr);
+            curr = next;
+        }
+    }
+    //Pool allocators free every chunk here in one pass
+    m_alloc.ReleaseAll();
+    m_head = nullptr;
+    m_size = 0;
+}
+
+template <typename K, typename V, typename A>
+int ListStorage<K, V, A>::Size() const {
+    return m_size;
+}
+
+template <typename K, typename V, typename A>
+template <typename F>
+void ListStorage<K, V, A>::ForEach(F visit) const {
+    for (Node<K, V> *curr = m_head; curr != nullptr; curr = curr->GetNext()) {
+        visit(*curr);
+    }
+}
+
+template <typename K, typename V, typename A>
+const A& ListStorage<K, V, A>::GetAllocator() const {
+    return m_alloc;
+}
+
+//*************************FlatStorage*************************
+
+template <typename K, typename V>
+unsigned long FlatStorage<K, V>::LowerBound(const K& key) const {
+    unsigned long low = 0;
+    unsigned long high = m_nodes.size();
+    //Standard binary search for the first key >= key
+    while (low < high) {
+        unsigned long mid = low + (high - low) / 2;
+        if (m_nodes[mid].GetKey() < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+template <typename K, typename V>
+Node<K, V>* FlatStorage<K, V>::Find(const K& key) const {
+    unsigned long pos = LowerBound(key);
+    if (pos < m_nodes.size() && m_nodes[pos].GetKey() == key) {
+        return &m_nodes[pos];
+    }
+    return nullptr;
+}
+
+template <typename K, typename V>
+template <typename KK, typename VV>
+Node<K, V>* FlatStorage<K, V>::Emplace(KK&& key, VV&& value, bool& inserted) {
+    unsigned long pos = LowerBound(key);
+    if (pos < m_nodes.size() && m_nodes[pos].GetKey() == key) {
+        inserted = false;
+        return &m_nodes[pos];
+    }
+    //Shift the tail up by one and construct the node in the gap
+    m_nodes.emplace(m_nodes.begin() + pos, std::forward<KK>(key), std::forward<VV>(value));
+    inserted = true;
+    return &m_nodes[pos];
+}
+
+template <typename K, typename V>
+void FlatStorage<K, V>::Clear() {
+    m_nodes.clear();
+}
+
+template <typename K, typename V>
+int FlatStorage<K, V>::Size() const {
+    return static_cast<int>(m_nodes.size());
+}
+
+template <typename K, typename V>
+template <typename F>
+void FlatStorage<K, V>::ForEach(F visit) const {
+    for (unsigned long i = 0; i < m_nodes.size(); i++) {
+        visit(m_nodes[i]);
+    }
+}
+
+//*************************HashStorage*************************
+
+template <typename K, typename V, typename H>
+HashStorage<K, V, H>::HashStorage() {}
+
+template <typename K, typename V, typename H>
+unsigned long HashStorage<K, V, H>::Probe(const K& key) const {
+    //Table size is a power of two, so masking replaces modulo
+    unsigned long mask = m_slots.size() - 1;
+    unsigned long slot = m_hash(key) & mask;
+    while (m_slots[slot] != -1 && !(m_nodes[m_slots[slot]].GetKey() == key)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+template <typename K, typename V, typename H>
+void HashStorage<K, V, H>::Grow() {
+    unsigned long newSize = m_slots.empty() ? 16 : m_slots.size() * 2;
+    m_slots.assign(newSize, -1);
+    unsigned long mask = newSize - 1;
+    //Keys are unique, so each index just takes the first free slot
+    for (unsigned long i = 0; i < m_nodes.size(); i++) {
+        unsigned long slot = m_hash(m_nodes[i].GetKey()) & mask;
+        while (m_slots[slot] != -1) {
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot] = static_cast<int>(i);
+    }
+}
+
+template <typename K, typename V, typename H>
+Node<K, V>* HashStorage<K, V, H>::Find(const K& key) const {
+    if (m_nodes.empty()) {
+        return nullptr;
+    }
+    int index = m_slots[Probe(key)];
+    return index == -1 ? nullptr : &m_nodes[index];
+}
+
+template <typename K, typename V, typename H>
+template <typename KK, typename VV>
+Node<K, V>* HashStorage<K, V, H>::Emplace(KK&& key, VV&& value, bool& inserted) {
+    if (m_slots.empty()) {
+        Grow();
+    }
+    unsigned long slot = Probe(key);
+    if (m_slots[slot] != -1) {
+        inserted = false;
+        return &m_nodes[m_slots[slot]];
+    }
+    //Only a new key fills a slot, so only it can push the load factor
+    //past one half
+    if ((m_nodes.size() + 1) * 2 > m_slots.size()) {
+        Grow();
+        slot = Probe(key);
+    }
+    m_slots[slot] = static_cast<int>(m_nodes.size());
+    m_nodes.emplace_back(std::forward<KK>(key), std::forward<VV>(value));
+    inserted = true;
+    return &m_nodes.back();
+}
+
+template <typename K, typename V, typename H>
+void HashStorage<K, V, H>::Clear() {
+    m_nodes.clear();
+    m_slots.assign(m_slots.size(), -1);
+}
+
+template <typename K, typename V, typename H>
+int HashStorage<K, V, H>::Size() const {
+    return static_cast<int>(m_nodes.size());
+}
+
+template <typename K, typename V, typename H>
+template <typename F>
+void HashStorage<K, V, H>::ForEach(F visit) const {
+    //Slots are unordered, so sort pointers to the nodes by key
+    vector<const Node<K, V>*> ordered;
+    ordered.reserve(m_nodes.size());
+    for (unsigned long i = 0; i < m_nodes.size(); i++) {
+        ordered.push_back(&m_nodes[i]);
+    }
+    sort(ordered.begin(), ordered.end(),
+         [](const Node<K, V>* a, const Node<K, V>* b) { return a->GetKey() < b->GetKey(); });
+    for (unsigned long i = 0; i < ordered.size(); i++) {
+        visit(*ordered[i]);
+    }
+}
+
+//*************************BTreeStorage************************
+
+template <typename K, typename V, int T>
+BTreeStorage<K, V, T>::BTreeStorage() : m_root(nullptr), m_size(0) {}
+
+template <typename K, typename V, int T>
+BTreeStorage<K, V, T>::BTreeStorage(const BTreeStorage& other)
+    : m_root(CopyTree(other.m_root)), m_size(other.m_size) {}
+
+template <typename K, typename V, int T>
+BTreeStorage<K, V, T>& BTreeStorage<K, V, T>::operator=(const BTreeStorage& other) {
+    if (this != &other) {
+        Clear();
+        m_root = CopyTree(other.m_root);
+        m_size = other.m_size;
+    }
+    return *this;
+}
+
+template <typename K, typename V, int T>
+BTreeStorage<K, V, T>::BTreeStorage(BTreeStorage&& other)
+    : m_root(other.m_root), m_size(other.m_size) {
+    other.m_root = nullptr;
+    other.m_size = 0;
+}
+
+template <typename K, typename V, int T>
+BTreeStorage<K, V, T>& BTreeStorage<K, V, T>::operator=(BTreeStorage&& other) {
+    if (this != &other) {
+        Clear();
+        m_root = other.m_root;
+        m_size = other.m_size;
+        other.m_root = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+template <typename K, typename V, int T>
+BTreeStorage<K, V, T>::~BTreeStorage() {
+    Clear();
+}
+
+template <typename K, typename V, int T>
+bool BTreeStorage<K, V, T>::Search(const BNode* node, const K& key, unsigned long& pos) {
+    unsigned long low = 0;
+    unsigned long high = node->items.size();
+    while (low < high) {
+        unsigned long mid = low + (high - low) / 2;
+        if (node->items[mid].GetKey() < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    pos = low;
+    return pos < node->items.size() && node->items[pos].GetKey() == key;
+}
+
+template <typename K, typename V, int T>
+Node<K, V>* BTreeStorage<K, V, T>::Find(const K& key) const {
+    BNode *curr = m_root;
+    while (curr != nullptr) {
+        unsigned long pos = 0;
+        if (Search(curr, key, pos)) {
+            return &curr->items[pos];
+        }
+        //Descend into the child between items[pos-1] and items[pos]
+        curr = curr->kids.empty() ? nullptr : curr->kids[pos];
+    }
+    return nullptr;
+}
+
+template <typename K, typename V, int T>
+void BTreeStorage<K, V, T>::SplitChild(BNode* parent, unsigned long i) {
+    BNode *full = parent->kids[i];
+    BNode *right = new BNode;
+    right->items.reserve(2 * T - 1);
+    //Upper T-1 items (and T children) move to the new right sibling
+    right->items.assign(make_move_iterator(full->items.begin() + T),
+                        make_move_iterator(full->items.end()));
+    if (!full->kids.empty()) {
+        right->kids.assign(full->kids.begin() + T, full->kids.end());
+        full->kids.resize(T);
+    }
+    //Median moves up into the parent
+    parent->items.insert(parent->items.begin() + i, std::move(full->items[T - 1]));
+    parent->kids.insert(parent->kids.begin() + i + 1, right);
+    full->items.erase(full->items.begin() + (T - 1), full->items.end());
+}
+
+template <typename K, typename V, int T>
+template <typename KK, typename VV>
+Node<K, V>* BTreeStorage<K, V, T>::Emplace(KK&& key, VV&& value, bool& inserted) {
+    if (m_root == nullptr) {
+        m_root = new BNode;
+        m_root->items.reserve(2 * T - 1);
+    }
+    //A full root is split first so the tree grows at the top
+    if (m_root->items.size() == 2 * T - 1) {
+        BNode *newRoot = new BNode;
+        newRoot->items.reserve(2 * T - 1);
+        newRoot->kids.push_back(m_root);
+        m_root = newRoot;
+        SplitChild(m_root, 0);
+    }
+    BNode *curr = m_root;
+    while (true) {
+        unsigned long pos = 0;
+        if (Search(curr, key, pos)) {
+            inserted = false;
+            return &curr->items[pos];
+        }
+        if (curr->kids.empty()) {
+            //Leaf with room to spare (guaranteed by splitting on the way down)
+            curr->items.emplace(curr->items.begin() + pos, std::forward<KK>(key), std::forward<VV>(value));
+            m_size++;
+            inserted = true;
+            return &curr->items[pos];
+        }
+        if (curr->kids[pos]->items.size() == 2 * T - 1) {
+            SplitChild(curr, pos);
+            //The median that moved up may be key itself or change direction
+            if (curr->items[pos].GetKey() == key) {
+                inserted = false;
+                return &curr->items[pos];
+            }
+            if (curr->items[pos].GetKey() < key) {
+                pos++;
+            }
+        }
+        curr = curr->kids[pos];
+    }
+}
+
+template <typename K, typename V, int T>
+void BTreeStorage<K, V, T>::Clear() {
+    FreeTree(m_root);
+    m_root = nullptr;
+    m_size = 0;
+}
+
+template <typename K, typename V, int T>
+int BTreeStorage<K, V, T>::Size() const {
+    return m_size;
+}
+
+template <typename K, typename V, int T>
+typename BTreeStorage<K, V, T>::BNode* BTreeStorage<K, V, T>::CopyTree(const BNode* node) {
+    if (node == nullptr) {
+        return nullptr;
+    }
+    BNode *copy = new BNode;
+    copy->items = node->items;
+    copy->kids.reserve(node->kids.size());
+    for (unsigned long i = 0; i < node->kids.size(); i++) {
+        copy->kids.push_back(CopyTree(node->kids[i]));
+    }
+    return copy;
+}
+
+template <typename K, typename V, int T>
+void BTreeStorage<K, V, T>::FreeTree(BNode* node) {
+    if (node == nullptr) {
+        return;
+    }
+    for (unsigned long i = 0; i < node->kids.size(); i++) {
+        FreeTree(node->kids[i]);
+    }
+    delete node;
+}
+
+template <typename K, typename V, int T>
+template <typename F>
+void BTreeStorage<K, V, T>::Walk(const BNode* node, F& visit) {
+    for (unsigned long i = 0; i < node->items.size(); i++) {
+        if (!node->kids.empty()) {
+            Walk(node->kids[i], visit);
+        }
+        visit(node->items[i]);
+    }
+    if (!node->kids.empty()) {
+        Walk(node->kids.back(), visit);
+    }
+}
+
+template <typename K, typename V, int T>
+template <typename F>
+void BTreeStorage<K, V, T>::ForEach(F visit) const {
+    if (m_root != nullptr) {
+        Walk(m_root, visit);
+    }
+}
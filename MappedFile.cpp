@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+  // Name: MappedFile()
+  // Description: Creates an object with no file mapped.
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false.
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_open(false) {}
+  // Name: ~MappedFile()
+  // Description: Unmaps the file if one is mapped.
+  // Preconditions: None.
+  // Postconditions: Mapping is released.
+MappedFile::~MappedFile() {
+    Close();
+}
+  // Name: MappedFile(MappedFile&& other)
+  // Description: Takes over other's mapping.
+  // Preconditions: None.
+  // Postconditions: other no longer owns a mapping.
+MappedFile::MappedFile(MappedFile&& other)
+    : m_data(other.m_data), m_size(other.m_size), m_open(other.m_open) {
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_open = false;
+}
+  // Name: operator=(MappedFile&& other)
+  // Description: Releases this mapping and takes over other's.
+  // Preconditions: None.
+  // Postconditions: other no longer owns a mapping.
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    if (this != &other) {
+        Close();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_open = other.m_open;
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_open = false;
+    }
+    return *this;
+}
+  // Name: Open(const string& path)
+  // Description: Maps the whole file read-only.
+  // Preconditions: None.
+  // Postconditions: Returns true on success (an empty file maps to an
+  //                 empty view); false if the file cannot be opened.
+bool MappedFile::Open(const string& path) {
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    //mmap rejects zero-length mappings; an empty file is simply empty
+    if (m_size > 0) {
+        void *addr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            m_size = 0;
+            return false;
+        }
+        //Loaders read front to back
+        madvise(addr, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(addr);
+    }
+    //The mapping stays valid after the descriptor is closed
+    close(fd);
+    m_open = true;
+    return true;
+}
+  // Name: Close()
+  // Description: Unmaps the file.
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false; earlier views are invalid.
+void MappedFile::Close() {
+    if (m_data != nullptr) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+  // Name: IsOpen() const
+  // Description: Reports whether a file is mapped.
+  // Preconditions: None.
+  // Postconditions: Returns true after a successful Open.
+bool MappedFile::IsOpen() const {
+    return m_open;
+}
+  // Name: View() const
+  // Description: The mapped bytes.
+  // Preconditions: None.
+  // Postconditions: Returns a view of the whole file (empty if closed).
+string_view MappedFile::View() const {
+    return string_view(m_data, m_size);
+}
@@ -0,0 +1,61 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <string>
+#include <string_view>
+using namespace std;
+
+//Read-only memory mapping of a whole file (POSIX mmap). The mapping
+//lives as long as the object, so string_views into View() stay valid
+//until Close() or destruction. Move-only.
+class MappedFile {
+public:
+  // Name: MappedFile()
+  // Description: Creates an object with no file mapped.
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false.
+  MappedFile();
+  // Name: ~MappedFile()
+  // Description: Unmaps the file if one is mapped.
+  // Preconditions: None.
+  // Postconditions: Mapping is released.
+  ~MappedFile();
+  // Name: MappedFile(MappedFile&& other)
+  // Description: Takes over other's mapping.
+  // Preconditions: None.
+  // Postconditions: other no longer owns a mapping.
+  MappedFile(MappedFile&& other);
+  // Name: operator=(MappedFile&& other)
+  // Description: Releases this mapping and takes over other's.
+  // Preconditions: None.
+  // Postconditions: other no longer owns a mapping.
+  MappedFile& operator=(MappedFile&& other);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  // Name: Open(const string& path)
+  // Description: Maps the whole file read-only.
+  // Preconditions: None.
+  // Postconditions: Returns true on success (an empty file maps to an
+  //                 empty view); false if the file cannot be opened.
+  bool Open(const string& path);
+  // Name: Close()
+  // Description: Unmaps the file.
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false; earlier views are invalid.
+  void Close();
+  // Name: IsOpen() const
+  // Description: Reports whether a file is mapped.
+  // Preconditions: None.
+  // Postconditions: Returns true after a successful Open.
+  bool IsOpen() const;
+  // Name: View() const
+  // Description: The mapped bytes.
+  // Preconditions: None.
+  // Postconditions: Returns a view of the whole file (empty if closed).
+  string_view View() const;
+private:
+  const char* m_data; //Start of the mapping (nullptr if none)
+  size_t m_size; //Length of the mapping in bytes
+  bool m_open; //True once Open has succeeded
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define NODE_CPP
 
 #include <iostream>
+#include <utility>
 using namespace std;
 
 template<typename K, typename V>
@@ -17,6 +18,15 @@ public:
   // Postconditions: m_key is initialized to key;
   //              m_value to value; m_next to next.
   Node(const K& key, const V& value, Node<K,V>* next = nullptr);
+  // Name: Node(KK&& key, VV&& value, Node<K,V>* next = nullptr)
+  // Description: Emplace-style constructor; forwards key and value
+  //              straight into m_key and m_value, so rvalues are moved
+  //              rather than copied.
+  // Preconditions: K is constructible from KK; V from VV.
+  // Postconditions: m_key and m_value are built from the arguments;
+  //              m_next is set to next.
+  template <typename KK, typename VV>
+  Node(KK&& key, VV&& value, Node<K,V>* next = nullptr);
   // Name: GetKey() const
   // Description: Retrieves the key stored in this node.
   // Preconditions: None.
@@ -27,6 +37,12 @@ public:
   // Preconditions: None.
   // Postconditions: Returns a const reference to m_value.
   const V& GetValue() const;
+  // Name: GetValue()
+  // Description: Gives mutable access to the stored value, so callers
+  //              can update it in place without a second lookup.
+  // Preconditions: None.
+  // Postconditions: Returns a reference to m_value.
+  V& GetValue();
   // Name: GetNext() const
   // Description: Gets the pointer to the next node in the linked list.
   // Preconditions: None.
@@ -37,6 +53,11 @@ public:
   // Preconditions: 'value' must be a valid V object.
   // Postconditions: m_value is set to value.
   void SetValue(const V& value);
+  // Name: SetValue(V&& value)
+  // Description: Updates the stored value by moving value in.
+  // Preconditions: 'value' may be left in a moved-from state.
+  // Postconditions: m_value owns value's former contents.
+  void SetValue(V&& value);
   // Name: SetNext(Node<K,V>* next)
   // Description: Updates the link to the next node in the list.
   // Preconditions: 'next' is either nullptr or points to a valid node.
@@ -68,12 +89,19 @@ private:
   // Postconditions: m_key is initialized to key;
   //              m_value to value; m_next to next.
 template<typename K, typename V>
-Node<K, V>::Node(const K& key, const V& value, Node<K,V>* next) {
-    //Set member variables using passed-in data
-    m_key = key;
-    m_value = value;
-    m_next = next;
-}
+Node<K, V>::Node(const K& key, const V& value, Node<K,V>* next)
+    : m_key(key), m_value(value), m_next(next) {}
+  // Name: Node(KK&& key, VV&& value, Node<K,V>* next = nullptr)
+  // Description: Emplace-style constructor; forwards key and value
+  //              straight into m_key and m_value, so rvalues are moved
+  //              rather than copied.
+  // Preconditions: K is constructible from KK; V from VV.
+  // Postconditions: m_key and m_value are built from the arguments;
+  //              m_next is set to next.
+template<typename K, typename V>
+template<typename KK, typename VV>
+Node<K, V>::Node(KK&& key, VV&& value, Node<K,V>* next)
+    : m_key(std::forward<KK>(key)), m_value(std::forward<VV>(value)), m_next(next) {}
   // Name: GetKey() const
   // Description: Retrieves the key stored in this node.
   // Preconditions: None.
@@ -89,6 +117,15 @@ const K& Node<K, V>::GetKey() const {
 template<typename K, typename V>
 const V& Node<K, V>::GetValue() const {
     return m_value;
+}
+  // Name: GetValue()
+  // Description: Gives mutable access to the stored value, so callers
+  //              can update it in place without a second lookup.
+  // Preconditions: None.
+  // Postconditions: Returns a reference to m_value.
+template<typename K, typename V>
+V& Node<K, V>::GetValue() {
+    return m_value;
 }
   // Name: GetNext() const
   // Description: Gets the pointer to the next node in the linked list.
@@ -105,6 +142,14 @@ Node<K, V>* Node<K, V>::GetNext() const {
 template<typename K, typename V>
 void Node<K, V>::SetValue(const V& value) {
     m_value = value;
+}
+  // Name: SetValue(V&& value)
+  // Description: Updates the stored value by moving value in.
+  // Preconditions: 'value' may be left in a moved-from state.
+  // Postconditions: m_value owns value's former contents.
+template<typename K, typename V>
+void Node<K, V>::SetValue(V&& value) {
+    m_value = std::move(value);
 }
   // Name: SetNext(Node<K,V>* next)
   // Description: Updates the link to the next node in the list.
@@ -0,0 +1,268 @@
+#ifndef NODEPOOL_CPP
+#define NODEPOOL_CPP
+
+#include <new>
+#include <utility>
+#include <vector>
+using namespace std;
+
+//Allocators used by ListStorage to obtain memory for its nodes. Both
+//expose the same interface:
+//  void* Allocate()       - raw memory for one T
+//  void Deallocate(T* p)  - return memory for one T (p already destroyed)
+//  void ReleaseAll()      - return every outstanding allocation at once
+//  BULK_FREE              - true if ReleaseAll frees memory by itself, so
+//                           callers may skip per-node Deallocate calls
+//  GetStats()             - allocation counters
+//Copying an allocator yields a fresh, empty allocator; memory is never
+//shared between containers.
+
+//Allocation counters reported by the node allocators
+struct AllocStats {
+  long m_allocations; //Nodes handed out by Allocate()
+  long m_heapAllocs; //Calls made to the global operator new
+  long m_heapFrees; //Calls made to the global operator delete
+  long m_bytesReserved; //Bytes currently held from the heap
+};
+
+//*************************HeapAllocator************************
+//One operator new/delete per node (the original Map behaviour).
+template <typename T>
+class HeapAllocator {
+public:
+  static const bool BULK_FREE = false;
+  // Name: HeapAllocator()
+  // Description: Constructs an allocator with zeroed counters.
+  // Preconditions: None.
+  // Postconditions: All stats are 0.
+  HeapAllocator();
+  // Name: HeapAllocator(const HeapAllocator& other)
+  // Description: Creates a fresh allocator (counters are not copied).
+  // Preconditions: None.
+  // Postconditions: All stats are 0.
+  HeapAllocator(const HeapAllocator& other);
+  // Name: operator=(const HeapAllocator& other)
+  // Description: No-op; each container keeps its own counters.
+  // Preconditions: None.
+  // Postconditions: This allocator is unchanged.
+  HeapAllocator& operator=(const HeapAllocator& other);
+  // Name: Allocate()
+  // Description: Allocates memory for one T from the global heap.
+  // Preconditions: None.
+  // Postconditions: Returns uninitialized storage for one T.
+  void* Allocate();
+  // Name: Deallocate(T* p)
+  // Description: Returns one T's memory to the global heap.
+  // Preconditions: p came from Allocate() and has been destroyed.
+  // Postconditions: p's memory is freed.
+  void Deallocate(T* p);
+  // Name: ReleaseAll()
+  // Description: Nothing to do; every node was freed individually.
+  // Preconditions: Every allocation has been passed to Deallocate.
+  // Postconditions: None.
+  void ReleaseAll();
+  // Name: GetStats() const
+  // Description: Reports allocation counters.
+  // Preconditions: None.
+  // Postconditions: Returns m_stats.
+  const AllocStats& GetStats() const;
+private:
+  AllocStats m_stats; //Allocation counters
+};
+
+//*************************PoolAllocator************************
+//Slab allocator: nodes are carved sequentially out of contiguous chunks
+//that double in size (up to MAX_CHUNK nodes). Deallocate is a no-op and
+//ReleaseAll returns every chunk to the heap in one pass, so destroying a
+//container costs one free per chunk instead of one per node.
+template <typename T>
+class PoolAllocator {
+public:
+  static const bool BULK_FREE = true;
+  static const long FIRST_CHUNK = 16; //Nodes in the first chunk
+  static const long MAX_CHUNK = 4096; //Largest chunk, in nodes
+  // Name: PoolAllocator()
+  // Description: Constructs an empty pool; no memory is reserved yet.
+  // Preconditions: None.
+  // Postconditions: No chunks are held; all stats are 0.
+  PoolAllocator();
+  // Name: PoolAllocator(const PoolAllocator& other)
+  // Description: Creates a fresh, empty pool (chunks are not shared).
+  // Preconditions: None.
+  // Postconditions: No chunks are held; all stats are 0.
+  PoolAllocator(const PoolAllocator& other);
+  // Name: operator=(const PoolAllocator& other)
+  // Description: No-op; each container keeps its own chunks.
+  // Preconditions: None.
+  // Postconditions: This pool is unchanged.
+  PoolAllocator& operator=(const PoolAllocator& other);
+  // Name: PoolAllocator(PoolAllocator&& other)
+  // Description: Takes over other's chunks and counters.
+  // Preconditions: None.
+  // Postconditions: other holds no chunks.
+  PoolAllocator(PoolAllocator&& other);
+  // Name: operator=(PoolAllocator&& other)
+  // Description: Frees this pool's chunks and takes over other's.
+  // Preconditions: Objects in this pool have already been destroyed.
+  // Postconditions: other holds no chunks.
+  PoolAllocator& operator=(PoolAllocator&& other);
+  // Name: ~PoolAllocator()
+  // Description: Frees every chunk.
+  // Preconditions: Objects in the pool have already been destroyed.
+  // Postconditions: All chunks are returned to the heap.
+  ~PoolAllocator();
+  // Name: Allocate()
+  // Description: Hands out the next free slot, adding a chunk if the
+  //              current one is exhausted.
+  // Preconditions: None.
+  // Postconditions: Returns uninitialized storage for one T.
+  void* Allocate();
+  // Name: Deallocate(T* p)
+  // Description: No-op; memory is reclaimed by ReleaseAll.
+  // Preconditions: p came from Allocate() and has been destroyed.
+  // Postconditions: None.
+  void Deallocate(T* p);
+  // Name: ReleaseAll()
+  // Description: Returns every chunk to the heap at once.
+  // Preconditions: Objects in the pool have already been destroyed.
+  // Postconditions: No chunks are held; the next Allocate starts over.
+  void ReleaseAll();
+  // Name: GetStats() const
+  // Description: Reports allocation counters.
+  // Preconditions: None.
+  // Postconditions: Returns m_stats.
+  const AllocStats& GetStats() const;
+private:
+  vector<void*> m_chunks; //Chunks obtained from the heap
+  char* m_next; //Next free byte in the newest chunk
+  char* m_end; //One past the last byte of the newest chunk
+  long m_chunkNodes; //Size of the newest chunk, in nodes
+  AllocStats m_stats; //Allocation counters
+};
+
+#endif
+
+//*************************HeapAllocator************************
+
+template <typename T>
+HeapAllocator<T>::HeapAllocator() : m_stats() {}
+
+template <typename T>
+HeapAllocator<T>::HeapAllocator(const HeapAllocator&) : m_stats() {}
+
+template <typename T>
+HeapAllocator<T>& HeapAllocator<T>::operator=(const HeapAllocator&) {
+    return *this;
+}
+
+template <typename T>
+void* HeapAllocator<T>::Allocate() {
+    m_stats.m_allocations++;
+    m_stats.m_heapAllocs++;
+    m_stats.m_bytesReserved += sizeof(T);
+    return ::operator new(sizeof(T));
+}
+
+template <typename T>
+void HeapAllocator<T>::Deallocate(T* p) {
+    m_stats.m_heapFrees++;
+    m_stats.m_bytesReserved -= sizeof(T);
+    ::operator delete(p);
+}
+
+template <typename T>
+void HeapAllocator<T>::ReleaseAll() {}
+
+template <typename T>
+const AllocStats& HeapAllocator<T>::GetStats() const {
+    return m_stats;
+}
+
+//*************************PoolAllocator************************
+
+template <typename T>
+PoolAllocator<T>::PoolAllocator()
+    : m_next(nullptr), m_end(nullptr), m_chunkNodes(0), m_stats() {}
+
+template <typename T>
+PoolAllocator<T>::PoolAllocator(const PoolAllocator&)
+    : m_next(nullptr), m_end(nullptr), m_chunkNodes(0), m_stats() {}
+
+template <typename T>
+PoolAllocator<T>& PoolAllocator<T>::operator=(const PoolAllocator&) {
+    return *this;
+}
+
+template <typename T>
+PoolAllocator<T>::PoolAllocator(PoolAllocator&& other)
+    : m_chunks(std::move(other.m_chunks)), m_next(other.m_next), m_end(other.m_end),
+      m_chunkNodes(other.m_chunkNodes), m_stats(other.m_stats) {
+    other.m_chunks.clear();
+    other.m_next = nullptr;
+    other.m_end = nullptr;
+    other.m_chunkNodes = 0;
+    other.m_stats = AllocStats();
+}
+
+template <typename T>
+PoolAllocator<T>& PoolAllocator<T>::operator=(PoolAllocator&& other) {
+    if (this != &other) {
+        ReleaseAll();
+        swap(m_chunks, other.m_chunks);
+        swap(m_next, other.m_next);
+        swap(m_end, other.m_end);
+        swap(m_chunkNodes, other.m_chunkNodes);
+        swap(m_stats, other.m_stats);
+    }
+    return *this;
+}
+
+template <typename T>
+PoolAllocator<T>::~PoolAllocator() {
+    ReleaseAll();
+}
+
+template <typename T>
+void* PoolAllocator<T>::Allocate() {
+    //Slot size rounded up so every slot stays aligned for T
+    const long slot = (sizeof(T) + alignof(T) - 1) / alignof(T) * alignof(T);
+    if (m_next == m_end) {
+        //Current chunk is full: grab a bigger one
+        if (m_chunkNodes == 0) {
+            m_chunkNodes = FIRST_CHUNK;
+        } else if (m_chunkNodes < MAX_CHUNK) {
+            m_chunkNodes *= 2;
+        }
+        char *chunk = static_cast<char*>(::operator new(slot * m_chunkNodes));
+        m_chunks.push_back(chunk);
+        m_next = chunk;
+        m_end = chunk + slot * m_chunkNodes;
+        m_stats.m_heapAllocs++;
+        m_stats.m_bytesReserved += slot * m_chunkNodes;
+    }
+    void *result = m_next;
+    m_next += slot;
+    m_stats.m_allocations++;
+    return result;
+}
+
+template <typename T>
+void PoolAllocator<T>::Deallocate(T*) {}
+
+template <typename T>
+void PoolAllocator<T>::ReleaseAll() {
+    for (unsigned long i = 0; i < m_chunks.size(); i++) {
+        ::operator delete(m_chunks[i]);
+        m_stats.m_heapFrees++;
+    }
+    m_chunks.clear();
+    m_next = nullptr;
+    m_end = nullptr;
+    m_chunkNodes = 0;
+    m_stats.m_bytesReserved = 0;
+}
+
+template <typename T>
+const AllocStats& PoolAllocator<T>::GetStats() const {
+    return m_stats;
+}
@@ -0,0 +1,157 @@
+#include "OutputSink.h"
+#include <charconv>
+#include <cstring>
+
+// Name: WriteNumber(OutputSink& sink, T number)
+// Description: Formats an integer in decimal without a stream.
+// Preconditions: T is an integer type.
+// Postconditions: The digits are written to sink.
+template <typename T>
+static OutputSink& WriteNumber(OutputSink& sink, T number) {
+    char digits[24];
+    to_chars_result result = to_chars(digits, digits + sizeof(digits), number);
+    sink.Write(digits, result.ptr - digits);
+    return sink;
+}
+
+  // Name: ~OutputSink()
+  // Description: Destructor.
+  // Preconditions: None.
+  // Postconditions: None.
+OutputSink::~OutputSink() {}
+  // Name: Flush()
+  // Description: Pushes any held text to its destination.
+  // Preconditions: None.
+  // Postconditions: Everything written so far has been delivered.
+void OutputSink::Flush() {}
+  // Name: IsQuiet() const
+  // Description: Tells writers the text is dropped, so they can skip
+  //              formatting it.
+  // Preconditions: None.
+  // Postconditions: Returns true only for a NullSink.
+bool OutputSink::IsQuiet() const {
+    return false;
+}
+  // Name: operator<<
+  // Description: Writes text, a character or a number in decimal.
+  // Preconditions: None.
+  // Postconditions: Returns the sink for chaining.
+OutputSink& OutputSink::operator<<(string_view text) {
+    Write(text.data(), text.size());
+    return *this;
+}
+OutputSink& OutputSink::operator<<(const char* text) {
+    Write(text, strlen(text));
+    return *this;
+}
+OutputSink& OutputSink::operator<<(char c) {
+    Write(&c, 1);
+    return *this;
+}
+OutputSink& OutputSink::operator<<(int number) {
+    return WriteNumber(*this, number);
+}
+OutputSink& OutputSink::operator<<(long number) {
+    return WriteNumber(*this, number);
+}
+OutputSink& OutputSink::operator<<(long long number) {
+    return WriteNumber(*this, number);
+}
+OutputSink& OutputSink::operator<<(unsigned int number) {
+    return WriteNumber(*this, number);
+}
+OutputSink& OutputSink::operator<<(unsigned long number) {
+    return WriteNumber(*this, number);
+}
+OutputSink& OutputSink::operator<<(unsigned long long number) {
+    return WriteNumber(*this, number);
+}
+
+  // Name: BufferedSink(ostream& out, size_t blockSize)
+  // Description: Creates a sink that writes to out a block at a time.
+  // Preconditions: out outlives the sink; blockSize >= 1.
+  // Postconditions: The block is empty.
+BufferedSink::BufferedSink(ostream& out, size_t blockSize)
+    : m_out(out), m_blockSize(blockSize) {
+    m_block.reserve(blockSize);
+}
+  // Name: ~BufferedSink()
+  // Description: Destructor.
+  // Preconditions: None.
+  // Postconditions: Held text has been flushed to the stream.
+BufferedSink::~BufferedSink() {
+    Flush();
+}
+  // Name: Write(const char* data, size_t size)
+  // Description: Appends to the block, writing the block out first if
+  //              it would overflow (text larger than a block goes
+  //              straight to the stream).
+  // Preconditions: data holds size bytes.
+  // Postconditions: The text is held or written.
+void BufferedSink::Write(const char* data, size_t size) {
+    if (m_block.size() + size > m_blockSize) {
+        m_out.write(m_block.data(), m_block.size());
+        m_block.clear();
+        if (size > m_blockSize) {
+            m_out.write(data, size);
+            return;
+        }
+    }
+    m_block.append(data, size);
+}
+  // Name: Flush()
+  // Description: Writes the block to the stream and flushes the stream.
+  // Preconditions: None.
+  // Postconditions: The block is empty.
+void BufferedSink::Flush() {
+    m_out.write(m_block.data(), m_block.size());
+    m_block.clear();
+    m_out.flush();
+}
+
+  // Name: Write(const char* data, size_t size)
+  // Description: Discards the text.
+  // Preconditions: None.
+  // Postconditions: Nothing changes.
+void NullSink::Write(const char*, size_t) {}
+  // Name: IsQuiet() const
+  // Description: A NullSink drops everything.
+  // Preconditions: None.
+  // Postconditions: Returns true.
+bool NullSink::IsQuiet() const {
+    return true;
+}
+
+  // Name: Write(const char* data, size_t size)
+  // Description: Appends the text to the capture.
+  // Preconditions: data holds size bytes.
+  // Postconditions: GetText() ends with the text.
+void CaptureSink::Write(const char* data, size_t size) {
+    m_text.append(data, size);
+}
+  // Name: GetText() const
+  // Description: Everything written since construction or Clear.
+  // Preconditions: None.
+  // Postconditions: Returns the text.
+const string& CaptureSink::GetText() const {
+    return m_text;
+}
+  // Name: Clear()
+  // Description: Drops the captured text.
+  // Preconditions: None.
+  // Postconditions: GetText() is empty.
+void CaptureSink::Clear() {
+    m_text.clear();
+}
+
+// Name: GetConsole()
+// Description: The process-wide BufferedSink over cout. Game and Hero
+//              share it by default so their text stays in order.
+// Preconditions: None.
+// Postconditions: Returns the sink; it is flushed at exit.
+OutputSink& GetConsole() {
+    //Constructed after cout (this file includes <iostream>), so it is
+    //destroyed, and flushed, before cout is
+    static BufferedSink console(cout);
+    return console;
+}
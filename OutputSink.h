@@ -0,0 +1,130 @@
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+using namespace std;
+
+//Where the game's text goes. Everything the game prints (areas, menus,
+//inventory, hero messages) is written to an OutputSink instead of cout,
+//with '\n' instead of endl, so nothing is flushed per line:
+//  BufferedSink - collects text in a block and writes it to a stream
+//                 when the block fills or on Flush (the console)
+//  NullSink     - drops everything (simulations, benchmarks)
+//  CaptureSink  - keeps everything in a string (checking output)
+//Whoever reads input must Flush first so prompts are visible.
+
+const size_t OUTPUT_BLOCK_SIZE = 1 << 16; //BufferedSink block (bytes)
+
+class OutputSink {
+public:
+  // Name: ~OutputSink()
+  // Description: Destructor.
+  // Preconditions: None.
+  // Postconditions: None.
+  virtual ~OutputSink();
+  // Name: Write(const char* data, size_t size)
+  // Description: Appends size bytes of text.
+  // Preconditions: data holds size bytes.
+  // Postconditions: The text is accepted (maybe not yet written out).
+  virtual void Write(const char* data, size_t size) = 0;
+  // Name: Flush()
+  // Description: Pushes any held text to its destination.
+  // Preconditions: None.
+  // Postconditions: Everything written so far has been delivered.
+  virtual void Flush();
+  // Name: IsQuiet() const
+  // Description: Tells writers the text is dropped, so they can skip
+  //              formatting it.
+  // Preconditions: None.
+  // Postconditions: Returns true only for a NullSink.
+  virtual bool IsQuiet() const;
+  // Name: operator<<
+  // Description: Writes text, a character or a number in decimal.
+  // Preconditions: None.
+  // Postconditions: Returns the sink for chaining.
+  OutputSink& operator<<(string_view text);
+  OutputSink& operator<<(const char* text);
+  OutputSink& operator<<(char c);
+  OutputSink& operator<<(int number);
+  OutputSink& operator<<(long number);
+  OutputSink& operator<<(long long number);
+  OutputSink& operator<<(unsigned int number);
+  OutputSink& operator<<(unsigned long number);
+  OutputSink& operator<<(unsigned long long number);
+};
+
+class BufferedSink : public OutputSink {
+public:
+  // Name: BufferedSink(ostream& out, size_t blockSize)
+  // Description: Creates a sink that writes to out a block at a time.
+  // Preconditions: out outlives the sink; blockSize >= 1.
+  // Postconditions: The block is empty.
+  BufferedSink(ostream& out, size_t blockSize = OUTPUT_BLOCK_SIZE);
+  // Name: ~BufferedSink()
+  // Description: Destructor.
+  // Preconditions: None.
+  // Postconditions: Held text has been flushed to the stream.
+  ~BufferedSink();
+  // Name: Write(const char* data, size_t size)
+  // Description: Appends to the block, writing the block out first if
+  //              it would overflow (text larger than a block goes
+  //              straight to the stream).
+  // Preconditions: data holds size bytes.
+  // Postconditions: The text is held or written.
+  void Write(const char* data, size_t size);
+  // Name: Flush()
+  // Description: Writes the block to the stream and flushes the stream.
+  // Preconditions: None.
+  // Postconditions: The block is empty.
+  void Flush();
+private:
+  ostream& m_out; //Destination stream
+  string m_block; //Text not yet written (capacity = block size)
+  size_t m_blockSize; //Bytes held before writing out
+};
+
+class NullSink : public OutputSink {
+public:
+  // Name: Write(const char* data, size_t size)
+  // Description: Discards the text.
+  // Preconditions: None.
+  // Postconditions: Nothing changes.
+  void Write(const char* data, size_t size);
+  // Name: IsQuiet() const
+  // Description: A NullSink drops everything.
+  // Preconditions: None.
+  // Postconditions: Returns true.
+  bool IsQuiet() const;
+};
+
+class CaptureSink : public OutputSink {
+public:
+  // Name: Write(const char* data, size_t size)
+  // Description: Appends the text to the capture.
+  // Preconditions: data holds size bytes.
+  // Postconditions: GetText() ends with the text.
+  void Write(const char* data, size_t size);
+  // Name: GetText() const
+  // Description: Everything written since construction or Clear.
+  // Preconditions: None.
+  // Postconditions: Returns the text.
+  const string& GetText() const;
+  // Name: Clear()
+  // Description: Drops the captured text.
+  // Preconditions: None.
+  // Postconditions: GetText() is empty.
+  void Clear();
+private:
+  string m_text; //Captured text
+};
+
+// Name: GetConsole()
+// Description: The process-wide BufferedSink over cout. Game and Hero
+//              share it by default so their text stays in order.
+// Preconditions: None.
+// Postconditions: Returns the sink; it is flushed at exit.
+OutputSink& GetConsole();
+
+#endif
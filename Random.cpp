@@ -0,0 +1,64 @@
+#include "Random.h"
+
+// Name: Rotate(uint64_t value, int bits)
+// Description: Rotates value left by bits.
+// Preconditions: 0 < bits < 64.
+// Postconditions: Returns the rotated value.
+static inline uint64_t Rotate(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+  // Name: Random(uint64_t seed)
+  // Description: Creates an engine for seed.
+  // Preconditions: None.
+  // Postconditions: Equal seeds produce equal streams.
+Random::Random(uint64_t seed) {
+    Seed(seed);
+}
+  // Name: Seed(uint64_t seed)
+  // Description: Restarts the engine from seed.
+  // Preconditions: None.
+  // Postconditions: The stream is the one Random(seed) produces.
+void Random::Seed(uint64_t seed) {
+    //SplitMix64 never yields four zero words in a row
+    for (int i = 0; i < 4; i++) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        m_state[i] = z ^ (z >> 31);
+    }
+}
+  // Name: Next()
+  // Description: Draws 64 random bits.
+  // Preconditions: None.
+  // Postconditions: The state advances by one step.
+uint64_t Random::Next() {
+    uint64_t result = Rotate(m_state[1] * 5, 7) * 9;
+    uint64_t shifted = m_state[1] << 17;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= shifted;
+    m_state[3] = Rotate(m_state[3], 45);
+    return result;
+}
+  // Name: Below(uint32_t bound)
+  // Description: Draws a uniform value in [0, bound).
+  // Preconditions: bound >= 1.
+  // Postconditions: Returns the value; every outcome is equally likely.
+uint32_t Random::Below(uint32_t bound) {
+    //High 32 bits times bound: the top word is the result, the low word
+    //tells whether this draw falls in the biased sliver
+    uint64_t product = (Next() >> 32) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound) {
+        uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+        while (low < threshold) {
+            product = (Next() >> 32) * bound;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
@@ -0,0 +1,38 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <cstdint>
+using namespace std;
+
+//Small, fast random engine (xoshiro256**) owned by whoever draws from it,
+//so there is no shared state to lock and no hidden global seed. The
+//64-bit seed is spread over the 256-bit state with SplitMix64, so any
+//seed (including 0) is fine and nearby seeds give unrelated streams.
+//Below() maps to a range without modulo bias (Lemire's multiply-shift
+//with rejection), usually without a division.
+class Random {
+public:
+  // Name: Random(uint64_t seed)
+  // Description: Creates an engine for seed.
+  // Preconditions: None.
+  // Postconditions: Equal seeds produce equal streams.
+  explicit Random(uint64_t seed);
+  // Name: Seed(uint64_t seed)
+  // Description: Restarts the engine from seed.
+  // Preconditions: None.
+  // Postconditions: The stream is the one Random(seed) produces.
+  void Seed(uint64_t seed);
+  // Name: Next()
+  // Description: Draws 64 random bits.
+  // Preconditions: None.
+  // Postconditions: The state advances by one step.
+  uint64_t Next();
+  // Name: Below(uint32_t bound)
+  // Description: Draws a uniform value in [0, bound).
+  // Preconditions: bound >= 1.
+  // Postconditions: Returns the value; every outcome is equally likely.
+  uint32_t Below(uint32_t bound);
+private:
+  uint64_t m_state[4]; // xoshiro256** state (never all zero)
+};
+
+#endif
@@ -0,0 +1,403 @@
+#include "Router.h"
+#include <algorithm>
+#include <climits>
+
+// Name: OpenAfter(const RouteEntry& a, const RouteEntry& b)
+// Description: Heap order for the A* open list: lowest estimate first,
+//              deepest first among equal estimates.
+// Preconditions: None.
+// Postconditions: Returns true if a should be expanded after b.
+static bool OpenAfter(const RouteEntry& a, const RouteEntry& b) {
+    if (a.m_estimate != b.m_estimate) {
+        return a.m_estimate > b.m_estimate;
+    }
+    return a.m_cost < b.m_cost;
+}
+
+// Name: FillDistances(const int32_t* start, const int32_t* edges, int size,
+//                     int source, vector<int32_t>& dist, vector<int32_t>& queue)
+// Description: BFS over a CSR graph from one source.
+// Preconditions: 0 <= source < size.
+// Postconditions: dist[v] is the number of moves from source, or -1.
+static void FillDistances(const int32_t* start, const int32_t* edges, int size,
+                          int source, vector<int32_t>& dist, vector<int32_t>& queue) {
+    dist.assign(size, -1);
+    queue.clear();
+    dist[source] = 0;
+    queue.push_back(source);
+    for (unsigned long head = 0; head < queue.size(); head++) {
+        int at = queue[head];
+        for (int i = start[at]; i < start[at + 1]; i++) {
+            if (dist[edges[i]] < 0) {
+                dist[edges[i]] = dist[at] + 1;
+                queue.push_back(edges[i]);
+            }
+        }
+    }
+}
+
+// Name: IsTarget(int32_t exit, int size)
+// Description: Tells a real exit from NO_EXIT or one leading off the map.
+// Preconditions: size >= 0.
+// Postconditions: Returns true if 0 <= exit < size.
+static inline bool IsTarget(int32_t exit, int size) {
+    return static_cast<uint32_t>(exit) < static_cast<uint32_t>(size);
+}
+
+// Name: Saturate(int distance)
+// Description: Converts a BFS distance to table form.
+// Preconditions: None.
+// Postconditions: Returns FAR_DISTANCE for -1 or anything too large.
+static uint16_t Saturate(int distance) {
+    if (distance < 0 || distance >= FAR_DISTANCE) {
+        return FAR_DISTANCE;
+    }
+    return static_cast<uint16_t>(distance);
+}
+
+  // Name: Router(const World& world, int landmarks)
+  // Description: Routes over world's exit table, building the landmark
+  //              distance tables for maps of at least ALT_MIN_AREAS areas.
+  // Preconditions: world outlives the router and does not change.
+  // Postconditions: FindPath and GetDistance may be called.
+Router::Router(const World& world, int landmarks)
+    : Router(world.GetSize() > 0 ? world.GetExits(0) : nullptr, world.GetSize(), landmarks) {}
+  // Name: Router(const int32_t* exits, int size, int landmarks)
+  // Description: As above, over a bare exit table of size areas.
+  // Preconditions: exits holds size * EXIT_COUNT entries and outlives the
+  //                router unchanged.
+  // Postconditions: FindPath and GetDistance may be called.
+Router::Router(const int32_t* exits, int size, int landmarks)
+    : m_exits(exits), m_size(size), m_landmarkCount(0), m_landmarks(nullptr), m_nextTable(0),
+      m_query(0), m_lastExpanded(0) {
+    if (m_size >= ALT_MIN_AREAS && landmarks > 0) {
+        BuildLandmarks(landmarks);
+    }
+}
+  // Name: Router(const int32_t* exits, int size, const uint16_t* landmarkTable,
+  //              int landmarkCount)
+  // Description: Routes over an exit table with landmark tables built
+  //              elsewhere (see GetLandmarkTable); nothing is built, so
+  //              this costs the same whatever the size of the map.
+  // Preconditions: exits holds size * EXIT_COUNT entries; landmarkTable
+  //                holds size * 2 * landmarkCount entries laid out as
+  //                GetLandmarkTable's, built over the same exits (or is
+  //                null with landmarkCount 0); both outlive the router.
+  // Postconditions: FindPath and GetDistance may be called.
+Router::Router(const int32_t* exits, int size, const uint16_t* landmarkTable, int landmarkCount)
+    : m_exits(exits), m_size(size), m_landmarkCount(landmarkTable != nullptr ? landmarkCount : 0),
+      m_landmarks(landmarkTable), m_nextTable(0), m_query(0), m_lastExpanded(0) {}
+  // Name: FindPath(int from, int to, vector<int>& path)
+  // Description: Finds a shortest route between two areas.
+  // Preconditions: 0 <= from, to < world size.
+  // Postconditions: Returns false if to is unreachable; otherwise path
+  //                 holds the areas visited, from first and to last.
+bool Router::FindPath(int from, int to, vector<int>& path) {
+    path.clear();
+    const vector<int32_t> *table = FindTarget(to);
+    if (table != nullptr) {
+        //Follow any exit that gets one move closer
+        int at = from;
+        if ((*table)[at] < 0) {
+            return false;
+        }
+        path.push_back(at);
+        while (at != to) {
+            const int32_t *next = m_exits + static_cast<size_t>(at) * EXIT_COUNT;
+            int d = 0;
+            while (!IsTarget(next[d], m_size) || (*table)[next[d]] != (*table)[at] - 1) {
+                d++;
+            }
+            at = next[d];
+            path.push_back(at);
+        }
+        return true;
+    }
+    int distance = Search(from, to);
+    if (distance < 0) {
+        return false;
+    }
+    //Walk the parents back from the goal
+    path.resize(distance + 1);
+    int at = to;
+    for (int i = distance; i >= 0; i--) {
+        path[i] = at;
+        at = m_state[at].m_parent;
+    }
+    return true;
+}
+  // Name: GetDistance(int from, int to)
+  // Description: Length of a shortest route, in moves.
+  // Preconditions: 0 <= from, to < world size.
+  // Postconditions: Returns the number of moves, or -1 if unreachable.
+int Router::GetDistance(int from, int to) {
+    const vector<int32_t> *table = FindTarget(to);
+    if (table != nullptr) {
+        return (*table)[from];
+    }
+    return Search(from, to);
+}
+  // Name: PrepareTarget(int to)
+  // Description: Builds (with one reverse BFS) a table of every area's
+  //              distance to to, replacing the oldest of
+  //              ROUTER_TARGET_TABLES tables if all are in use.
+  // Preconditions: 0 <= to < world size.
+  // Postconditions: Queries ending at to no longer search.
+void Router::PrepareTarget(int to) {
+    if (FindTarget(to) != nullptr) {
+        return;
+    }
+    if (static_cast<int>(m_targetIds.size()) < ROUTER_TARGET_TABLES) {
+        m_targetIds.push_back(to);
+        m_targetTables.emplace_back();
+        m_nextTable = static_cast<int>(m_targetIds.size()) - 1;
+    }
+    BuildReverse();
+    int slot = m_nextTable;
+    m_targetIds[slot] = to;
+    FillDistances(m_reverseStart.data(), m_reverseEdges.data(), m_size, to,
+                  m_targetTables[slot], m_queue);
+    m_nextTable = (slot + 1) % ROUTER_TARGET_TABLES;
+}
+  // Name: GetLowerBound(int from, int to) const
+  // Description: ALT lower bound on the distance (0 on small maps).
+  // Preconditions: 0 <= from, to < world size.
+  // Postconditions: Returns a value <= GetDistance(from, to).
+int Router::GetLowerBound(int from, int to) const {
+    int best = 0;
+    if (m_landmarkCount == 0) {
+        return best;
+    }
+    const uint16_t *fromV = m_landmarks + static_cast<size_t>(from) * 2 * m_landmarkCount;
+    const uint16_t *fromT = m_landmarks + static_cast<size_t>(to) * 2 * m_landmarkCount;
+    const uint16_t *toV = fromV + m_landmarkCount;
+    const uint16_t *toT = fromT + m_landmarkCount;
+    for (int l = 0; l < m_landmarkCount; l++) {
+        //d(L,t) <= d(L,v) + d(v,t) and d(v,L) <= d(v,t) + d(t,L);
+        //saturated entries say nothing, so they are skipped
+        if (fromV[l] != FAR_DISTANCE && fromT[l] != FAR_DISTANCE) {
+            best = max(best, fromT[l] - fromV[l]);
+        }
+        if (toV[l] != FAR_DISTANCE && toT[l] != FAR_DISTANCE) {
+            best = max(best, toV[l] - toT[l]);
+        }
+    }
+    return best;
+}
+  // Name: GetLandmarkCount() const
+  // Description: Reports how many landmarks the tables hold.
+  // Preconditions: None.
+  // Postconditions: Returns 0 when the router uses plain BFS.
+int Router::GetLandmarkCount() const {
+    return m_landmarkCount;
+}
+  // Name: GetLandmarkTable() const
+  // Description: The landmark distance tables: per area, d(L, area) for
+  //              each landmark L, then d(area, L), FAR_DISTANCE if none.
+  // Preconditions: None.
+  // Postconditions: Returns size * 2 * GetLandmarkCount() entries (null
+  //                 when there are no landmarks).
+const uint16_t* Router::GetLandmarkTable() const {
+    return m_landmarkCount > 0 ? m_landmarks : nullptr;
+}
+  // Name: GetLastExpanded() const
+  // Description: Areas expanded by the most recent query.
+  // Preconditions: None.
+  // Postconditions: Returns the count.
+int Router::GetLastExpanded() const {
+    return m_lastExpanded;
+}
+  // Name: Search(int from, int to)
+  // Description: Runs BFS or ALT A* and leaves parents in the scratch
+  //              arrays.
+  // Preconditions: 0 <= from, to < world size.
+  // Postconditions: Returns the distance, or -1 if unreachable.
+int Router::Search(int from, int to) {
+    //The scratch array is sized by the first query, not at open
+    if (m_state.empty()) {
+        m_state.assign(m_size, RouteState{0, 0, -1});
+    }
+    //New query number; on wrap-around every stamp is reset once
+    if (++m_query == 0) {
+        for (int i = 0; i < m_size; i++) {
+            m_state[i].m_stamp = 0;
+        }
+        m_query = 1;
+    }
+    m_lastExpanded = 0;
+    Visit(from);
+    m_state[from].m_cost = 0;
+    if (from == to) {
+        return 0;
+    }
+    return m_landmarkCount > 0 ? AStar(from, to) : Bfs(from, to);
+}
+  // Name: Bfs(int from, int to)
+  // Description: Breadth-first search used on small maps.
+  // Preconditions: As Search.
+  // Postconditions: As Search.
+int Router::Bfs(int from, int to) {
+    m_queue.clear();
+    m_queue.push_back(from);
+    for (unsigned long head = 0; head < m_queue.size(); head++) {
+        int at = m_queue[head];
+        m_lastExpanded++;
+        const int32_t *next = m_exits + static_cast<size_t>(at) * EXIT_COUNT;
+        for (int d = 0; d < EXIT_COUNT; d++) {
+            if (IsTarget(next[d], m_size) && Visit(next[d])) {
+                m_state[next[d]].m_cost = m_state[at].m_cost + 1;
+                m_state[next[d]].m_parent = at;
+                if (next[d] == to) {
+                    return m_state[to].m_cost;
+                }
+                m_queue.push_back(next[d]);
+            }
+        }
+    }
+    return -1;
+}
+  // Name: AStar(int from, int to)
+  // Description: A* search guided by GetLowerBound.
+  // Preconditions: As Search.
+  // Postconditions: As Search.
+int Router::AStar(int from, int to) {
+    vector<RouteEntry>& open = m_open;
+    open.clear();
+    open.push_back(RouteEntry{GetLowerBound(from, to), 0, from});
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), OpenAfter);
+        RouteEntry top = open.back();
+        open.pop_back();
+        //Skip stale entries (a shorter route was found after the push)
+        if (top.m_cost != m_state[top.m_area].m_cost) {
+            continue;
+        }
+        if (top.m_area == to) {
+            return top.m_cost;
+        }
+        m_lastExpanded++;
+        const int32_t *next = m_exits + static_cast<size_t>(top.m_area) * EXIT_COUNT;
+        for (int d = 0; d < EXIT_COUNT; d++) {
+            int area = next[d];
+            if (!IsTarget(area, m_size)) {
+                continue;
+            }
+            int cost = top.m_cost + 1;
+            if (Visit(area) || cost < m_state[area].m_cost) {
+                m_state[area].m_cost = cost;
+                m_state[area].m_parent = top.m_area;
+                open.push_back(RouteEntry{cost + GetLowerBound(area, to), cost, area});
+                push_heap(open.begin(), open.end(), OpenAfter);
+            }
+        }
+    }
+    return -1;
+}
+  // Name: BuildLandmarks(int count)
+  // Description: Picks landmarks by farthest-point selection and fills
+  //              m_landmarkDist.
+  // Preconditions: None.
+  // Postconditions: m_landmarkCount landmarks are stored.
+void Router::BuildLandmarks(int count) {
+    if (count > m_size) {
+        count = m_size;
+    }
+    BuildReverse();
+    m_landmarkDist.assign(static_cast<size_t>(m_size) * 2 * count, FAR_DISTANCE);
+    //Forward CSR as plain arrays for FillDistances
+    vector<int32_t> start(m_size + 1, 0);
+    vector<int32_t> edges;
+    for (int v = 0; v < m_size; v++) {
+        const int32_t *next = m_exits + static_cast<size_t>(v) * EXIT_COUNT;
+        for (int d = 0; d < EXIT_COUNT; d++) {
+            if (IsTarget(next[d], m_size)) {
+                edges.push_back(next[d]);
+            }
+        }
+        start[v + 1] = static_cast<int32_t>(edges.size());
+    }
+    vector<int32_t> dist;
+    vector<int32_t> queue;
+    //Closest chosen landmark per area (INT_MAX = not reached by any yet)
+    vector<int> nearest(m_size, INT_MAX);
+    //The first landmark is the area farthest from area 0
+    FillDistances(start.data(), edges.data(), m_size, 0, dist, queue);
+    int landmark = static_cast<int>(max_element(dist.begin(), dist.end()) - dist.begin());
+    for (int l = 0; l < count; l++) {
+        FillDistances(start.data(), edges.data(), m_size, landmark, dist, queue);
+        for (int v = 0; v < m_size; v++) {
+            m_landmarkDist[static_cast<size_t>(v) * 2 * count + l] = Saturate(dist[v]);
+            if (dist[v] >= 0 && dist[v] < nearest[v]) {
+                nearest[v] = dist[v];
+            }
+        }
+        FillDistances(m_reverseStart.data(), m_reverseEdges.data(), m_size, landmark, dist, queue);
+        for (int v = 0; v < m_size; v++) {
+            m_landmarkDist[static_cast<size_t>(v) * 2 * count + count + l] = Saturate(dist[v]);
+        }
+        //Next: an area no landmark reaches yet (another component), or
+        //else the area farthest from every landmark so far
+        landmark = static_cast<int>(max_element(nearest.begin(), nearest.end()) - nearest.begin());
+    }
+    m_landmarkCount = count;
+    m_landmarks = m_landmarkDist.data();
+}
+  // Name: BuildReverse()
+  // Description: Builds the reverse adjacency on first use (only target
+  //              tables and landmark building walk edges backwards).
+  // Preconditions: None.
+  // Postconditions: m_reverseStart/m_reverseEdges are built.
+void Router::BuildReverse() {
+    if (!m_reverseStart.empty()) {
+        return;
+    }
+    //Reverse CSR: count incoming edges, prefix sum, then scatter
+    m_reverseStart.assign(m_size + 1, 0);
+    for (int v = 0; v < m_size; v++) {
+        const int32_t *next = m_exits + static_cast<size_t>(v) * EXIT_COUNT;
+        for (int d = 0; d < EXIT_COUNT; d++) {
+            if (IsTarget(next[d], m_size)) {
+                m_reverseStart[next[d] + 1]++;
+            }
+        }
+    }
+    for (int v = 0; v < m_size; v++) {
+        m_reverseStart[v + 1] += m_reverseStart[v];
+    }
+    m_reverseEdges.resize(m_reverseStart[m_size]);
+    vector<int32_t> fill(m_reverseStart.begin(), m_reverseStart.end() - 1);
+    for (int v = 0; v < m_size; v++) {
+        const int32_t *next = m_exits + static_cast<size_t>(v) * EXIT_COUNT;
+        for (int d = 0; d < EXIT_COUNT; d++) {
+            if (IsTarget(next[d], m_size)) {
+                m_reverseEdges[fill[next[d]]++] = v;
+            }
+        }
+    }
+}
+  // Name: FindTarget(int to) const
+  // Description: Looks for a prepared distance table for to.
+  // Preconditions: None.
+  // Postconditions: Returns the table, or nullptr.
+const vector<int32_t>* Router::FindTarget(int to) const {
+    for (unsigned long i = 0; i < m_targetIds.size(); i++) {
+        if (m_targetIds[i] == to) {
+            return &m_targetTables[i];
+        }
+    }
+    return nullptr;
+}
+  // Name: Visit(int area)
+  // Description: Starts tracking an area in the current query.
+  // Preconditions: 0 <= area < world size.
+  // Postconditions: Returns true the first time area is seen this query.
+bool Router::Visit(int area) {
+    RouteState& state = m_state[area];
+    if (state.m_stamp == m_query) {
+        return false;
+    }
+    state.m_stamp = m_query;
+    state.m_cost = INT_MAX;
+    state.m_parent = -1;
+    return true;
+}
@@ -0,0 +1,164 @@
+#ifndef ROUTER_H
+#define ROUTER_H
+#include <cstdint>
+#include <vector>
+#include "World.h"
+using namespace std;
+
+const int ALT_MIN_AREAS = 4096; //Smaller maps are routed with plain BFS
+const int ROUTER_LANDMARKS = 8; //Landmarks used by ALT on large maps
+const uint16_t FAR_DISTANCE = 0xFFFF; //Unreachable (or too far to store)
+const int ROUTER_TARGET_TABLES = 4; //Destination distance tables kept
+
+//One open-list entry for A*
+struct RouteEntry {
+  int m_estimate; //Moves so far plus the lower bound to the goal
+  int m_cost; //Moves so far
+  int m_area; //Area index
+};
+
+//Per-query state of one area
+struct RouteState {
+  uint32_t m_stamp; //Query number that last touched the area
+  int32_t m_cost; //Moves from the start (valid when stamped)
+  int32_t m_parent; //Previous area on the best route
+};
+
+//Shortest-path engine over a flat exit table (EXIT_COUNT per area, as in
+//World and WorldPack; every exit costs one move, and NO_EXIT or a target
+//outside the map is no exit). Small maps are searched with BFS. Large maps
+//use A* with the ALT heuristic: a few landmarks are picked by
+//farthest-point selection and BFS distances from and to each are stored
+//as uint16 per area, interleaved so all of one area's bounds share a cache
+//line. The triangle inequality then gives an admissible lower bound on
+//any distance in O(landmarks). The tables are built when the router is
+//made over a World, or borrowed from a world pack (packc stores them), so
+//opening a pack builds nothing. Per-query state is stamped rather than
+//cleared, so a query costs only the areas it touches. For destinations
+//asked about over and over (many heroes heading to one place),
+//PrepareTarget stores a full distance-to-target table, after which every
+//route to it is read off in O(route length). A Router is not thread-safe.
+class Router {
+public:
+  // Name: Router(const World& world, int landmarks)
+  // Description: Routes over world's exit table, building the landmark
+  //              distance tables for maps of at least ALT_MIN_AREAS areas.
+  // Preconditions: world outlives the router and does not change.
+  // Postconditions: FindPath and GetDistance may be called.
+  Router(const World& world, int landmarks = ROUTER_LANDMARKS);
+  // Name: Router(const int32_t* exits, int size, int landmarks)
+  // Description: As above, over a bare exit table of size areas.
+  // Preconditions: exits holds size * EXIT_COUNT entries and outlives the
+  //                router unchanged.
+  // Postconditions: FindPath and GetDistance may be called.
+  Router(const int32_t* exits, int size, int landmarks = ROUTER_LANDMARKS);
+  // Name: Router(const int32_t* exits, int size, const uint16_t* landmarkTable,
+  //              int landmarkCount)
+  // Description: Routes over an exit table with landmark tables built
+  //              elsewhere (see GetLandmarkTable); nothing is built, so
+  //              this costs the same whatever the size of the map.
+  // Preconditions: exits holds size * EXIT_COUNT entries; landmarkTable
+  //                holds size * 2 * landmarkCount entries laid out as
+  //                GetLandmarkTable's, built over the same exits (or is
+  //                null with landmarkCount 0); both outlive the router.
+  // Postconditions: FindPath and GetDistance may be called.
+  Router(const int32_t* exits, int size, const uint16_t* landmarkTable, int landmarkCount);
+  Router(const Router&) = delete;
+  Router& operator=(const Router&) = delete;
+  // Name: FindPath(int from, int to, vector<int>& path)
+  // Description: Finds a shortest route between two areas.
+  // Preconditions: 0 <= from, to < world size.
+  // Postconditions: Returns false if to is unreachable; otherwise path
+  //                 holds the areas visited, from first and to last.
+  bool FindPath(int from, int to, vector<int>& path);
+  // Name: GetDistance(int from, int to)
+  // Description: Length of a shortest route, in moves.
+  // Preconditions: 0 <= from, to < world size.
+  // Postconditions: Returns the number of moves, or -1 if unreachable.
+  int GetDistance(int from, int to);
+  // Name: PrepareTarget(int to)
+  // Description: Builds (with one reverse BFS) a table of every area's
+  //              distance to to, replacing the oldest of
+  //              ROUTER_TARGET_TABLES tables if all are in use.
+  // Preconditions: 0 <= to < world size.
+  // Postconditions: Queries ending at to no longer search.
+  void PrepareTarget(int to);
+  // Name: GetLowerBound(int from, int to) const
+  // Description: ALT lower bound on the distance (0 on small maps).
+  // Preconditions: 0 <= from, to < world size.
+  // Postconditions: Returns a value <= GetDistance(from, to).
+  int GetLowerBound(int from, int to) const;
+  // Name: GetLandmarkCount() const
+  // Description: Reports how many landmarks the tables hold.
+  // Preconditions: None.
+  // Postconditions: Returns 0 when the router uses plain BFS.
+  int GetLandmarkCount() const;
+  // Name: GetLandmarkTable() const
+  // Description: The landmark distance tables: per area, d(L, area) for
+  //              each landmark L, then d(area, L), FAR_DISTANCE if none.
+  // Preconditions: None.
+  // Postconditions: Returns size * 2 * GetLandmarkCount() entries (null
+  //                 when there are no landmarks).
+  const uint16_t* GetLandmarkTable() const;
+  // Name: GetLastExpanded() const
+  // Description: Areas expanded by the most recent query.
+  // Preconditions: None.
+  // Postconditions: Returns the count.
+  int GetLastExpanded() const;
+private:
+  // Name: Search(int from, int to)
+  // Description: Runs BFS or ALT A* and leaves parents in the scratch
+  //              arrays.
+  // Preconditions: 0 <= from, to < world size.
+  // Postconditions: Returns the distance, or -1 if unreachable.
+  int Search(int from, int to);
+  // Name: Bfs(int from, int to)
+  // Description: Breadth-first search used on small maps.
+  // Preconditions: As Search.
+  // Postconditions: As Search.
+  int Bfs(int from, int to);
+  // Name: AStar(int from, int to)
+  // Description: A* search guided by GetLowerBound.
+  // Preconditions: As Search.
+  // Postconditions: As Search.
+  int AStar(int from, int to);
+  // Name: BuildLandmarks(int count)
+  // Description: Picks landmarks by farthest-point selection and fills
+  //              m_landmarkDist.
+  // Preconditions: None.
+  // Postconditions: m_landmarkCount landmarks are stored.
+  void BuildLandmarks(int count);
+  // Name: BuildReverse()
+  // Description: Builds the reverse adjacency on first use (only target
+  //              tables and landmark building walk edges backwards).
+  // Preconditions: None.
+  // Postconditions: m_reverseStart/m_reverseEdges are built.
+  void BuildReverse();
+  // Name: FindTarget(int to) const
+  // Description: Looks for a prepared distance table for to.
+  // Preconditions: None.
+  // Postconditions: Returns the table, or nullptr.
+  const vector<int32_t>* FindTarget(int to) const;
+  // Name: Visit(int area)
+  // Description: Starts tracking an area in the current query.
+  // Preconditions: 0 <= area < world size.
+  // Postconditions: Returns true the first time area is seen this query.
+  bool Visit(int area);
+  const int32_t* m_exits; // EXIT_COUNT exits per area (not owned)
+  int m_size; // Number of areas
+  vector<int32_t> m_reverseStart; // CSR offsets of incoming edges (empty until built)
+  vector<int32_t> m_reverseEdges; // CSR sources of incoming edges
+  int m_landmarkCount; // Landmarks in the tables (0 = BFS only)
+  vector<uint16_t> m_landmarkDist; // Tables built here (empty when borrowed)
+  const uint16_t* m_landmarks; // Tables in use: m_landmarkDist or borrowed
+  vector<RouteState> m_state; // Per-query state, stamped (sized on first query)
+  vector<int32_t> m_queue; // BFS queue, reused between queries
+  vector<RouteEntry> m_open; // A* open list (binary heap), reused
+  vector<int> m_targetIds; // Destinations with a prepared table
+  vector<vector<int32_t>> m_targetTables; // Distance to each destination
+  int m_nextTable; // Table replaced by the next PrepareTarget
+  uint32_t m_query; // Current query number
+  int m_lastExpanded; // Areas expanded by the last query
+};
+
+#endif
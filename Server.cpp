@@ -0,0 +1,388 @@
+#include "Server.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+  // Name: GameServer(Game& game, uint64_t seed, SessionMode mode)
+  // Description: Creates a server for game's loaded world whose sessions
+  //              run mode. Session n's hero is seeded with seed + n.
+  // Preconditions: game's world and recipes are loaded and checked, and
+  //                BuildRouter and BuildPlanner have run.
+  // Postconditions: Nothing is listening yet.
+GameServer::GameServer(Game& game, uint64_t seed, SessionMode mode)
+    : m_game(&game), m_seed(seed), m_mode(mode), m_tcpPort(-1), m_stop(false), m_accepted(0),
+      m_closed(0), m_commands(0), m_open(0), m_peak(0) {
+    //Players must not be able to write files on the server
+    m_game->SetFileCommands(false);
+}
+  // Name: ~GameServer()
+  // Description: Closes every session and listening socket.
+  // Preconditions: None.
+  // Postconditions: A Unix socket file made by ListenUnix is removed.
+GameServer::~GameServer() {
+    for (unsigned long i = 0; i < m_connections.size(); i++) {
+        if (m_connections[i] != nullptr) {
+            Close(m_connections[i]);
+        }
+    }
+    for (unsigned long i = 0; i < m_listeners.size(); i++) {
+        close(m_listeners[i]);
+    }
+    if (!m_unixPath.empty()) {
+        unlink(m_unixPath.c_str());
+    }
+}
+  // Name: ListenTcp(int port, string& error)
+  // Description: Accepts TCP connections on 127.0.0.1:port.
+  // Preconditions: None (0 picks a free port).
+  // Postconditions: Returns false and sets error if port is not 0 to
+  //                 MAX_TCP_PORT or cannot be bound; GetTcpPort reports
+  //                 the port in use.
+bool GameServer::ListenTcp(int port, string& error) {
+    //htons would quietly wrap a larger number onto some other port
+    if (port < 0 || port > MAX_TCP_PORT) {
+        error = "port " + to_string(port) + " is not 0 to " + to_string(MAX_TCP_PORT);
+        return false;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = string("cannot create a socket: ") + strerror(errno);
+        return false;
+    }
+    //Restarting the server should not wait out TIME_WAIT
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        error = "cannot bind 127.0.0.1:" + to_string(port) + ": " + strerror(errno);
+        close(fd);
+        return false;
+    }
+    if (!AddListener(fd, error)) {
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+    m_tcpPort = ntohs(address.sin_port);
+    return true;
+}
+  // Name: ListenUnix(const string& path, string& error)
+  // Description: Accepts connections on a Unix socket at path
+  //              (replacing a stale socket file there).
+  // Preconditions: None.
+  // Postconditions: Returns false and sets error if it cannot be bound.
+bool GameServer::ListenUnix(const string& path, string& error) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        error = "socket path must be 1 to " + to_string(sizeof(address.sun_path) - 1) + " characters";
+        return false;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    //Only ever remove an old socket, never some other file
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            error = path + " exists and is not a socket";
+            return false;
+        }
+        unlink(path.c_str());
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = string("cannot create a socket: ") + strerror(errno);
+        return false;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        error = "cannot bind " + path + ": " + strerror(errno);
+        close(fd);
+        return false;
+    }
+    m_unixPath = path;
+    return AddListener(fd, error);
+}
+  // Name: GetTcpPort() const
+  // Description: Port ListenTcp bound.
+  // Preconditions: None.
+  // Postconditions: Returns the port, or -1 if not listening on TCP.
+int GameServer::GetTcpPort() const {
+    return m_tcpPort;
+}
+  // Name: Run(int workers)
+  // Description: Serves connections on workers threads (the calling
+  //              thread is one of them) until Stop is called.
+  // Preconditions: ListenTcp or ListenUnix succeeded; workers >= 0
+  //                (0 = one per hardware thread).
+  // Postconditions: Every session is closed.
+void GameServer::Run(int workers) {
+    if (workers <= 0) {
+        workers = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    vector<thread> threads;
+    for (int i = 1; i < workers; i++) {
+        threads.push_back(thread(&GameServer::Serve, this));
+    }
+    Serve();
+    for (unsigned long i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    //Every worker has stopped; end the sessions still open
+    for (unsigned long i = 0; i < m_connections.size(); i++) {
+        if (m_connections[i] != nullptr) {
+            Close(m_connections[i]);
+        }
+    }
+}
+  // Name: Stop()
+  // Description: Asks Run to return (safe from a signal handler).
+  // Preconditions: None.
+  // Postconditions: Run returns within SERVER_WAIT_MS.
+void GameServer::Stop() {
+    m_stop = true;
+}
+  // Name: GetStats() const
+  // Description: Counters so far.
+  // Preconditions: None.
+  // Postconditions: Returns a copy of the counters.
+ServerStats GameServer::GetStats() const {
+    ServerStats stats;
+    stats.m_accepted = m_accepted;
+    stats.m_closed = m_closed;
+    stats.m_commands = m_commands;
+    stats.m_peak = m_peak;
+    return stats;
+}
+  // Name: AddListener(int fd, string& error)
+  // Description: Starts listening on a bound socket.
+  // Preconditions: fd is bound.
+  // Postconditions: Returns false, closing fd, if it cannot listen.
+bool GameServer::AddListener(int fd, string& error) {
+    if (listen(fd, SOMAXCONN) != 0) {
+        error = string("cannot listen: ") + strerror(errno);
+        close(fd);
+        return false;
+    }
+    m_listeners.push_back(fd);
+    return true;
+}
+  // Name: Serve()
+  // Description: One worker: watches every listener and the connections
+  //              it accepts until Stop is called.
+  // Preconditions: Run is running.
+  // Postconditions: The worker's event queue is closed (its connections
+  //                 stay open for Run to close).
+void GameServer::Serve() {
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0) {
+        return;
+    }
+    //Routing and planning keep scratch, so each worker has its own
+    Worker worker;
+    worker.m_epoll = epoll;
+    worker.m_router = m_game->NewRouter();
+    worker.m_planner = m_game->NewPlanner();
+    //Listeners carry no connection. EPOLLEXCLUSIVE wakes one idle worker
+    //per new connection instead of all of them
+    for (unsigned long l = 0; l < m_listeners.size(); l++) {
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.ptr = nullptr;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, m_listeners[l], &event);
+    }
+    epoll_event events[SERVER_MAX_EVENTS];
+    while (!m_stop) {
+        int ready = epoll_wait(epoll, events, SERVER_MAX_EVENTS, SERVER_WAIT_MS);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < ready; i++) {
+            //epoll reports a socket once per wait, and only its own event
+            //closes a connection, so the pointer is still good here
+            Connection* connection = static_cast<Connection*>(events[i].data.ptr);
+            if (connection == nullptr) {
+                Accept(worker);
+                continue;
+            }
+            uint32_t happened = events[i].events;
+            if ((happened & (EPOLLERR | EPOLLHUP)) != 0) {
+                Close(connection);
+            } else if ((happened & EPOLLIN) != 0) {
+                //ReadFrom sends the replies itself
+                ReadFrom(connection);
+            } else if ((happened & EPOLLOUT) != 0) {
+                WriteTo(connection);
+            }
+        }
+    }
+    close(epoll);
+    //Sessions still open only use these while stepping, and no worker
+    //steps them any more
+    delete worker.m_router;
+    delete worker.m_planner;
+}
+  // Name: Accept(Worker& worker)
+  // Description: Accepts one waiting connection onto worker and starts
+  //              its session. Listeners stay ready while connections
+  //              wait, so the rest wake whichever worker is idle.
+  // Preconditions: worker is the calling thread's worker.
+  // Postconditions: The connection, if any, has a session and is watched.
+void GameServer::Accept(Worker& worker) {
+    //There are at most two listeners, so try them until one has a
+    //connection; draining a backlog here would put it all on this worker
+    int fd = -1;
+    for (unsigned long l = 0; l < m_listeners.size() && fd < 0; l++) {
+        //Fails if nothing is waiting, another worker took it, or out of
+        //descriptors: try next time
+        fd = accept4(m_listeners[l], nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    }
+    if (fd < 0) {
+        return;
+    }
+    //Replies are small and a client waits for each one, so send them at
+    //once (this fails harmlessly on Unix sockets)
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    Connection* connection = new Connection();
+    connection->m_fd = fd;
+    connection->m_epoll = worker.m_epoll;
+    connection->m_sent = 0;
+    connection->m_quit = false;
+    connection->m_events = EPOLLIN;
+    //Starting the session sends the welcome and the first prompt
+    m_game->OpenSession(connection->m_session, m_seed + m_accepted++, &connection->m_out,
+                        &connection->m_input, worker.m_router, worker.m_planner, m_mode);
+    connection->m_quit = !m_game->StepSession(connection->m_session);
+    {
+        lock_guard<mutex> hold(m_connectionsLock);
+        if (static_cast<unsigned long>(fd) >= m_connections.size()) {
+            m_connections.resize(fd + 1, nullptr);
+        }
+        m_connections[fd] = connection;
+    }
+    int open = ++m_open;
+    int peak = m_peak;
+    while (open > peak && !m_peak.compare_exchange_weak(peak, open)) {}
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = connection;
+    if (epoll_ctl(worker.m_epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+        Close(connection);
+        return;
+    }
+    WriteTo(connection);
+}
+  // Name: ReadFrom(Connection* connection)
+  // Description: Reads what the socket holds, lets the session run as
+  //              far as that input takes it, then sends the replies.
+  // Preconditions: connection is open.
+  // Postconditions: Returns false if the connection was closed.
+bool GameServer::ReadFrom(Connection* connection) {
+    //One read per wakeup, so a busy client cannot starve the others
+    char buffer[SERVER_READ_BYTES];
+    ssize_t got = read(connection->m_fd, buffer, sizeof(buffer));
+    if (got < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return true;
+    } else if (got <= 0) {
+        Close(connection);
+        return false;
+    }
+    connection->m_input.Feed(buffer, static_cast<size_t>(got));
+    m_commands += count(buffer, buffer + got, '\n');
+    //The session reads every answer it was sent before it suspends again;
+    //only this worker steps it, so no lock is needed
+    bool more = m_game->StepSession(connection->m_session);
+    if (!more) {
+        connection->m_quit = true;
+    } else if (connection->m_input.GetBuffered() > SERVER_MAX_LINE) {
+        connection->m_out << "Line too long." << '\n';
+        connection->m_quit = true;
+    }
+    return WriteTo(connection);
+}
+  // Name: WriteTo(Connection* connection)
+  // Description: Writes unsent replies until the socket is full, then
+  //              watches for reads and writes to match what is left.
+  // Preconditions: connection is open.
+  // Postconditions: Returns false if the connection was closed.
+bool GameServer::WriteTo(Connection* connection) {
+    const string& text = connection->m_out.GetText();
+    while (connection->m_sent < text.size()) {
+        //MSG_NOSIGNAL: a client that hung up is an error here, not SIGPIPE
+        ssize_t sent = send(connection->m_fd, text.data() + connection->m_sent,
+                            text.size() - connection->m_sent, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && errno == EAGAIN) {
+            break;
+        } else if (sent < 0) {
+            Close(connection);
+            return false;
+        }
+        connection->m_sent += static_cast<size_t>(sent);
+    }
+    size_t pending = text.size() - connection->m_sent;
+    if (pending == 0) {
+        //Keeps the buffer's capacity for the next reply
+        connection->m_out.Clear();
+        connection->m_sent = 0;
+        if (connection->m_quit) {
+            Close(connection);
+            return false;
+        }
+    }
+    //Stop reading a client that does not read its replies
+    uint32_t events = 0;
+    if (!connection->m_quit && pending < SERVER_MAX_PENDING) {
+        events |= EPOLLIN;
+    }
+    if (pending > 0) {
+        events |= EPOLLOUT;
+    }
+    if (events != connection->m_events) {
+        Watch(connection, events);
+    }
+    return true;
+}
+  // Name: Watch(Connection* connection, uint32_t events)
+  // Description: Changes the events epoll reports for connection.
+  // Preconditions: connection is open.
+  // Postconditions: connection->m_events is events.
+void GameServer::Watch(Connection* connection, uint32_t events) {
+    epoll_event event;
+    event.events = events;
+    event.data.ptr = connection;
+    epoll_ctl(connection->m_epoll, EPOLL_CTL_MOD, connection->m_fd, &event);
+    connection->m_events = events;
+}
+  // Name: Close(Connection* connection)
+  // Description: Ends the session and closes the socket.
+  // Preconditions: connection is open.
+  // Postconditions: connection is freed.
+void GameServer::Close(Connection* connection) {
+    //Forget the fd before closing it, as another worker may reuse it
+    {
+        lock_guard<mutex> hold(m_connectionsLock);
+        m_connections[connection->m_fd] = nullptr;
+    }
+    //Closing the socket also removes it from the epoll set
+    close(connection->m_fd);
+    m_game->CloseSession(connection->m_session);
+    delete connection;
+    m_open--;
+    m_closed++;
+}
@@ -0,0 +1,175 @@
+#ifndef SERVER_H
+#define SERVER_H
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Game.h"
+#include "OutputSink.h"
+#include "Session.h"
+using namespace std;
+
+//Multi-session game server: one process loads the world once and serves
+//many players over loopback TCP or a Unix socket. Each worker thread runs
+//its own epoll loop over non-blocking sockets and takes one new
+//connection per wakeup, so a burst of connections is spread over the
+//workers; a connection stays on the worker that accepted it. Each
+//connection is a GameSession (its own hero, craft index, area and
+//game-loop coroutine) plus its SessionInput and unsent replies. A session
+//suspends whenever it waits for input, so an idle player costs a
+//coroutine frame, not a thread. Sessions only read the Game's world,
+//recipes and registry, and each worker lends its sessions its own router
+//and planner, so workers step their sessions in parallel with no lock.
+//
+//Sessions speak the script command language (Command.h), one command per
+//line, or the console's numbered menus (SESSION_MENUS). Every time the
+//game waits for input it sends SERVER_PROMPT, so a client knows when a
+//reply is complete. Quitting closes the connection once its reply is sent.
+
+const int SERVER_MAX_EVENTS = 256; //Events taken from epoll per wait
+const size_t SERVER_READ_BYTES = 1 << 14; //Bytes read from a socket per call
+const size_t SERVER_MAX_LINE = 1024; //Longest command line accepted
+const size_t SERVER_MAX_PENDING = 1 << 20; //Unsent reply bytes before a session is not read
+const int SERVER_WAIT_MS = 200; //Longest epoll wait, so Stop is noticed
+const char SERVER_PROMPT[] = "> "; //Ends every reply
+const int MAX_TCP_PORT = 65535; //Highest port ListenTcp accepts
+
+//Counters for a server run
+struct ServerStats {
+  long long m_accepted; //Connections accepted
+  long long m_closed; //Connections closed
+  long long m_commands; //Input lines received
+  int m_peak; //Most sessions open at once
+};
+
+class GameServer {
+public:
+  // Name: GameServer(Game& game, uint64_t seed, SessionMode mode)
+  // Description: Creates a server for game's loaded world whose sessions
+  //              run mode. Session n's hero is seeded with seed + n.
+  // Preconditions: game's world and recipes are loaded and checked, and
+  //                BuildRouter and BuildPlanner have run.
+  // Postconditions: Nothing is listening yet.
+  GameServer(Game& game, uint64_t seed, SessionMode mode);
+  // Name: ~GameServer()
+  // Description: Closes every session and listening socket.
+  // Preconditions: None.
+  // Postconditions: A Unix socket file made by ListenUnix is removed.
+  ~GameServer();
+  // Name: ListenTcp(int port, string& error)
+  // Description: Accepts TCP connections on 127.0.0.1:port.
+  // Preconditions: None (0 picks a free port).
+  // Postconditions: Returns false and sets error if port is not 0 to
+  //                 MAX_TCP_PORT or cannot be bound; GetTcpPort reports
+  //                 the port in use.
+  bool ListenTcp(int port, string& error);
+  // Name: ListenUnix(const string& path, string& error)
+  // Description: Accepts connections on a Unix socket at path
+  //              (replacing a stale socket file there).
+  // Preconditions: None.
+  // Postconditions: Returns false and sets error if it cannot be bound.
+  bool ListenUnix(const string& path, string& error);
+  // Name: GetTcpPort() const
+  // Description: Port ListenTcp bound.
+  // Preconditions: None.
+  // Postconditions: Returns the port, or -1 if not listening on TCP.
+  int GetTcpPort() const;
+  // Name: Run(int workers)
+  // Description: Serves connections on workers threads (the calling
+  //              thread is one of them) until Stop is called.
+  // Preconditions: ListenTcp or ListenUnix succeeded; workers >= 0
+  //                (0 = one per hardware thread).
+  // Postconditions: Every session is closed.
+  void Run(int workers);
+  // Name: Stop()
+  // Description: Asks Run to return (safe from a signal handler).
+  // Preconditions: None.
+  // Postconditions: Run returns within SERVER_WAIT_MS.
+  void Stop();
+  // Name: GetStats() const
+  // Description: Counters so far.
+  // Preconditions: None.
+  // Postconditions: Returns a copy of the counters.
+  ServerStats GetStats() const;
+private:
+  //One worker thread's event queue and the search engines its sessions use
+  struct Worker {
+    int m_epoll; //Event queue of the worker's listeners and connections
+    Router* m_router; //Route engine lent to the worker's sessions (owned)
+    CraftPlanner* m_planner; //Planner lent to the worker's sessions (owned)
+  };
+  //One client connection
+  struct Connection {
+    // Name: Connection()
+    // Description: Makes the connection's input, prompting into m_out.
+    // Preconditions: None.
+    // Postconditions: Nothing is buffered or sent.
+    Connection() : m_input(&m_out, SERVER_PROMPT) {}
+    int m_fd; //Non-blocking socket
+    int m_epoll; //Event queue of the worker serving it
+    GameSession m_session; //The player's hero, index, area and game loop
+    CaptureSink m_out; //Replies; m_out[m_sent..] is not sent yet
+    SessionInput m_input; //Received bytes the game has not read yet
+    size_t m_sent; //Reply bytes already written to the socket
+    bool m_quit; //Close once the replies are sent
+    uint32_t m_events; //Events epoll is watching for
+  };
+  // Name: AddListener(int fd, string& error)
+  // Description: Starts listening on a bound socket.
+  // Preconditions: fd is bound.
+  // Postconditions: Returns false, closing fd, if it cannot listen.
+  bool AddListener(int fd, string& error);
+  // Name: Serve()
+  // Description: One worker: watches every listener and the connections
+  //              it accepts until Stop is called.
+  // Preconditions: Run is running.
+  // Postconditions: The worker's event queue is closed (its connections
+  //                 stay open for Run to close).
+  void Serve();
+  // Name: Accept(Worker& worker)
+  // Description: Accepts one waiting connection onto worker and starts
+  //              its session. Listeners stay ready while connections
+  //              wait, so the rest wake whichever worker is idle.
+  // Preconditions: worker is the calling thread's worker.
+  // Postconditions: The connection, if any, has a session and is watched.
+  void Accept(Worker& worker);
+  // Name: ReadFrom(Connection* connection)
+  // Description: Reads what the socket holds, lets the session run as
+  //              far as that input takes it, then sends the replies.
+  // Preconditions: connection is open.
+  // Postconditions: Returns false if the connection was closed.
+  bool ReadFrom(Connection* connection);
+  // Name: WriteTo(Connection* connection)
+  // Description: Writes unsent replies until the socket is full, then
+  //              watches for reads and writes to match what is left.
+  // Preconditions: connection is open.
+  // Postconditions: Returns false if the connection was closed.
+  bool WriteTo(Connection* connection);
+  // Name: Watch(Connection* connection, uint32_t events)
+  // Description: Changes the events epoll reports for connection.
+  // Preconditions: connection is open.
+  // Postconditions: connection->m_events is events.
+  void Watch(Connection* connection, uint32_t events);
+  // Name: Close(Connection* connection)
+  // Description: Ends the session and closes the socket.
+  // Preconditions: connection is open.
+  // Postconditions: connection is freed.
+  void Close(Connection* connection);
+  Game* m_game; //Shared world and rules
+  uint64_t m_seed; //Seed of session 0's hero
+  SessionMode m_mode; //What every session runs
+  vector<int> m_listeners; //Listening sockets
+  vector<Connection*> m_connections; //Open connection per fd (nullptr = none)
+  mutex m_connectionsLock; //Guards m_connections
+  int m_tcpPort; //Port bound by ListenTcp (-1 = none)
+  string m_unixPath; //Socket file made by ListenUnix
+  atomic<bool> m_stop; //Set by Stop
+  atomic<long long> m_accepted; //Connections accepted
+  atomic<long long> m_closed; //Connections closed
+  atomic<long long> m_commands; //Input lines received
+  atomic<int> m_open; //Open connections
+  atomic<int> m_peak; //Most connections open at once
+};
+
+#endif
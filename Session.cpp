@@ -0,0 +1,101 @@
+#include "Session.h"
+
+const size_t SESSION_COMPACT_BYTES = 4096; //Read bytes dropped from the buffer at once
+
+  // Name: SessionInput(istream& stream)
+  // Description: Input answered straight from stream (never suspends).
+  // Preconditions: stream outlives the input.
+  // Postconditions: Reads use stream.
+SessionInput::SessionInput(istream& stream)
+    : m_stream(&stream), m_out(nullptr), m_pos(0), m_waiting(nullptr), m_retry(nullptr),
+      m_awaiter(nullptr) {}
+  // Name: SessionInput(OutputSink* out, const string& prompt)
+  // Description: Input fed with Feed. Every read first writes prompt to
+  //              out, so a client can tell the game is waiting for it.
+  // Preconditions: out outlives the input.
+  // Postconditions: Nothing is buffered.
+SessionInput::SessionInput(OutputSink* out, const string& prompt)
+    : m_stream(nullptr), m_out(out), m_prompt(prompt), m_pos(0), m_waiting(nullptr),
+      m_retry(nullptr), m_awaiter(nullptr) {}
+  // Name: ReadLine(string& line)
+  // Description: Awaitable read of the rest of the line into line.
+  // Preconditions: Called inside a SessionTask.
+  // Postconditions: line is filled when the co_await completes.
+SessionInput::ReadAwaiter<string> SessionInput::ReadLine(string& line) {
+    if (m_out != nullptr) {
+        *m_out << m_prompt;
+    }
+    return ReadAwaiter<string>{this, &line, true};
+}
+  // Name: Feed(const char* data, size_t size)
+  // Description: Adds received text.
+  // Preconditions: The input was made with a prompt, not a stream.
+  // Postconditions: The text is buffered.
+void SessionInput::Feed(const char* data, size_t size) {
+    m_buffer.append(data, size);
+}
+  // Name: TakeReady()
+  // Description: Finishes the suspended read if the buffer now answers
+  //              it and hands back the coroutine to resume.
+  // Preconditions: None.
+  // Postconditions: Returns the coroutine (no longer waiting), or a
+  //                 null handle if nothing can continue yet.
+coroutine_handle<> SessionInput::TakeReady() {
+    if (!m_waiting || !m_retry(m_awaiter)) {
+        return nullptr;
+    }
+    coroutine_handle<> ready = m_waiting;
+    m_waiting = nullptr;
+    return ready;
+}
+  // Name: GetBuffered() const
+  // Description: Bytes received but not read yet.
+  // Preconditions: None.
+  // Postconditions: Returns the count.
+size_t SessionInput::GetBuffered() const {
+    return m_buffer.size() - m_pos;
+}
+  // Name: TryReadLine(string& line)
+  // Description: Reads the rest of the line (without its newline) if
+  //              the input can answer now.
+  // Preconditions: None.
+  // Postconditions: Returns false, consuming nothing, if no newline has
+  //                 arrived.
+bool SessionInput::TryReadLine(string& line) {
+    if (m_stream != nullptr) {
+        getline(*m_stream, line);
+        return true;
+    }
+    size_t newline = m_buffer.find('\n', m_pos);
+    if (newline == string::npos) {
+        return false;
+    }
+    //Telnet-style clients end lines with "\r\n"
+    size_t end = newline > m_pos && m_buffer[newline - 1] == '\r' ? newline - 1 : newline;
+    line.assign(m_buffer, m_pos, end - m_pos);
+    Consume(newline + 1);
+    return true;
+}
+  // Name: Wait(coroutine_handle<> waiting, bool (*retry)(void*), void* awaiter)
+  // Description: Records the suspended read.
+  // Preconditions: No other read is waiting.
+  // Postconditions: TakeReady will retry it.
+void SessionInput::Wait(coroutine_handle<> waiting, bool (*retry)(void*), void* awaiter) {
+    m_waiting = waiting;
+    m_retry = retry;
+    m_awaiter = awaiter;
+}
+  // Name: Consume(size_t end)
+  // Description: Marks the buffer up to end as read.
+  // Preconditions: m_pos <= end <= m_buffer.size().
+  // Postconditions: Read text is dropped once it is most of the buffer.
+void SessionInput::Consume(size_t end) {
+    m_pos = end;
+    if (m_pos == m_buffer.size()) {
+        m_buffer.clear();
+        m_pos = 0;
+    } else if (m_pos >= SESSION_COMPACT_BYTES && m_pos * 2 >= m_buffer.size()) {
+        m_buffer.erase(0, m_pos);
+        m_pos = 0;
+    }
+}
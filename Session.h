@@ -0,0 +1,242 @@
+#ifndef SESSION_H
+#define SESSION_H
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include "OutputSink.h"
+using namespace std;
+
+//Coroutine support for the prompt-driven game loops. Game::Action, Move,
+//CraftItem and friends are SessionTask coroutines that read their input
+//with co_await SessionInput::Read instead of cin >>, so the same code
+//serves two kinds of input:
+//  - a stream (the console): every read is answered at once from the
+//    stream, so nothing ever suspends and the menus run as plain calls
+//  - a buffer fed from a socket (see Server.h): a read that the buffered
+//    text cannot answer yet suspends the whole session, and whoever feeds
+//    more text resumes it with TakeReady
+//A suspended session is a few heap frames, not a thread, so a server can
+//hold tens of thousands of them on a handful of workers.
+
+//Coroutine type of the session loops. Tasks are lazy: calling one only
+//creates its frame. co_await on a task runs it and continues the caller
+//when it finishes; the outermost task is started with Start, and after
+//that resumed from wherever it waits for input (SessionInput::TakeReady).
+//Frames are freed with the task.
+class SessionTask {
+public:
+  struct promise_type;
+  typedef coroutine_handle<promise_type> Handle;
+  //Ending a task resumes whoever awaited it (directly, without growing
+  //the stack), or returns to the resume call for the outermost task
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    coroutine_handle<> await_suspend(Handle finished) noexcept {
+      coroutine_handle<> next = finished.promise().m_continuation;
+      return next ? next : noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+  };
+  struct promise_type {
+    coroutine_handle<> m_continuation; //Coroutine awaiting this one (null = none)
+    SessionTask get_return_object() { return SessionTask(Handle::from_promise(*this)); }
+    suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void return_void() const {}
+    void unhandled_exception() const { terminate(); }
+  };
+  // Name: SessionTask()
+  // Description: Creates a task with no coroutine.
+  // Preconditions: None.
+  // Postconditions: IsDone() is true.
+  SessionTask() : m_handle(nullptr) {}
+  // Name: SessionTask(SessionTask&& other)
+  // Description: Takes over other's coroutine.
+  // Preconditions: None.
+  // Postconditions: other holds no coroutine.
+  SessionTask(SessionTask&& other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; }
+  // Name: operator=(SessionTask&& other)
+  // Description: Frees this task's coroutine and takes over other's.
+  // Preconditions: None.
+  // Postconditions: other holds no coroutine.
+  SessionTask& operator=(SessionTask&& other) noexcept {
+    if (this != &other) {
+      Destroy();
+      m_handle = other.m_handle;
+      other.m_handle = nullptr;
+    }
+    return *this;
+  }
+  SessionTask(const SessionTask&) = delete;
+  SessionTask& operator=(const SessionTask&) = delete;
+  // Name: ~SessionTask()
+  // Description: Frees the coroutine frame, even mid-run (a session that
+  //              disconnects while waiting for input just goes away).
+  // Preconditions: The coroutine is not running.
+  // Postconditions: The frame is freed.
+  ~SessionTask() { Destroy(); }
+  // Name: Start()
+  // Description: Runs the task until it first waits for input or ends.
+  // Preconditions: The task was not started.
+  // Postconditions: The task is suspended in a read, or IsDone().
+  void Start() { m_handle.resume(); }
+  // Name: IsDone() const
+  // Description: Reports whether the task has returned.
+  // Preconditions: None.
+  // Postconditions: Returns true if it ended (or there is none).
+  bool IsDone() const { return !m_handle || m_handle.done(); }
+  // Name: await_ready, await_suspend, await_resume
+  // Description: co_await task runs task, then continues the awaiter.
+  // Preconditions: The task was not started.
+  // Postconditions: The awaiter resumes once task returns.
+  bool await_ready() const noexcept { return false; }
+  coroutine_handle<> await_suspend(coroutine_handle<> awaiting) noexcept {
+    m_handle.promise().m_continuation = awaiting;
+    return m_handle;
+  }
+  void await_resume() const noexcept {}
+private:
+  explicit SessionTask(Handle handle) : m_handle(handle) {}
+  void Destroy() {
+    if (m_handle) {
+      m_handle.destroy();
+      m_handle = nullptr;
+    }
+  }
+  Handle m_handle; //The coroutine (owned)
+};
+
+//Input of one session: a stream, or text fed in as it arrives. Reads
+//follow operator>> (a word, or one character for char) and getline.
+class SessionInput {
+public:
+  //co_await input.Read(value): fills value, suspending until it can
+  template <typename T>
+  struct ReadAwaiter {
+    SessionInput* m_input; //Input read from
+    T* m_value; //Where the value goes
+    bool m_line; //Read the rest of the line (T is string)
+    bool await_ready() { return m_input->TryRead(*m_value, m_line); }
+    void await_suspend(coroutine_handle<> waiting) {
+      m_input->Wait(waiting, &ReadAwaiter::Retry, this);
+    }
+    void await_resume() const {}
+    // Name: Retry(void* awaiter)
+    // Description: Tries the suspended read again after more input.
+    // Preconditions: awaiter is the suspended ReadAwaiter.
+    // Postconditions: Returns true once the value is filled.
+    static bool Retry(void* awaiter) {
+      ReadAwaiter* self = static_cast<ReadAwaiter*>(awaiter);
+      return self->m_input->TryRead(*self->m_value, self->m_line);
+    }
+  };
+  // Name: SessionInput(istream& stream)
+  // Description: Input answered straight from stream (never suspends).
+  // Preconditions: stream outlives the input.
+  // Postconditions: Reads use stream.
+  SessionInput(istream& stream);
+  // Name: SessionInput(OutputSink* out, const string& prompt)
+  // Description: Input fed with Feed. Every read first writes prompt to
+  //              out, so a client can tell the game is waiting for it.
+  // Preconditions: out outlives the input.
+  // Postconditions: Nothing is buffered.
+  SessionInput(OutputSink* out, const string& prompt);
+  // Name: Read(T& value)
+  // Description: Awaitable read of a word (or char, or number) into value.
+  // Preconditions: Called inside a SessionTask.
+  // Postconditions: value is filled when the co_await completes.
+  template <typename T>
+  ReadAwaiter<T> Read(T& value) {
+    if (m_out != nullptr) {
+      *m_out << m_prompt;
+    }
+    return ReadAwaiter<T>{this, &value, false};
+  }
+  // Name: ReadLine(string& line)
+  // Description: Awaitable read of the rest of the line into line.
+  // Preconditions: Called inside a SessionTask.
+  // Postconditions: line is filled when the co_await completes.
+  ReadAwaiter<string> ReadLine(string& line);
+  // Name: Feed(const char* data, size_t size)
+  // Description: Adds received text.
+  // Preconditions: The input was made with a prompt, not a stream.
+  // Postconditions: The text is buffered.
+  void Feed(const char* data, size_t size);
+  // Name: TakeReady()
+  // Description: Finishes the suspended read if the buffer now answers
+  //              it and hands back the coroutine to resume.
+  // Preconditions: None.
+  // Postconditions: Returns the coroutine (no longer waiting), or a
+  //                 null handle if nothing can continue yet.
+  coroutine_handle<> TakeReady();
+  // Name: GetBuffered() const
+  // Description: Bytes received but not read yet.
+  // Preconditions: None.
+  // Postconditions: Returns the count.
+  size_t GetBuffered() const;
+private:
+  // Name: TryRead(T& value, bool line)
+  // Description: Reads value (a whole line if line is set) if the input
+  //              can answer now.
+  // Preconditions: line only for a string.
+  // Postconditions: Returns false, consuming nothing, if the buffer
+  //                 does not yet hold a whole word (or line).
+  template <typename T>
+  bool TryRead(T& value, bool line) {
+    if constexpr (is_same<T, string>::value) {
+      if (line) {
+        return TryReadLine(value);
+      }
+    }
+    if (m_stream != nullptr) {
+      *m_stream >> value;
+      return true;
+    }
+    //A word is whole once whitespace follows it; a char needs only itself
+    size_t start = m_buffer.find_first_not_of(" \t\r\n", m_pos);
+    if (start == string::npos) {
+      return false;
+    }
+    size_t end = is_same<T, char>::value ? start + 1 : m_buffer.find_first_of(" \t\r\n", start);
+    if (end == string::npos) {
+      return false;
+    }
+    //A word that is not a T reads as T() instead of jamming the input
+    istringstream word(m_buffer.substr(start, end - start));
+    value = T();
+    word >> value;
+    Consume(end);
+    return true;
+  }
+  // Name: TryReadLine(string& line)
+  // Description: Reads the rest of the line (without its newline) if
+  //              the input can answer now.
+  // Preconditions: None.
+  // Postconditions: Returns false, consuming nothing, if no newline has
+  //                 arrived.
+  bool TryReadLine(string& line);
+  // Name: Wait(coroutine_handle<> waiting, bool (*retry)(void*), void* awaiter)
+  // Description: Records the suspended read.
+  // Preconditions: No other read is waiting.
+  // Postconditions: TakeReady will retry it.
+  void Wait(coroutine_handle<> waiting, bool (*retry)(void*), void* awaiter);
+  // Name: Consume(size_t end)
+  // Description: Marks the buffer up to end as read.
+  // Preconditions: m_pos <= end <= m_buffer.size().
+  // Postconditions: Read text is dropped once it is most of the buffer.
+  void Consume(size_t end);
+  istream* m_stream; //Stream answering every read (null = fed)
+  OutputSink* m_out; //Where prompts go (null = no prompt)
+  string m_prompt; //Written before every read
+  string m_buffer; //Fed text; m_buffer[m_pos..] is unread
+  size_t m_pos; //First unread byte
+  coroutine_handle<> m_waiting; //Coroutine suspended in a read (null = none)
+  bool (*m_retry)(void*); //Retries the suspended read
+  void* m_awaiter; //The suspended read's awaiter
+};
+
+#endif
@@ -0,0 +1,233 @@
+#include "Simulation.h"
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+// Name: EmptyStats(int itemCount)
+// Description: Zeroed counters for itemCount items.
+// Preconditions: itemCount >= 0.
+// Postconditions: Returns the counters.
+static SimStats EmptyStats(int itemCount) {
+    SimStats stats = SimStats();
+    stats.m_items.assign(itemCount, SimItemStats{0, 0, 0, 0, -1, -1});
+    return stats;
+}
+
+// Name: MergeStats(SimStats& total, const SimStats& part)
+// Description: Adds one range's counters into the totals.
+// Preconditions: Both cover the same items.
+// Postconditions: total includes part.
+static void MergeStats(SimStats& total, const SimStats& part) {
+    total.m_steps += part.m_steps;
+    total.m_moves += part.m_moves;
+    total.m_gathers += part.m_gathers;
+    total.m_emptyGathers += part.m_emptyGathers;
+    total.m_crafts += part.m_crafts;
+    total.m_idleCrafts += part.m_idleCrafts;
+    for (unsigned long i = 0; i < total.m_items.size(); i++) {
+        SimItemStats& to = total.m_items[i];
+        const SimItemStats& from = part.m_items[i];
+        to.m_found += from.m_found;
+        to.m_crafted += from.m_crafted;
+        to.m_firstAgents += from.m_firstAgents;
+        to.m_firstStepSum += from.m_firstStepSum;
+        if (from.m_firstStepMin >= 0 && (to.m_firstStepMin < 0 || from.m_firstStepMin < to.m_firstStepMin)) {
+            to.m_firstStepMin = from.m_firstStepMin;
+        }
+        if (from.m_firstStepMax > to.m_firstStepMax) {
+            to.m_firstStepMax = from.m_firstStepMax;
+        }
+    }
+}
+
+// Name: ParseSimScript(const string& text, vector<SimAction>& script)
+// Description: Parses a comma-separated action list such as
+//              "raw,natural,craft,move".
+// Preconditions: None.
+// Postconditions: Returns false (script unspecified) on an unknown or
+//                 empty action; otherwise script holds the actions.
+bool ParseSimScript(const string& text, vector<SimAction>& script) {
+    script.clear();
+    stringstream input(text);
+    string name;
+    while (getline(input, name, ',')) {
+        if (name == "move") {
+            script.push_back(SIM_MOVE);
+        } else if (name == "raw") {
+            script.push_back(SIM_RAW);
+        } else if (name == "natural") {
+            script.push_back(SIM_NATURAL);
+        } else if (name == "food") {
+            script.push_back(SIM_FOOD);
+        } else if (name == "hunt") {
+            script.push_back(SIM_HUNT);
+        } else if (name == "craft") {
+            script.push_back(SIM_CRAFT);
+        } else {
+            return false;
+        }
+    }
+    return !script.empty();
+}
+
+// Name: RunAgent(...)
+// Description: Plays one agent and adds its counters to stats.
+// Preconditions: As RunSimulation; crafted has one entry per ItemId.
+// Postconditions: stats includes the agent; crafted is left cleared.
+static void RunAgent(int agent, const World& world, const vector<Item*>& items,
+                     const ItemRegistry& registry, const SimConfig& config,
+                     const CraftIndex& prototype, vector<char>& crafted, SimStats& stats) {
+    //Random seeds each engine through SplitMix64, so seed + agent is enough
+    CraftIndex index(prototype);
+    Hero hero("Agent " + to_string(agent), registry, config.m_seed + agent);
+    Random& random = hero.GetRandom();
+    NullSink quiet;
+    hero.SetOutput(&quiet);
+    hero.SetCraftIndex(&index);
+    int area = 0;
+    for (int step = 0; step < config.m_steps; step++) {
+        //Choose the action
+        SimAction action;
+        if (config.m_policy == POLICY_SCRIPT) {
+            action = config.m_script[step % config.m_script.size()];
+        } else if (config.m_policy == POLICY_GREEDY && !index.GetCraftable().empty()) {
+            action = SIM_CRAFT;
+        } else if (config.m_policy == POLICY_GREEDY) {
+            action = static_cast<SimAction>(SIM_RAW + random.Below(SIM_HUNT - SIM_RAW + 1));
+        } else {
+            action = static_cast<SimAction>(random.Below(SIM_CRAFT + 1));
+        }
+        stats.m_steps++;
+        if (action == SIM_MOVE) {
+            int count = 0;
+            const int32_t *next = world.GetNeighbors(area, count);
+            if (count > 0) {
+                area = next[random.Below(count)];
+                stats.m_moves++;
+            }
+        } else if (action == SIM_CRAFT) {
+            const vector<int>& craftable = index.GetCraftable();
+            if (craftable.empty()) {
+                stats.m_idleCrafts++;
+                continue;
+            }
+            //The set is unordered, so a random slot is a random recipe
+            int recipe = craftable[random.Below(static_cast<uint32_t>(craftable.size()))];
+            ItemId made = items[recipe]->GetID();
+            hero.Craft(*items[recipe], 1);
+            stats.m_crafts++;
+            SimItemStats& item = stats.m_items[made];
+            item.m_crafted++;
+            if (!crafted[made]) {
+                crafted[made] = 1;
+                item.m_firstAgents++;
+                item.m_firstStepSum += step;
+                if (item.m_firstStepMin < 0 || step < item.m_firstStepMin) {
+                    item.m_firstStepMin = step;
+                }
+                if (step > item.m_firstStepMax) {
+                    item.m_firstStepMax = step;
+                }
+            }
+        } else {
+            ItemId found;
+            if (action == SIM_RAW) {
+                found = hero.Raw();
+            } else if (action == SIM_NATURAL) {
+                found = hero.Natural();
+            } else if (action == SIM_FOOD) {
+                found = hero.Food();
+            } else {
+                found = hero.Hunt();
+            }
+            stats.m_gathers++;
+            if (found == NO_ITEM) {
+                stats.m_emptyGathers++;
+            } else {
+                stats.m_items[found].m_found++;
+            }
+        }
+    }
+    //Reset the first-craft marks for the next agent of this range
+    for (unsigned long i = 0; i < items.size(); i++) {
+        crafted[items[i]->GetID()] = 0;
+    }
+}
+
+// Name: RunSimulation(const World& world, const vector<Item*>& items,
+//                     const ItemRegistry& registry, const SimConfig& config,
+//                     ThreadPool& pool)
+// Description: Plays config.m_agents agents for config.m_steps actions
+//              each, starting in area 0, on pool.
+// Preconditions: world is checked and non-empty; items come from
+//                registry; POLICY_SCRIPT has a non-empty script.
+// Postconditions: Returns the summed counters and the wall time.
+SimStats RunSimulation(const World& world, const vector<Item*>& items,
+                       const ItemRegistry& registry, const SimConfig& config,
+                       ThreadPool& pool) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int itemCount = registry.GetSize();
+    //Agents copy this instead of rebuilding the inverted index
+    CraftIndex prototype(items, itemCount);
+    SimStats total = EmptyStats(itemCount);
+    mutex totalLock;
+    //Halve a range onto the pool (where idle workers can steal it) until
+    //it is small, then play it and merge once
+    function<void(int, int)> runRange = [&](int first, int last) {
+        while (last - first > SIM_RANGE_AGENTS) {
+            int middle = first + (last - first) / 2;
+            pool.Submit([&runRange, middle, last]() { runRange(middle, last); });
+            last = middle;
+        }
+        SimStats part = EmptyStats(itemCount);
+        vector<char> crafted(itemCount, 0);
+        for (int agent = first; agent < last; agent++) {
+            RunAgent(agent, world, items, registry, config, prototype, crafted, part);
+        }
+        lock_guard<mutex> guard(totalLock);
+        MergeStats(total, part);
+    };
+    pool.Submit([&runRange, &config]() { runRange(0, config.m_agents); });
+    pool.Wait();
+    total.m_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return total;
+}
+
+// Name: PrintSimStats(ostream& out, const SimStats& stats,
+//                     const ItemRegistry& registry, const SimConfig& config)
+// Description: Prints throughput, action mix and the per-item table
+//              (finds per 1000 gathers, crafts, time to first craft).
+// Preconditions: stats came from RunSimulation with config.
+// Postconditions: The report is written to out.
+void PrintSimStats(ostream& out, const SimStats& stats, const ItemRegistry& registry,
+                   const SimConfig& config) {
+    double seconds = stats.m_seconds > 0 ? stats.m_seconds : 1e-9;
+    out << fixed << setprecision(1);
+    out << "Simulated " << config.m_agents << " agents x " << config.m_steps << " steps in "
+        << setprecision(3) << seconds << " s" << endl;
+    out << setprecision(0) << "Throughput: " << stats.m_steps / seconds << " steps/s, "
+        << config.m_agents * 60.0 / seconds << " sessions/min" << endl;
+    out << "Actions: " << stats.m_moves << " moves, " << stats.m_gathers << " gathers ("
+        << stats.m_emptyGathers << " empty), " << stats.m_crafts << " crafts ("
+        << stats.m_idleCrafts << " with nothing craftable)" << endl;
+    out << left << setw(24) << "Item" << right << setw(14) << "found/1k" << setw(12) << "crafted"
+        << setw(10) << "agents" << setw(12) << "first avg" << setw(8) << "min" << setw(8) << "max" << endl;
+    const vector<ItemId>& ordered = registry.GetSortedIds();
+    for (unsigned long i = 0; i < ordered.size(); i++) {
+        const SimItemStats& item = stats.m_items[ordered[i]];
+        if (item.m_found == 0 && item.m_crafted == 0) {
+            continue;
+        }
+        double perThousand = stats.m_gathers > 0 ? item.m_found * 1000.0 / stats.m_gathers : 0;
+        out << left << setw(24) << registry.GetName(ordered[i]) << right << setw(14) << setprecision(2)
+            << perThousand << setw(12) << item.m_crafted << setw(10) << item.m_firstAgents;
+        if (item.m_firstAgents > 0) {
+            out << setw(12) << setprecision(1) << static_cast<double>(item.m_firstStepSum) / item.m_firstAgents
+                << setw(8) << item.m_firstStepMin << setw(8) << item.m_firstStepMax;
+        } else {
+            out << setw(12) << "-" << setw(8) << "-" << setw(8) << "-";
+        }
+        out << endl;
+    }
+}
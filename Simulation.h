@@ -0,0 +1,101 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Hero.h"
+#include "Item.h"
+#include "ItemRegistry.h"
+#include "CraftIndex.h"
+#include "ThreadPool.h"
+#include "World.h"
+using namespace std;
+
+//Headless balance testing: thousands of silent Hero agents play the
+//loaded world at once. Each agent's hero owns its random engine (seeded
+//from the run seed plus its number) and its own CraftIndex, so agents
+//share nothing but the read-only world and recipes. Agents are split into
+//ranges that split again on the work-stealing ThreadPool; each range
+//adds its counters into the totals once at the end. Results do not
+//depend on the thread count.
+
+const int SIM_RANGE_AGENTS = 32; //Agents a task runs itself instead of splitting
+
+//What an agent does with one step
+enum SimAction {
+  SIM_MOVE,    //Walk through a random exit
+  SIM_RAW,     //Hero::Raw
+  SIM_NATURAL, //Hero::Natural
+  SIM_FOOD,    //Hero::Food
+  SIM_HUNT,    //Hero::Hunt
+  SIM_CRAFT    //Craft one craftable item (a wasted step if none)
+};
+
+//How an agent picks its next action
+enum SimPolicy {
+  POLICY_RANDOM, //Any action, uniformly
+  POLICY_GREEDY, //Craft whenever possible, otherwise gather
+  POLICY_SCRIPT  //Repeat SimConfig::m_script
+};
+
+//Settings for one simulation run
+struct SimConfig {
+  int m_agents; //Number of agents (sessions)
+  int m_steps; //Actions per agent
+  SimPolicy m_policy; //Action choice
+  vector<SimAction> m_script; //Actions cycled by POLICY_SCRIPT
+  uint64_t m_seed; //Run seed; agent i uses seed + i
+};
+
+//Counters for one item
+struct SimItemStats {
+  long long m_found; //Times a gather produced it
+  long long m_crafted; //Times it was crafted
+  long long m_firstAgents; //Agents that crafted it at least once
+  long long m_firstStepSum; //Sum of those agents' first-craft steps
+  int m_firstStepMin; //Earliest first craft (-1 = never)
+  int m_firstStepMax; //Latest first craft (-1 = never)
+};
+
+//Totals for a run (or one agent range before merging)
+struct SimStats {
+  long long m_steps; //Actions taken
+  long long m_moves; //Successful moves
+  long long m_gathers; //Gather actions
+  long long m_emptyGathers; //Gathers that found nothing
+  long long m_crafts; //Successful crafts
+  long long m_idleCrafts; //Craft actions with nothing craftable
+  vector<SimItemStats> m_items; //Per ItemId
+  double m_seconds; //Wall time of the run
+};
+
+// Name: ParseSimScript(const string& text, vector<SimAction>& script)
+// Description: Parses a comma-separated action list such as
+//              "raw,natural,craft,move".
+// Preconditions: None.
+// Postconditions: Returns false (script unspecified) on an unknown or
+//                 empty action; otherwise script holds the actions.
+bool ParseSimScript(const string& text, vector<SimAction>& script);
+
+// Name: RunSimulation(const World& world, const vector<Item*>& items,
+//                     const ItemRegistry& registry, const SimConfig& config,
+//                     ThreadPool& pool)
+// Description: Plays config.m_agents agents for config.m_steps actions
+//              each, starting in area 0, on pool.
+// Preconditions: world is checked and non-empty; items come from
+//                registry; POLICY_SCRIPT has a non-empty script.
+// Postconditions: Returns the summed counters and the wall time.
+SimStats RunSimulation(const World& world, const vector<Item*>& items,
+                       const ItemRegistry& registry, const SimConfig& config,
+                       ThreadPool& pool);
+
+// Name: PrintSimStats(ostream& out, const SimStats& stats,
+//                     const ItemRegistry& registry, const SimConfig& config)
+// Description: Prints throughput, action mix and the per-item table
+//              (finds per 1000 gathers, crafts, time to first craft).
+// Preconditions: stats came from RunSimulation with config.
+// Postconditions: The report is written to out.
+void PrintSimStats(ostream& out, const SimStats& stats, const ItemRegistry& registry,
+                   const SimConfig& config);
+
+#endif
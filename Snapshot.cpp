@@ -0,0 +1,230 @@
+#include "Snapshot.h"
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+const size_t MAX_INT_VARINT_BYTES = 5; //A non-negative int takes at most 5
+
+// Name: WriteFile(const string& path, const string& bytes, string& error)
+// Description: Writes bytes to path + ".tmp", then renames it over path.
+// Preconditions: None.
+// Postconditions: Returns false and sets error if either step failed
+//                 (path is then left as it was).
+static bool WriteFile(const string& path, const string& bytes, string& error) {
+    //Plain system calls: this runs after every command
+    string temp = path + ".tmp";
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error = "cannot write " + temp;
+        return false;
+    }
+    ssize_t written = write(fd, bytes.data(), bytes.size());
+    bool closed = close(fd) == 0;
+    if (written != static_cast<ssize_t>(bytes.size()) || !closed) {
+        error = "cannot write " + temp;
+        return false;
+    }
+    if (rename(temp.c_str(), path.c_str()) != 0) {
+        error = "cannot replace " + path;
+        return false;
+    }
+    return true;
+}
+
+  // Name: SnapshotStore(const ItemRegistry& registry)
+  // Description: Creates a store that encodes inventories against
+  //              registry's item table.
+  // Preconditions: registry outlives the store.
+  // Postconditions: The store is ready.
+SnapshotStore::SnapshotStore(const ItemRegistry& registry) : m_registry(&registry) {}
+  // Name: Encode(const Hero& hero, int area, const JournalMark& mark, string& bytes)
+  // Description: Builds the snapshot of hero standing in area, taken at
+  //              mark.
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: bytes holds the snapshot (its buffer is reused).
+void SnapshotStore::Encode(const Hero& hero, int area, const JournalMark& mark, string& bytes) {
+    const vector<int>& inventory = hero.GetInventory();
+    const string& name = hero.GetName();
+    uint64_t held = 0;
+    for (unsigned long i = 0; i < inventory.size(); i++) {
+        held += inventory[i] >= 0 ? 1 : 0;
+    }
+    //Size for the longest encoding, then trim to what was written
+    bytes.resize(sizeof(SNAPSHOT_MAGIC) + 2 * FIXED64_BYTES + 6 * MAX_VARINT_BYTES + name.size()
+                 + held * 2 * MAX_INT_VARINT_BYTES);
+    char *out = &bytes[0];
+    memcpy(out, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    out += sizeof(SNAPSHOT_MAGIC);
+    out = PutVarint(out, SNAPSHOT_VERSION);
+    out = PutVarint(out, static_cast<uint64_t>(m_registry->GetSize()));
+    out = PutFixed64(out, m_registry->GetTableHash());
+    out = PutVarint(out, name.size());
+    memcpy(out, name.data(), name.size());
+    out += name.size();
+    out = PutVarint(out, static_cast<uint64_t>(area));
+    out = PutFixed64(out, mark.m_id);
+    out = PutVarint(out, mark.m_offset);
+    out = PutVarint(out, held);
+    //Held items in id order, each as the gap from the previous id
+    long previous = -1;
+    for (unsigned long i = 0; i < inventory.size(); i++) {
+        if (inventory[i] >= 0) {
+            out = PutVarint(out, static_cast<uint64_t>(static_cast<long>(i) - previous - 1));
+            out = PutVarint(out, static_cast<uint64_t>(inventory[i]));
+            previous = static_cast<long>(i);
+        }
+    }
+    bytes.resize(static_cast<size_t>(out - bytes.data()));
+}
+  // Name: Decode(string_view bytes, int areaCount, Hero& hero, int& area,
+  //              JournalMark& mark, string& error)
+  // Description: Checks a snapshot completely, then gives its name and
+  //              inventory to hero, its area to area and its journal
+  //              position to mark.
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: Returns true on success; otherwise returns false,
+  //                 sets error and changes neither hero, area nor mark.
+bool SnapshotStore::Decode(string_view bytes, int areaCount, Hero& hero, int& area,
+                           JournalMark& mark, string& error) {
+    const char *in = bytes.data();
+    const char *end = in + bytes.size();
+    if (bytes.size() < sizeof(SNAPSHOT_MAGIC) || memcmp(in, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        error = "not a hero snapshot";
+        return false;
+    }
+    in += sizeof(SNAPSHOT_MAGIC);
+    uint64_t version = 0;
+    if (!GetVarint(in, end, version) || version < 1 || version > SNAPSHOT_VERSION) {
+        error = "unsupported snapshot version " + to_string(version);
+        return false;
+    }
+    uint64_t tableSize = 0;
+    uint64_t tableHash = 0;
+    if (!GetVarint(in, end, tableSize) || !GetFixed64(in, end, tableHash)) {
+        error = "snapshot is truncated";
+        return false;
+    }
+    if (tableSize != static_cast<uint64_t>(m_registry->GetSize()) || tableHash != m_registry->GetTableHash()) {
+        error = "snapshot was saved with a different craft file";
+        return false;
+    }
+    uint64_t nameLength = 0;
+    if (!GetVarint(in, end, nameLength) || nameLength > static_cast<uint64_t>(end - in)) {
+        error = "snapshot is truncated";
+        return false;
+    }
+    string_view name(in, nameLength);
+    in += nameLength;
+    uint64_t savedArea = 0;
+    JournalMark savedMark = {0, 0};
+    uint64_t held = 0;
+    if (!GetVarint(in, end, savedArea)
+            || (version >= 2 && (!GetFixed64(in, end, savedMark.m_id) || !GetVarint(in, end, savedMark.m_offset)))
+            || !GetVarint(in, end, held)) {
+        error = "snapshot is truncated";
+        return false;
+    }
+    if (savedArea >= static_cast<uint64_t>(areaCount)) {
+        error = "area " + to_string(savedArea) + " is not on this map";
+        return false;
+    }
+    if (held > tableSize) {
+        error = "snapshot holds more items than the craft file has";
+        return false;
+    }
+    //Rebuild the whole inventory before touching the hero
+    m_counts.assign(tableSize, -1);
+    uint64_t id = 0;
+    for (uint64_t i = 0; i < held; i++) {
+        uint64_t gap = 0;
+        uint64_t count = 0;
+        if (!GetVarint(in, end, gap) || !GetVarint(in, end, count)) {
+            error = "snapshot is truncated";
+            return false;
+        }
+        if (gap >= tableSize - id || count > static_cast<uint64_t>(INT_MAX)) {
+            error = "snapshot has a bad inventory entry";
+            return false;
+        }
+        id += gap;
+        m_counts[id] = static_cast<int>(count);
+        id++;
+    }
+    if (in != end) {
+        error = "snapshot has trailing bytes";
+        return false;
+    }
+    hero.SetName(string(name));
+    hero.RestoreInventory(m_counts);
+    area = static_cast<int>(savedArea);
+    mark = savedMark;
+    return true;
+}
+  // Name: Save(const string& path, const Hero& hero, int area,
+  //            const JournalMark& mark, string& error)
+  // Description: Writes the snapshot to path + ".tmp" and renames it
+  //              over path, so path always holds a whole snapshot.
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: Returns true once path is replaced; otherwise
+  //                 returns false and sets error.
+bool SnapshotStore::Save(const string& path, const Hero& hero, int area,
+                         const JournalMark& mark, string& error) {
+    Encode(hero, area, mark, m_bytes);
+    if (!WriteFile(path, m_bytes, error)) {
+        return false;
+    }
+    //Remember what is on disk for Checkpoint
+    m_saved.swap(m_bytes);
+    m_savedPath = path;
+    return true;
+}
+  // Name: Checkpoint(const string& path, const Hero& hero, int area,
+  //                  const JournalMark& mark, string& error)
+  // Description: Save, skipped when the snapshot is the same as the
+  //              last one this store wrote to path.
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: Returns false and sets error if a write failed.
+bool SnapshotStore::Checkpoint(const string& path, const Hero& hero, int area,
+                               const JournalMark& mark, string& error) {
+    Encode(hero, area, mark, m_bytes);
+    if (path == m_savedPath && m_bytes == m_saved) {
+        return true;
+    }
+    if (!WriteFile(path, m_bytes, error)) {
+        return false;
+    }
+    m_saved.swap(m_bytes);
+    m_savedPath = path;
+    return true;
+}
+  // Name: Load(const string& path, int areaCount, Hero& hero, int& area,
+  //            JournalMark& mark, string& error)
+  // Description: Reads path and decodes it (see Decode).
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: Returns true on success; otherwise returns false,
+  //                 sets error and changes nothing.
+bool SnapshotStore::Load(const string& path, int areaCount, Hero& hero, int& area,
+                         JournalMark& mark, string& error) {
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    streamoff size = in.tellg();
+    in.seekg(0);
+    m_bytes.resize(static_cast<size_t>(size));
+    if (!in.read(&m_bytes[0], size)) {
+        error = "cannot read " + path;
+        return false;
+    }
+    if (!Decode(m_bytes, areaCount, hero, area, mark, error)) {
+        return false;
+    }
+    //The file now matches the hero, so an unchanged checkpoint is skipped
+    m_saved.swap(m_bytes);
+    m_savedPath = path;
+    return true;
+}
@@ -0,0 +1,100 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Hero.h"
+#include "ItemRegistry.h"
+#include "Varint.h"
+using namespace std;
+
+//Hero snapshot: the hero's name, current area and inventory in a small
+//versioned binary file, so a session can be saved and resumed. Numbers
+//are varints (see Varint.h) and the inventory lists only held items, as
+//gaps between ascending ItemIds, so a save is a few bytes per held item
+//whatever the size of the craft file.
+//
+//  char    magic[4]         SNAPSHOT_MAGIC
+//  varint  version          SNAPSHOT_VERSION
+//  varint  itemCount        Size of the item table it was saved against
+//  uint64  tableHash        ItemRegistry::GetTableHash (little-endian)
+//  varint  nameLength, then the name
+//  varint  area             Current area index
+//  uint64  journalId        Version 2: journal the hero was recorded in
+//  varint  journalOffset    Version 2: journal bytes already applied
+//  varint  heldCount
+//  heldCount x (varint idGap, varint count)   id = previous id + 1 + gap
+//
+//Ids are only meaningful against the item table they came from, so a
+//snapshot is refused unless the table size and hash match. Version 1
+//snapshots (no journal fields) are still read.
+
+const char SNAPSHOT_MAGIC[4] = {'C', 'Q', 'H', 'S'};
+const uint32_t SNAPSHOT_VERSION = 2;
+
+//Where a snapshot was taken in an action journal (see Journal.h), so a
+//replay can continue from it with the journal's tail
+struct JournalMark {
+  uint64_t m_id; //Journal id (0 = not journaled)
+  uint64_t m_offset; //Journal bytes the snapshot already includes
+};
+
+class SnapshotStore {
+public:
+  // Name: SnapshotStore(const ItemRegistry& registry)
+  // Description: Creates a store that encodes inventories against
+  //              registry's item table.
+  // Preconditions: registry outlives the store.
+  // Postconditions: The store is ready.
+  SnapshotStore(const ItemRegistry& registry);
+  // Name: Encode(const Hero& hero, int area, const JournalMark& mark, string& bytes)
+  // Description: Builds the snapshot of hero standing in area, taken at
+  //              mark.
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: bytes holds the snapshot (its buffer is reused).
+  void Encode(const Hero& hero, int area, const JournalMark& mark, string& bytes);
+  // Name: Decode(string_view bytes, int areaCount, Hero& hero, int& area,
+  //              JournalMark& mark, string& error)
+  // Description: Checks a snapshot completely, then gives its name and
+  //              inventory to hero, its area to area and its journal
+  //              position to mark.
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: Returns true on success; otherwise returns false,
+  //                 sets error and changes neither hero, area nor mark.
+  bool Decode(string_view bytes, int areaCount, Hero& hero, int& area,
+              JournalMark& mark, string& error);
+  // Name: Save(const string& path, const Hero& hero, int area,
+  //            const JournalMark& mark, string& error)
+  // Description: Writes the snapshot to path + ".tmp" and renames it
+  //              over path, so path always holds a whole snapshot.
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: Returns true once path is replaced; otherwise
+  //                 returns false and sets error.
+  bool Save(const string& path, const Hero& hero, int area,
+            const JournalMark& mark, string& error);
+  // Name: Checkpoint(const string& path, const Hero& hero, int area,
+  //                  const JournalMark& mark, string& error)
+  // Description: Save, skipped when the snapshot is the same as the
+  //              last one this store wrote to path.
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: Returns false and sets error if a write failed.
+  bool Checkpoint(const string& path, const Hero& hero, int area,
+                  const JournalMark& mark, string& error);
+  // Name: Load(const string& path, int areaCount, Hero& hero, int& area,
+  //            JournalMark& mark, string& error)
+  // Description: Reads path and decodes it (see Decode).
+  // Preconditions: hero uses the store's registry.
+  // Postconditions: Returns true on success; otherwise returns false,
+  //                 sets error and changes nothing.
+  bool Load(const string& path, int areaCount, Hero& hero, int& area,
+            JournalMark& mark, string& error);
+private:
+  const ItemRegistry* m_registry; //Item table ids are encoded against
+  string m_bytes; //Encode/read buffer, reused between calls
+  string m_saved; //Snapshot last written by Save
+  string m_savedPath; //Where m_saved was written
+  vector<int> m_counts; //Decoded inventory (swapped into the hero)
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "ThreadPool.h"
+#include <utility>
+
+//Pool and index of the worker running on this thread (null elsewhere)
+static thread_local const ThreadPool *t_pool = nullptr;
+static thread_local int t_worker = -1;
+
+  // Name: ThreadPool(int threadCount)
+  // Description: Starts the worker threads.
+  // Preconditions: None (threadCount < 1 uses the hardware thread count).
+  // Postconditions: GetThreadCount() workers are waiting for tasks.
+ThreadPool::ThreadPool(int threadCount)
+    : m_queued(0), m_nextQueue(0), m_pending(0), m_stopping(false) {
+    if (threadCount < 1) {
+        threadCount = static_cast<int>(thread::hardware_concurrency());
+    }
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    //Every deque exists before any worker can look for work
+    for (int i = 0; i < threadCount; i++) {
+        m_queues.emplace_back(new WorkerQueue);
+    }
+    for (int i = 0; i < threadCount; i++) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+  // Name: ~ThreadPool()
+  // Description: Finishes queued tasks and joins the workers.
+  // Preconditions: None.
+  // Postconditions: All threads are joined.
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(m_lock);
+        m_stopping = true;
+    }
+    m_taskReady.notify_all();
+    for (unsigned long i = 0; i < m_workers.size(); i++) {
+        m_workers[i].join();
+    }
+}
+  // Name: Submit(function<void()> task)
+  // Description: Queues a task (on the calling worker's deque when
+  //              called from a task).
+  // Preconditions: None.
+  // Postconditions: task will run on a worker thread.
+void ThreadPool::Submit(function<void()> task) {
+    {
+        lock_guard<mutex> guard(m_lock);
+        m_pending++;
+    }
+    //Nested work stays local (and hot in cache); outside work is dealt out
+    int target = t_pool == this ? t_worker
+                                : static_cast<int>(m_nextQueue++ % m_queues.size());
+    {
+        lock_guard<mutex> guard(m_queues[target]->m_lock);
+        m_queues[target]->m_tasks.push_back(std::move(task));
+    }
+    m_queued++;
+    //Taking m_lock orders the push before a sleeper's re-check
+    {
+        lock_guard<mutex> guard(m_lock);
+    }
+    m_taskReady.notify_one();
+}
+  // Name: Wait()
+  // Description: Blocks until every submitted task has run.
+  // Preconditions: Not called from a task.
+  // Postconditions: Queue is empty; rethrows the first task exception.
+void ThreadPool::Wait() {
+    unique_lock<mutex> guard(m_lock);
+    m_allDone.wait(guard, [this]() { return m_pending == 0; });
+    if (m_error) {
+        exception_ptr error = m_error;
+        m_error = nullptr;
+        rethrow_exception(error);
+    }
+}
+  // Name: ParallelFor(int count, const function<void(int)>& body)
+  // Description: Runs body(0) .. body(count - 1) on the workers.
+  // Preconditions: Not called from a task.
+  // Postconditions: Every call has finished; rethrows the first exception.
+void ThreadPool::ParallelFor(int count, const function<void(int)>& body) {
+    for (int i = 0; i < count; i++) {
+        Submit([&body, i]() { body(i); });
+    }
+    Wait();
+}
+  // Name: GetThreadCount() const
+  // Description: Reports how many workers the pool runs.
+  // Preconditions: None.
+  // Postconditions: Returns the worker count.
+int ThreadPool::GetThreadCount() const {
+    return static_cast<int>(m_workers.size());
+}
+  // Name: TakeTask(int index, function<void()>& task)
+  // Description: Pops from worker index's deque, else steals from the
+  //              front of another worker's deque.
+  // Preconditions: 0 <= index < GetThreadCount().
+  // Postconditions: Returns true and fills task if one was found.
+bool ThreadPool::TakeTask(int index, function<void()>& task) {
+    int count = static_cast<int>(m_queues.size());
+    for (int i = 0; i < count; i++) {
+        WorkerQueue& queue = *m_queues[(index + i) % count];
+        lock_guard<mutex> guard(queue.m_lock);
+        if (queue.m_tasks.empty()) {
+            continue;
+        }
+        //Own deque: newest first; victims: oldest first
+        if (i == 0) {
+            task = std::move(queue.m_tasks.back());
+            queue.m_tasks.pop_back();
+        } else {
+            task = std::move(queue.m_tasks.front());
+            queue.m_tasks.pop_front();
+        }
+        m_queued--;
+        return true;
+    }
+    return false;
+}
+  // Name: WorkerLoop(int index)
+  // Description: Body of each worker: runs its own tasks, steals when
+  //              out of work and sleeps when every deque is empty.
+  // Preconditions: 0 <= index < GetThreadCount().
+  // Postconditions: Returns once m_stopping is set and no task is queued.
+void ThreadPool::WorkerLoop(int index) {
+    t_pool = this;
+    t_worker = index;
+    while (true) {
+        function<void()> task;
+        if (!TakeTask(index, task)) {
+            unique_lock<mutex> guard(m_lock);
+            m_taskReady.wait(guard, [this]() { return m_stopping || m_queued > 0; });
+            if (m_queued == 0) {
+                //Stopping and nothing left to run
+                return;
+            }
+            continue;
+        }
+        //Run outside every lock; keep the first failure for Wait()
+        exception_ptr error;
+        try {
+            task();
+        } catch (...) {
+            error = current_exception();
+        }
+        lock_guard<mutex> guard(m_lock);
+        if (error && !m_error) {
+            m_error = error;
+        }
+        m_pending--;
+        if (m_pending == 0) {
+            m_allDone.notify_all();
+        }
+    }
+}
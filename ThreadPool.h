@@ -0,0 +1,87 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+//One worker's task deque. The owner pops newest-first from the back;
+//idle workers steal oldest-first from the front.
+struct WorkerQueue {
+  mutex m_lock; // Guards m_tasks
+  deque<function<void()>> m_tasks; // Queued tasks
+};
+
+//Fixed-size work-stealing pool. Every worker has its own deque: tasks
+//submitted from outside are dealt round-robin, tasks submitted by a task
+//go to its own worker's deque, and a worker whose deque is empty steals
+//from the others before going to sleep. Tasks are fire-and-forget;
+//Wait() blocks until every submitted task has finished and rethrows the
+//first exception a task threw.
+class ThreadPool {
+public:
+  // Name: ThreadPool(int threadCount)
+  // Description: Starts the worker threads.
+  // Preconditions: None (threadCount < 1 uses the hardware thread count).
+  // Postconditions: GetThreadCount() workers are waiting for tasks.
+  ThreadPool(int threadCount);
+  // Name: ~ThreadPool()
+  // Description: Finishes queued tasks and joins the workers.
+  // Preconditions: None.
+  // Postconditions: All threads are joined.
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  // Name: Submit(function<void()> task)
+  // Description: Queues a task (on the calling worker's deque when
+  //              called from a task).
+  // Preconditions: None.
+  // Postconditions: task will run on a worker thread.
+  void Submit(function<void()> task);
+  // Name: Wait()
+  // Description: Blocks until every submitted task has run.
+  // Preconditions: Not called from a task.
+  // Postconditions: Queue is empty; rethrows the first task exception.
+  void Wait();
+  // Name: ParallelFor(int count, const function<void(int)>& body)
+  // Description: Runs body(0) .. body(count - 1) on the workers.
+  // Preconditions: Not called from a task.
+  // Postconditions: Every call has finished; rethrows the first exception.
+  void ParallelFor(int count, const function<void(int)>& body);
+  // Name: GetThreadCount() const
+  // Description: Reports how many workers the pool runs.
+  // Preconditions: None.
+  // Postconditions: Returns the worker count.
+  int GetThreadCount() const;
+private:
+  // Name: WorkerLoop(int index)
+  // Description: Body of each worker: runs its own tasks, steals when
+  //              out of work and sleeps when every deque is empty.
+  // Preconditions: 0 <= index < GetThreadCount().
+  // Postconditions: Returns once m_stopping is set and no task is queued.
+  void WorkerLoop(int index);
+  // Name: TakeTask(int index, function<void()>& task)
+  // Description: Pops from worker index's deque, else steals from the
+  //              front of another worker's deque.
+  // Preconditions: 0 <= index < GetThreadCount().
+  // Postconditions: Returns true and fills task if one was found.
+  bool TakeTask(int index, function<void()>& task);
+  vector<thread> m_workers; // Worker threads
+  vector<unique_ptr<WorkerQueue>> m_queues; // One deque per worker
+  atomic<int> m_queued; // Tasks sitting in any deque
+  atomic<unsigned> m_nextQueue; // Round-robin target for outside submits
+  mutex m_lock; // Guards every member below (and sleeping)
+  condition_variable m_taskReady; // Signalled when a task is queued
+  condition_variable m_allDone; // Signalled when m_pending drops to 0
+  int m_pending; // Tasks queued or running
+  bool m_stopping; // Set by the destructor
+  exception_ptr m_error; // First exception thrown by a task
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef VARINT_H
+#define VARINT_H
+#include <cstdint>
+using namespace std;
+
+//Byte encodings shared by the binary save formats (hero snapshots and
+//the action journal). A varint holds 7 bits per byte, low bits first,
+//with the top bit set on every byte but the last, so small numbers take
+//one byte. Fixed 64-bit values are little-endian whatever the host.
+
+const int MAX_VARINT_BYTES = 10; //A uint64_t takes at most 10 bytes
+const int FIXED64_BYTES = 8; //Bytes in a fixed 64-bit value
+
+// Name: PutVarint(char* out, uint64_t value)
+// Description: Writes value as a varint.
+// Preconditions: out has room for MAX_VARINT_BYTES.
+// Postconditions: Returns the position after the last byte written.
+inline char* PutVarint(char* out, uint64_t value) {
+  while (value >= 0x80) {
+    *out++ = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = static_cast<char>(value);
+  return out;
+}
+
+// Name: GetVarint(const char*& in, const char* end, uint64_t& value)
+// Description: Reads one varint and moves in past it.
+// Preconditions: in <= end.
+// Postconditions: Returns false if the bytes run out or the varint is
+//                 longer than a uint64_t.
+inline bool GetVarint(const char*& in, const char* end, uint64_t& value) {
+  //One-byte values are by far the most common
+  if (in < end && static_cast<uint8_t>(*in) < 0x80) {
+    value = static_cast<uint8_t>(*in++);
+    return true;
+  }
+  value = 0;
+  for (int shift = 0; shift < 64 && in < end; shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(*in++);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Name: PutFixed64(char* out, uint64_t value)
+// Description: Writes value as 8 little-endian bytes.
+// Preconditions: out has room for FIXED64_BYTES.
+// Postconditions: Returns the position after the value.
+inline char* PutFixed64(char* out, uint64_t value) {
+  for (int i = 0; i < FIXED64_BYTES; i++) {
+    *out++ = static_cast<char>(value >> (8 * i));
+  }
+  return out;
+}
+
+// Name: GetFixed64(const char*& in, const char* end, uint64_t& value)
+// Description: Reads 8 little-endian bytes and moves in past them.
+// Preconditions: in <= end.
+// Postconditions: Returns false if fewer than 8 bytes are left.
+inline bool GetFixed64(const char*& in, const char* end, uint64_t& value) {
+  if (end - in < FIXED64_BYTES) {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < FIXED64_BYTES; i++) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(*in++)) << (8 * i);
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,166 @@
+#include "World.h"
+#include <cstring>
+
+  // Name: World()
+  // Description: Creates an empty world.
+  // Preconditions: None.
+  // Postconditions: GetSize() is 0.
+World::World() : m_blockUsed(0), m_blockSize(0) {}
+  // Name: Reserve(int areas)
+  // Description: Reserves room in every per-area array.
+  // Preconditions: areas >= 0.
+  // Postconditions: Adding up to areas areas does not reallocate.
+void World::Reserve(int areas) {
+    m_ids.reserve(areas);
+    m_exits.reserve(static_cast<size_t>(areas) * EXIT_COUNT);
+    m_exitMask.reserve(areas);
+    m_names.reserve(areas);
+    m_descs.reserve(areas);
+}
+  // Name: AddArea(int id, string_view name, string_view desc, const int exits[4])
+  // Description: Appends an area, copying its text into the arena.
+  // Preconditions: exits holds North, East, South, West.
+  // Postconditions: Returns the new area's index.
+int World::AddArea(int id, string_view name, string_view desc, const int exits[4]) {
+    return AddAreaView(id, StoreText(name), StoreText(desc), exits);
+}
+  // Name: AddAreaView(int id, string_view name, string_view desc, const int exits[4])
+  // Description: Appends an area whose text stays where it is.
+  // Preconditions: name and desc outlive the world.
+  // Postconditions: Returns the new area's index.
+int World::AddAreaView(int id, string_view name, string_view desc, const int exits[4]) {
+    uint8_t mask = 0;
+    for (int i = 0; i < EXIT_COUNT; i++) {
+        m_exits.push_back(exits[i]);
+        if (exits[i] != NO_EXIT) {
+            mask |= static_cast<uint8_t>(1 << i);
+        }
+    }
+    m_ids.push_back(id);
+    m_exitMask.push_back(mask);
+    m_names.push_back(name);
+    m_descs.push_back(desc);
+    return static_cast<int>(m_ids.size()) - 1;
+}
+  // Name: BuildAdjacency()
+  // Description: Builds the CSR edge list from the exit table, dropping
+  //              missing exits and exits that point outside the world.
+  // Preconditions: All areas have been added.
+  // Postconditions: GetNeighbors is valid for every area.
+void World::BuildAdjacency() {
+    int size = GetSize();
+    m_edgeStart.assign(size + 1, 0);
+    m_edges.clear();
+    m_edges.reserve(m_exits.size());
+    for (int i = 0; i < size; i++) {
+        for (int d = 0; d < EXIT_COUNT; d++) {
+            int target = m_exits[i * EXIT_COUNT + d];
+            if (target >= 0 && target < size) {
+                m_edges.push_back(target);
+            }
+        }
+        m_edgeStart[i + 1] = static_cast<int32_t>(m_edges.size());
+    }
+    m_edges.shrink_to_fit();
+}
+  // Name: Clear()
+  // Description: Removes every area and frees the text arena.
+  // Preconditions: No views into owned text are still in use.
+  // Postconditions: GetSize() is 0.
+void World::Clear() {
+    m_ids.clear();
+    m_exits.clear();
+    m_exitMask.clear();
+    m_names.clear();
+    m_descs.clear();
+    m_edgeStart.clear();
+    m_edges.clear();
+    m_textBlocks.clear();
+    m_blockUsed = 0;
+    m_blockSize = 0;
+}
+  // Name: GetSize() const
+  // Description: Reports the number of areas.
+  // Preconditions: None.
+  // Postconditions: Returns the area count.
+int World::GetSize() const {
+    return static_cast<int>(m_ids.size());
+}
+  // Name: GetId(int index) const
+  // Description: Id field of the area at index.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns the id.
+int World::GetId(int index) const {
+    return m_ids[index];
+}
+  // Name: GetExit(int index, int dir) const
+  // Description: Area reached from index in direction dir (0-3, as in
+  //              the direction enum).
+  // Preconditions: 0 <= index < GetSize(); 0 <= dir < EXIT_COUNT.
+  // Postconditions: Returns the target, or NO_EXIT.
+int World::GetExit(int index, int dir) const {
+    return m_exits[index * EXIT_COUNT + dir];
+}
+  // Name: GetExits(int index) const
+  // Description: The four exits of the area at index.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns a pointer to North, East, South, West.
+const int32_t* World::GetExits(int index) const {
+    return m_exits.data() + static_cast<size_t>(index) * EXIT_COUNT;
+}
+  // Name: GetExitMask(int index) const
+  // Description: Bit d is set when the area has an exit in direction d.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns the mask (0-15).
+uint8_t World::GetExitMask(int index) const {
+    return m_exitMask[index];
+}
+  // Name: GetNeighbors(int index, int& count) const
+  // Description: Real exits of the area, from the CSR edge list.
+  // Preconditions: BuildAdjacency() has run; 0 <= index < GetSize().
+  // Postconditions: Returns the first target and sets count.
+const int32_t* World::GetNeighbors(int index, int& count) const {
+    count = m_edgeStart[index + 1] - m_edgeStart[index];
+    return m_edges.data() + m_edgeStart[index];
+}
+  // Name: GetName(int index) const
+  // Description: Name of the area at index.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns a view of the name.
+string_view World::GetName(int index) const {
+    return m_names[index];
+}
+  // Name: GetDesc(int index) const
+  // Description: Description of the area at index.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns a view of the description.
+string_view World::GetDesc(int index) const {
+    return m_descs[index];
+}
+  // Name: GetArea(int index) const
+  // Description: View of one area for Look and Move.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns an Area referring to this world's text.
+Area World::GetArea(int index) const {
+    const int32_t *exits = GetExits(index);
+    return Area(m_ids[index], m_names[index], m_descs[index], exits[0], exits[1], exits[2], exits[3]);
+}
+  // Name: StoreText(string_view text)
+  // Description: Copies text into the arena.
+  // Preconditions: None.
+  // Postconditions: Returns a view of the stable copy.
+string_view World::StoreText(string_view text) {
+    if (text.empty()) {
+        return string_view();
+    }
+    if (m_blockUsed + text.size() > m_blockSize) {
+        //Start a new block; oversized text gets a block of its own
+        m_blockSize = text.size() > TEXT_BLOCK_SIZE ? text.size() : TEXT_BLOCK_SIZE;
+        m_textBlocks.push_back(unique_ptr<char[]>(new char[m_blockSize]));
+        m_blockUsed = 0;
+    }
+    char *copy = m_textBlocks.back().get() + m_blockUsed;
+    memcpy(copy, text.data(), text.size());
+    m_blockUsed += text.size();
+    return string_view(copy, text.size());
+}
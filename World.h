@@ -0,0 +1,123 @@
+#ifndef WORLD_H
+#define WORLD_H
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "Area.h"
+using namespace std;
+
+const int NO_EXIT = -1; //Exit value for "no path"
+const int EXIT_COUNT = 4; //North, East, South, West
+const size_t TEXT_BLOCK_SIZE = 1 << 16; //Bytes per owned text block
+
+//Structure-of-arrays store for the whole map. Hot graph data (ids, a flat
+//exit table and a per-area exit bitmask) lives in dense arrays apart from
+//the cold text, so passes over the graph never touch descriptions. Text is
+//either copied into an arena of TEXT_BLOCK_SIZE blocks (AddArea) or left
+//in a buffer that outlives the world, e.g. a mapped file (AddAreaView).
+//BuildAdjacency adds a compressed sparse row (CSR) copy of the edges for
+//traversals: the real exits of area i are m_edges[m_edgeStart[i] ..
+//m_edgeStart[i + 1]).
+class World {
+public:
+  // Name: World()
+  // Description: Creates an empty world.
+  // Preconditions: None.
+  // Postconditions: GetSize() is 0.
+  World();
+  World(const World&) = delete;
+  World& operator=(const World&) = delete;
+  World(World&&) = default;
+  World& operator=(World&&) = default;
+  // Name: Reserve(int areas)
+  // Description: Reserves room in every per-area array.
+  // Preconditions: areas >= 0.
+  // Postconditions: Adding up to areas areas does not reallocate.
+  void Reserve(int areas);
+  // Name: AddArea(int id, string_view name, string_view desc, const int exits[4])
+  // Description: Appends an area, copying its text into the arena.
+  // Preconditions: exits holds North, East, South, West.
+  // Postconditions: Returns the new area's index.
+  int AddArea(int id, string_view name, string_view desc, const int exits[4]);
+  // Name: AddAreaView(int id, string_view name, string_view desc, const int exits[4])
+  // Description: Appends an area whose text stays where it is.
+  // Preconditions: name and desc outlive the world.
+  // Postconditions: Returns the new area's index.
+  int AddAreaView(int id, string_view name, string_view desc, const int exits[4]);
+  // Name: BuildAdjacency()
+  // Description: Builds the CSR edge list from the exit table, dropping
+  //              missing exits and exits that point outside the world.
+  // Preconditions: All areas have been added.
+  // Postconditions: GetNeighbors is valid for every area.
+  void BuildAdjacency();
+  // Name: Clear()
+  // Description: Removes every area and frees the text arena.
+  // Preconditions: No views into owned text are still in use.
+  // Postconditions: GetSize() is 0.
+  void Clear();
+  // Name: GetSize() const
+  // Description: Reports the number of areas.
+  // Preconditions: None.
+  // Postconditions: Returns the area count.
+  int GetSize() const;
+  // Name: GetId(int index) const
+  // Description: Id field of the area at index.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns the id.
+  int GetId(int index) const;
+  // Name: GetExit(int index, int dir) const
+  // Description: Area reached from index in direction dir (0-3, as in
+  //              the direction enum).
+  // Preconditions: 0 <= index < GetSize(); 0 <= dir < EXIT_COUNT.
+  // Postconditions: Returns the target, or NO_EXIT.
+  int GetExit(int index, int dir) const;
+  // Name: GetExits(int index) const
+  // Description: The four exits of the area at index.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns a pointer to North, East, South, West.
+  const int32_t* GetExits(int index) const;
+  // Name: GetExitMask(int index) const
+  // Description: Bit d is set when the area has an exit in direction d.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns the mask (0-15).
+  uint8_t GetExitMask(int index) const;
+  // Name: GetNeighbors(int index, int& count) const
+  // Description: Real exits of the area, from the CSR edge list.
+  // Preconditions: BuildAdjacency() has run; 0 <= index < GetSize().
+  // Postconditions: Returns the first target and sets count.
+  const int32_t* GetNeighbors(int index, int& count) const;
+  // Name: GetName(int index) const
+  // Description: Name of the area at index.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns a view of the name.
+  string_view GetName(int index) const;
+  // Name: GetDesc(int index) const
+  // Description: Description of the area at index.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns a view of the description.
+  string_view GetDesc(int index) const;
+  // Name: GetArea(int index) const
+  // Description: View of one area for Look and Move.
+  // Preconditions: 0 <= index < GetSize().
+  // Postconditions: Returns an Area referring to this world's text.
+  Area GetArea(int index) const;
+private:
+  // Name: StoreText(string_view text)
+  // Description: Copies text into the arena.
+  // Preconditions: None.
+  // Postconditions: Returns a view of the stable copy.
+  string_view StoreText(string_view text);
+  vector<int32_t> m_ids; // Id field per area
+  vector<int32_t> m_exits; // EXIT_COUNT exits per area, flat
+  vector<uint8_t> m_exitMask; // Bit per existing exit
+  vector<string_view> m_names; // Name per area (arena or external)
+  vector<string_view> m_descs; // Description per area (arena or external)
+  vector<int32_t> m_edgeStart; // CSR row offsets (size + 1 entries)
+  vector<int32_t> m_edges; // CSR targets
+  vector<unique_ptr<char[]>> m_textBlocks; // Owned text arena
+  size_t m_blockUsed; // Bytes used in the last arena block
+  size_t m_blockSize; // Capacity of the last arena block
+};
+
+#endif
@@ -0,0 +1,210 @@
+#include "WorldGen.h"
+#include "ItemRegistry.h"
+#include "OutputSink.h"
+#include "Random.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+//Links a generated cell makes to earlier cells
+const uint8_t LINK_NORTH = 1;
+const uint8_t LINK_WEST = 2;
+
+//Words for area names and descriptions
+const char *NAME_ADJECTIVES[] = {
+  "Dusty", "Narrow", "Flooded", "Echoing", "Collapsed", "Glittering", "Silent", "Smoky",
+  "Frozen", "Mossy", "Crooked", "Sunken", "Vaulted", "Crumbling", "Hidden", "Humid"
+};
+const char *NAME_NOUNS[] = {
+  "Tunnel", "Cavern", "Grotto", "Shaft", "Chamber", "Ledge", "Passage", "Hollow",
+  "Gallery", "Crevice", "Pool", "Bridge", "Mine", "Den", "Alcove", "Pit"
+};
+const char *DESC_WORDS[] = {
+  "the", "walls", "are", "damp", "and", "cold", "a", "faint", "draft", "moves",
+  "through", "cracks", "in", "stone", "water", "drips", "from", "above", "old",
+  "timbers", "hold", "up", "ceiling", "dark", "ore", "glints", "near", "floor",
+  "something", "scurries", "away", "path", "bends", "toward", "distant", "light"
+};
+
+// Name: Pick(Random& random, const char* const (&words)[N])
+// Description: Draws one word from a table.
+// Preconditions: N >= 1.
+// Postconditions: Returns the word.
+template <unsigned long N>
+static const char* Pick(Random& random, const char* const (&words)[N]) {
+    return words[random.Below(static_cast<uint32_t>(N))];
+}
+
+// Name: WriteDescription(OutputSink& out, Random& random, int length)
+// Description: Writes length characters of space-separated words (the
+//              last word may be cut short or replaced by a period).
+// Preconditions: length >= 1.
+// Postconditions: The text is written; no '|' or newline is used.
+static void WriteDescription(OutputSink& out, Random& random, int length) {
+    int written = 0;
+    while (written < length) {
+        //A space needs a word after it; with one character left, end the sentence
+        if (written > 0 && written + 1 == length) {
+            out << '.';
+            return;
+        } else if (written > 0) {
+            out << ' ';
+            written++;
+        }
+        const char *word = Pick(random, DESC_WORDS);
+        int size = static_cast<int>(strlen(word));
+        if (size > length - written) {
+            size = length - written;
+        }
+        out.Write(word, size);
+        written += size;
+    }
+}
+
+// Name: ParseMapShape(const string& name, MapShape& shape)
+// Description: Maps "corridor", "grid" or "maze" to a MapShape.
+// Preconditions: None.
+// Postconditions: Returns false for any other name.
+bool ParseMapShape(const string& name, MapShape& shape) {
+    if (name == "corridor") {
+        shape = SHAPE_CORRIDOR;
+    } else if (name == "grid") {
+        shape = SHAPE_GRID;
+    } else if (name == "maze") {
+        shape = SHAPE_MAZE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Name: GenerateMap(const string& path, const MapGenConfig& config, string& error)
+// Description: Writes a map whose area ids are their positions and whose
+//              exits all lead both ways, so it passes validation and
+//              every area is reachable from area 0. Grid and maze maps
+//              are square (the last row may be short).
+// Preconditions: None.
+// Postconditions: Returns true and writes path; otherwise returns false
+//                 and sets error (bad config or unwritable file).
+bool GenerateMap(const string& path, const MapGenConfig& config, string& error) {
+    if (config.m_areas < 1 || config.m_areas > MAX_GEN_AREAS) {
+        error = "area count must be 1 - " + to_string(MAX_GEN_AREAS);
+        return false;
+    }
+    if (config.m_minDesc < 1 || config.m_maxDesc < config.m_minDesc
+            || config.m_loops < 0 || config.m_loops > 100) {
+        error = "need 1 <= min description <= max description and loops 0 - 100";
+        return false;
+    }
+    ofstream file(path, ios::binary);
+    if (!file) {
+        error = "cannot create " + path;
+        return false;
+    }
+    Random random(config.m_seed);
+    int areas = config.m_areas;
+    //A corridor is a grid one row high
+    int width = areas;
+    if (config.m_shape != SHAPE_CORRIDOR) {
+        width = static_cast<int>(ceil(sqrt(static_cast<double>(areas))));
+    }
+    //Every cell links to its north and/or west neighbour; the maze keeps
+    //one of the two (a binary-tree maze, so all cells reach cell 0) and
+    //sometimes both. A cell's east and south exits are its neighbours' links.
+    vector<uint8_t> links(areas, 0);
+    for (int i = 0; i < areas; i++) {
+        bool north = i >= width;
+        bool west = i % width > 0;
+        if (config.m_shape == SHAPE_MAZE && north && west
+                && random.Below(100) >= static_cast<uint32_t>(config.m_loops)) {
+            //Keep one of the two
+            if (random.Below(2) == 0) {
+                north = false;
+            } else {
+                west = false;
+            }
+        }
+        links[i] = (north ? LINK_NORTH : 0) | (west ? LINK_WEST : 0);
+    }
+    BufferedSink out(file);
+    for (int i = 0; i < areas; i++) {
+        int exits[4];
+        exits[0] = (links[i] & LINK_NORTH) ? i - width : -1;
+        exits[1] = i % width + 1 < width && i + 1 < areas && (links[i + 1] & LINK_WEST) ? i + 1 : -1;
+        exits[2] = i + width < areas && (links[i + width] & LINK_NORTH) ? i + width : -1;
+        exits[3] = (links[i] & LINK_WEST) ? i - 1 : -1;
+        out << i << '|' << Pick(random, NAME_ADJECTIVES) << ' ' << Pick(random, NAME_NOUNS) << '|';
+        int span = config.m_maxDesc - config.m_minDesc + 1;
+        WriteDescription(out, random, config.m_minDesc + static_cast<int>(random.Below(span)));
+        out << '|' << exits[0] << '|' << exits[1] << '|' << exits[2] << '|' << exits[3] << "|\n";
+    }
+    out.Flush();
+    if (!file) {
+        error = "write to " + path + " failed";
+        return false;
+    }
+    return true;
+}
+
+// Name: GenerateCraft(const string& path, const CraftGenConfig& config, string& error)
+// Description: Writes config.m_items recipes in config.m_layers layers.
+//              Layer 0 is the gatherable products; every recipe in
+//              layer L takes its first ingredient from layer L-1 and the
+//              rest from any lower layer (repeats count twice).
+// Preconditions: None.
+// Postconditions: Returns true and writes path; otherwise returns false
+//                 and sets error.
+bool GenerateCraft(const string& path, const CraftGenConfig& config, string& error) {
+    if (config.m_items < 1 || config.m_items > MAX_GEN_ITEMS) {
+        error = "item count must be 1 - " + to_string(MAX_GEN_ITEMS);
+        return false;
+    }
+    if (config.m_layers < 1 || config.m_layers > config.m_items
+            || config.m_maxIngredients < 1 || config.m_maxIngredients > CRAFT_FIELDS) {
+        error = "need 1 <= layers <= items and ingredients 1 - " + to_string(CRAFT_FIELDS);
+        return false;
+    }
+    ofstream file(path, ios::binary);
+    if (!file) {
+        error = "cannot create " + path;
+        return false;
+    }
+    Random random(config.m_seed);
+    //Layer 0: everything that can be gathered
+    vector<vector<string>> layers(1);
+    const vector<string> *products[] = {&RawProducts, &NaturalProducts, &FoodProducts, &HuntProducts};
+    for (int kind = 0; kind < 4; kind++) {
+        layers[0].insert(layers[0].end(), products[kind]->begin(), products[kind]->end());
+    }
+    BufferedSink out(file);
+    for (int layer = 1; layer <= config.m_layers; layer++) {
+        //Spread the items evenly; earlier layers take the remainder
+        int count = config.m_items / config.m_layers + (layer <= config.m_items % config.m_layers ? 1 : 0);
+        layers.push_back(vector<string>());
+        for (int i = 0; i < count; i++) {
+            string name = "Part " + to_string(layer) + "-" + to_string(i);
+            int ingredients = 1 + static_cast<int>(random.Below(config.m_maxIngredients));
+            out << name;
+            for (int slot = 0; slot < CRAFT_FIELDS; slot++) {
+                out << '|';
+                if (slot >= ingredients) {
+                    out << "None";
+                    continue;
+                }
+                //The first ingredient chains the layers; the rest may come from any
+                int from = slot == 0 ? layer - 1 : static_cast<int>(random.Below(layer));
+                const vector<string>& pool = layers[from];
+                out << pool[random.Below(static_cast<uint32_t>(pool.size()))];
+            }
+            out << "|\n";
+            layers.back().push_back(name);
+        }
+    }
+    out.Flush();
+    if (!file) {
+        error = "write to " + path + " failed";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef WORLDGEN_H
+#define WORLDGEN_H
+#include <cstdint>
+#include <string>
+using namespace std;
+
+//Synthetic inputs for scale testing: map files in the proj5 '|' format
+//with any number of areas, and craft files with deep, wide recipe DAGs.
+//Everything is drawn from one Random engine seeded with the config's
+//seed, so the same config always writes the same bytes. Files are
+//written through a BufferedSink, a block at a time.
+
+const int MAX_GEN_AREAS = 10000000; //Largest map GenerateMap writes
+const int MAX_GEN_ITEMS = 1000000; //Largest recipe count GenerateCraft writes
+const int CRAFT_FIELDS = 4; //Ingredient slots per craft record
+
+//Exit layout of a generated map
+enum MapShape {
+  SHAPE_CORRIDOR, //One east-west line
+  SHAPE_GRID,     //Square grid, every neighbour connected
+  SHAPE_MAZE      //Square grid maze (a spanning tree) plus some loops
+};
+
+//Settings for GenerateMap
+struct MapGenConfig {
+  int m_areas; //Number of areas (1 - MAX_GEN_AREAS)
+  MapShape m_shape; //Exit layout
+  int m_loops; //SHAPE_MAZE: percent of cells given a second link (0 - 100)
+  int m_minDesc; //Shortest description (characters)
+  int m_maxDesc; //Longest description (characters)
+  uint64_t m_seed; //Seed; equal configs write equal files
+};
+
+//Settings for GenerateCraft
+struct CraftGenConfig {
+  int m_items; //Crafted items (1 - MAX_GEN_ITEMS)
+  int m_layers; //Recipe depth; each layer needs the one below it
+  int m_maxIngredients; //Ingredients per recipe (1 - CRAFT_FIELDS)
+  uint64_t m_seed; //Seed; equal configs write equal files
+};
+
+// Name: ParseMapShape(const string& name, MapShape& shape)
+// Description: Maps "corridor", "grid" or "maze" to a MapShape.
+// Preconditions: None.
+// Postconditions: Returns false for any other name.
+bool ParseMapShape(const string& name, MapShape& shape);
+
+// Name: GenerateMap(const string& path, const MapGenConfig& config, string& error)
+// Description: Writes a map whose area ids are their positions and whose
+//              exits all lead both ways, so it passes validation and
+//              every area is reachable from area 0. Grid and maze maps
+//              are square (the last row may be short).
+// Preconditions: None.
+// Postconditions: Returns true and writes path; otherwise returns false
+//                 and sets error (bad config or unwritable file).
+bool GenerateMap(const string& path, const MapGenConfig& config, string& error);
+
+// Name: GenerateCraft(const string& path, const CraftGenConfig& config, string& error)
+// Description: Writes config.m_items recipes in config.m_layers layers.
+//              Layer 0 is the gatherable products; every recipe in
+//              layer L takes its first ingredient from layer L-1 and the
+//              rest from any lower layer (repeats count twice).
+// Preconditions: None.
+// Postconditions: Returns true and writes path; otherwise returns false
+//                 and sets error.
+bool GenerateCraft(const string& path, const CraftGenConfig& config, string& error);
+
+#endif
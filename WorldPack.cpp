@@ -0,0 +1,352 @@
+#include "WorldPack.h"
+#include "ItemRegistry.h"
+#include "MapRecord.h"
+#include "Router.h"
+#include "World.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+// Name: AlignUp(uint64_t offset)
+// Description: Rounds an offset up to the next 8-byte boundary.
+// Preconditions: None.
+// Postconditions: Returns the aligned offset.
+static uint64_t AlignUp(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+// Name: SectionFits(uint64_t offset, uint64_t bytes, uint64_t limit)
+// Description: Checks that a section of bytes at offset ends by limit
+//              and starts on the 8-byte boundary CompilePack puts it on.
+//              Written as a difference so a huge offset cannot wrap.
+// Preconditions: None.
+// Postconditions: Returns true if the section can be read in place.
+static bool SectionFits(uint64_t offset, uint64_t bytes, uint64_t limit) {
+    return offset <= limit && bytes <= limit - offset && offset % 8 == 0;
+}
+
+// Name: AddText(string& pool, string_view text)
+// Description: Appends text to the pool being built.
+// Preconditions: None.
+// Postconditions: Returns a reference to the appended text.
+static PackString AddText(string& pool, string_view text) {
+    PackString ref;
+    ref.m_offset = pool.size();
+    ref.m_length = static_cast<uint32_t>(text.size());
+    ref.m_pad = 0;
+    pool.append(text.data(), text.size());
+    return ref;
+}
+
+// Name: WriteSection(ofstream& out, uint64_t offset, const void* data, uint64_t bytes)
+// Description: Pads the stream up to offset and writes one section.
+// Preconditions: out is positioned at or before offset.
+// Postconditions: bytes of data are written starting at offset.
+static void WriteSection(ofstream& out, uint64_t offset, const void* data, uint64_t bytes) {
+    static const char zeros[8] = {0};
+    uint64_t at = static_cast<uint64_t>(out.tellp());
+    out.write(zeros, static_cast<streamsize>(offset - at));
+    out.write(static_cast<const char*>(data), static_cast<streamsize>(bytes));
+}
+
+// Name: CompilePack(const string& mapFile, const string& craftFile,
+//                   const string& packFile, ValidationReport& report,
+//                   string& error)
+// Description: Parses a map file and a craft file, validates the map
+//              (ValidateWorld from area 0) and writes them as a world
+//              pack, with the router's landmark tables precomputed. The
+//              game trusts a pack's exit table, so a map that fails
+//              validation is never packed.
+// Preconditions: Both inputs use the '|' delimited formats.
+// Postconditions: Returns true and writes packFile on success; returns
+//                 false and sets error otherwise (report holds the
+//                 problems when the map is the reason).
+bool CompilePack(const string& mapFile, const string& craftFile,
+                 const string& packFile, ValidationReport& report, string& error) {
+    MappedFile mapText;
+    MappedFile craftText;
+    if (!mapText.Open(mapFile)) {
+        error = "cannot open map file " + mapFile;
+        return false;
+    }
+    if (!craftText.Open(craftFile)) {
+        error = "cannot open craft file " + craftFile;
+        return false;
+    }
+    string pool;
+    //Areas: exits, ids and text references
+    vector<int32_t> exits;
+    vector<int32_t> areaIds;
+    vector<PackString> areaText;
+    World world;
+    size_t pos = 0;
+    AreaRecord area;
+    try {
+        while (ParseAreaRecord(mapText.View(), pos, area)) {
+            for (int i = 0; i < 4; i++) {
+                exits.push_back(area.m_exits[i]);
+            }
+            areaIds.push_back(area.m_id);
+            areaText.push_back(AddText(pool, area.m_name));
+            areaText.push_back(AddText(pool, area.m_desc));
+            world.AddAreaView(area.m_id, string_view(), string_view(), area.m_exits);
+        }
+    } catch (const invalid_argument& e) {
+        error = string(e.what()) + " (" + mapFile + ")";
+        return false;
+    }
+    //Check the map once here so opening the pack never has to (the game
+    //starts in area 0)
+    world.BuildAdjacency();
+    ThreadPool threads(0);
+    report = ValidateWorld(world, 0, threads);
+    if (!report.IsValid()) {
+        error = mapFile + " cannot be played, so it was not packed";
+        return false;
+    }
+    //Recipes: ingredients resolved to ItemIds with the same registry the
+    //game uses, so ids in the pack match ids after loading
+    ItemRegistry registry;
+    vector<PackRecipe> recipes;
+    vector<int32_t> reqs;
+    CraftRecord craft;
+    string name;
+    pos = 0;
+    while (ParseCraftRecord(craftText.View(), pos, craft)) {
+        PackRecipe recipe;
+        recipe.m_firstReq = static_cast<uint32_t>(reqs.size());
+        recipe.m_reqCount = static_cast<uint32_t>(craft.m_reqs.size());
+        recipe.m_pad = 0;
+        for (unsigned long i = 0; i < craft.m_reqs.size(); i++) {
+            name.assign(craft.m_reqs[i]);
+            reqs.push_back(registry.Intern(name));
+        }
+        name.assign(craft.m_product);
+        recipe.m_item = registry.Intern(name);
+        recipes.push_back(recipe);
+    }
+    vector<PackString> itemNames;
+    for (int id = 0; id < registry.GetSize(); id++) {
+        itemNames.push_back(AddText(pool, registry.GetName(id)));
+    }
+    //Landmark tables are O(landmarks) BFS passes; doing them here means
+    //the game never does them at open
+    Router router(world);
+    uint64_t landmarkEntries = uint64_t(areaIds.size()) * 2 * router.GetLandmarkCount();
+    //Lay the sections out back to back on 8-byte boundaries
+    PackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.m_version = PACK_VERSION;
+    header.m_areaCount = static_cast<uint32_t>(areaIds.size());
+    header.m_itemCount = static_cast<uint32_t>(itemNames.size());
+    header.m_recipeCount = static_cast<uint32_t>(recipes.size());
+    header.m_reqCount = static_cast<uint32_t>(reqs.size());
+    header.m_landmarkCount = static_cast<uint32_t>(router.GetLandmarkCount());
+    header.m_exitsOffset = AlignUp(sizeof(PackHeader));
+    header.m_areaIdsOffset = AlignUp(header.m_exitsOffset + exits.size() * sizeof(int32_t));
+    header.m_areaTextOffset = AlignUp(header.m_areaIdsOffset + areaIds.size() * sizeof(int32_t));
+    header.m_itemNamesOffset = AlignUp(header.m_areaTextOffset + areaText.size() * sizeof(PackString));
+    header.m_recipesOffset = AlignUp(header.m_itemNamesOffset + itemNames.size() * sizeof(PackString));
+    header.m_reqsOffset = AlignUp(header.m_recipesOffset + recipes.size() * sizeof(PackRecipe));
+    header.m_landmarksOffset = AlignUp(header.m_reqsOffset + reqs.size() * sizeof(int32_t));
+    header.m_poolOffset = AlignUp(header.m_landmarksOffset + landmarkEntries * sizeof(uint16_t));
+    header.m_poolSize = pool.size();
+    header.m_fileSize = header.m_poolOffset + pool.size();
+    ofstream out(packFile, ios::binary | ios::trunc);
+    if (!out) {
+        error = "cannot write " + packFile;
+        return false;
+    }
+    WriteSection(out, 0, &header, sizeof(header));
+    WriteSection(out, header.m_exitsOffset, exits.data(), exits.size() * sizeof(int32_t));
+    WriteSection(out, header.m_areaIdsOffset, areaIds.data(), areaIds.size() * sizeof(int32_t));
+    WriteSection(out, header.m_areaTextOffset, areaText.data(), areaText.size() * sizeof(PackString));
+    WriteSection(out, header.m_itemNamesOffset, itemNames.data(), itemNames.size() * sizeof(PackString));
+    WriteSection(out, header.m_recipesOffset, recipes.data(), recipes.size() * sizeof(PackRecipe));
+    WriteSection(out, header.m_reqsOffset, reqs.data(), reqs.size() * sizeof(int32_t));
+    WriteSection(out, header.m_landmarksOffset, router.GetLandmarkTable(), landmarkEntries * sizeof(uint16_t));
+    WriteSection(out, header.m_poolOffset, pool.data(), pool.size());
+    if (!out) {
+        error = "write failed for " + packFile;
+        return false;
+    }
+    return true;
+}
+
+  // Name: WorldPack()
+  // Description: Creates a closed pack.
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false.
+WorldPack::WorldPack() : m_header(nullptr), m_base(nullptr) {}
+  // Name: Open(const string& path)
+  // Description: Maps a pack and checks its magic, version and layout,
+  //              then makes one pass over the exit table so no exit can
+  //              lead outside the map.
+  // Preconditions: None.
+  // Postconditions: Returns true if the pack is usable.
+bool WorldPack::Open(const string& path) {
+    m_header = nullptr;
+    m_base = nullptr;
+    if (!m_file.Open(path)) {
+        return false;
+    }
+    string_view bytes = m_file.View();
+    if (bytes.size() < sizeof(PackHeader)) {
+        m_file.Close();
+        return false;
+    }
+    const PackHeader *header = reinterpret_cast<const PackHeader*>(bytes.data());
+    //Every section must lie inside the file on an 8-byte boundary, and
+    //the landmark tables must be the ones a Router builds for this many
+    //areas
+    uint64_t size = bytes.size();
+    uint32_t landmarks = header->m_areaCount >= uint32_t(ALT_MIN_AREAS) ? ROUTER_LANDMARKS : 0;
+    uint64_t landmarkBytes = uint64_t(header->m_areaCount) * 2 * landmarks * sizeof(uint16_t);
+    bool valid = memcmp(header->m_magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0
+        && header->m_version == PACK_VERSION
+        && header->m_fileSize == size
+        && header->m_areaCount > 0 && header->m_areaCount <= uint32_t(INT32_MAX)
+        && SectionFits(header->m_exitsOffset, uint64_t(header->m_areaCount) * 4 * sizeof(int32_t), size)
+        && SectionFits(header->m_areaIdsOffset, uint64_t(header->m_areaCount) * sizeof(int32_t), size)
+        && SectionFits(header->m_areaTextOffset, uint64_t(header->m_areaCount) * 2 * sizeof(PackString), size)
+        && SectionFits(header->m_itemNamesOffset, uint64_t(header->m_itemCount) * sizeof(PackString), size)
+        && SectionFits(header->m_recipesOffset, uint64_t(header->m_recipeCount) * sizeof(PackRecipe), size)
+        && SectionFits(header->m_reqsOffset, uint64_t(header->m_reqCount) * sizeof(int32_t), size)
+        && header->m_landmarkCount == landmarks
+        && SectionFits(header->m_poolOffset, header->m_poolSize, size)
+        && SectionFits(header->m_landmarksOffset, landmarkBytes, header->m_poolOffset);
+    if (valid) {
+        //Routing and play follow exits without checks, so a hand-edited
+        //exit must not point past the map; this is O(areas), no copy
+        const int32_t *exits = reinterpret_cast<const int32_t*>(bytes.data() + header->m_exitsOffset);
+        uint64_t exitCount = uint64_t(header->m_areaCount) * 4;
+        for (uint64_t i = 0; i < exitCount && valid; i++) {
+            valid = exits[i] == NO_EXIT
+                || (exits[i] >= 0 && uint32_t(exits[i]) < header->m_areaCount);
+        }
+    }
+    if (!valid) {
+        m_file.Close();
+        return false;
+    }
+    m_header = header;
+    m_base = bytes.data();
+    return true;
+}
+  // Name: IsOpen() const
+  // Description: Reports whether a valid pack is mapped.
+  // Preconditions: None.
+  // Postconditions: Returns true after a successful Open.
+bool WorldPack::IsOpen() const {
+    return m_header != nullptr;
+}
+  // Name: GetAreaCount() const
+  // Description: Number of areas in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the area count.
+int WorldPack::GetAreaCount() const {
+    return static_cast<int>(m_header->m_areaCount);
+}
+  // Name: GetAreaId(int index) const
+  // Description: Id field of the area record at index.
+  // Preconditions: 0 <= index < GetAreaCount().
+  // Postconditions: Returns the id.
+int WorldPack::GetAreaId(int index) const {
+    return reinterpret_cast<const int32_t*>(m_base + m_header->m_areaIdsOffset)[index];
+}
+  // Name: GetExits(int index) const
+  // Description: The four exits of the area at index.
+  // Preconditions: 0 <= index < GetAreaCount().
+  // Postconditions: Returns a pointer to North, East, South, West.
+const int32_t* WorldPack::GetExits(int index) const {
+    return reinterpret_cast<const int32_t*>(m_base + m_header->m_exitsOffset) + 4 * index;
+}
+  // Name: GetAreaName(int index) const
+  // Description: Name of the area at index.
+  // Preconditions: 0 <= index < GetAreaCount().
+  // Postconditions: Returns a view into the mapping.
+string_view WorldPack::GetAreaName(int index) const {
+    return Text(reinterpret_cast<const PackString*>(m_base + m_header->m_areaTextOffset)[2 * index]);
+}
+  // Name: GetAreaDesc(int index) const
+  // Description: Description of the area at index.
+  // Preconditions: 0 <= index < GetAreaCount().
+  // Postconditions: Returns a view into the mapping.
+string_view WorldPack::GetAreaDesc(int index) const {
+    return Text(reinterpret_cast<const PackString*>(m_base + m_header->m_areaTextOffset)[2 * index + 1]);
+}
+  // Name: GetItemCount() const
+  // Description: Number of item names in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the item count.
+int WorldPack::GetItemCount() const {
+    return static_cast<int>(m_header->m_itemCount);
+}
+  // Name: GetItemName(int id) const
+  // Description: Name of the item with the given ItemId.
+  // Preconditions: 0 <= id < GetItemCount().
+  // Postconditions: Returns a view into the mapping.
+string_view WorldPack::GetItemName(int id) const {
+    return Text(reinterpret_cast<const PackString*>(m_base + m_header->m_itemNamesOffset)[id]);
+}
+  // Name: GetRecipeCount() const
+  // Description: Number of recipes in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the recipe count.
+int WorldPack::GetRecipeCount() const {
+    return static_cast<int>(m_header->m_recipeCount);
+}
+  // Name: GetRecipe(int index) const
+  // Description: Recipe at index, in craft file order.
+  // Preconditions: 0 <= index < GetRecipeCount().
+  // Postconditions: Returns the recipe entry.
+const PackRecipe& WorldPack::GetRecipe(int index) const {
+    return reinterpret_cast<const PackRecipe*>(m_base + m_header->m_recipesOffset)[index];
+}
+  // Name: GetReqCount() const
+  // Description: Number of ingredient entries in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the entry count.
+int WorldPack::GetReqCount() const {
+    return static_cast<int>(m_header->m_reqCount);
+}
+  // Name: GetReqs(const PackRecipe& recipe) const
+  // Description: Ingredient ids of a recipe.
+  // Preconditions: recipe.m_firstReq + recipe.m_reqCount <= GetReqCount()
+  //                (LoadPack checks every recipe).
+  // Postconditions: Returns a pointer to recipe.m_reqCount ItemIds.
+const int32_t* WorldPack::GetReqs(const PackRecipe& recipe) const {
+    return reinterpret_cast<const int32_t*>(m_base + m_header->m_reqsOffset) + recipe.m_firstReq;
+}
+  // Name: Text(const PackString& ref) const
+  // Description: Resolves a pool reference.
+  // Preconditions: ref came from this pack.
+  // Postconditions: Returns a view into the mapping, or an empty view if
+  //                 ref reaches past the pool (a corrupt pack).
+string_view WorldPack::Text(const PackString& ref) const {
+    uint64_t poolSize = m_header->m_poolSize;
+    if (ref.m_offset > poolSize || ref.m_length > poolSize - ref.m_offset) {
+        return string_view();
+    }
+    return string_view(m_base + m_header->m_poolOffset + ref.m_offset, ref.m_length);
+}
+  // Name: GetLandmarkCount() const
+  // Description: Number of router landmarks stored in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns 0 for maps routed with plain BFS.
+int WorldPack::GetLandmarkCount() const {
+    return static_cast<int>(m_header->m_landmarkCount);
+}
+  // Name: GetLandmarks() const
+  // Description: The router's landmark distance tables, laid out as
+  //              Router::GetLandmarkTable.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns a pointer into the mapping (null when
+  //                 GetLandmarkCount() is 0).
+const uint16_t* WorldPack::GetLandmarks() const {
+    if (m_header->m_landmarkCount == 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<const uint16_t*>(m_base + m_header->m_landmarksOffset);
+}
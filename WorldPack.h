@@ -0,0 +1,186 @@
+#ifndef WORLDPACK_H
+#define WORLDPACK_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "MappedFile.h"
+#include "WorldValidator.h"
+using namespace std;
+
+//World pack: one binary file holding a compiled map and craft file, laid
+//out so it can be memory mapped and used in place (see packc.cpp for the
+//compiler). All integers are in host byte order; every section starts on
+//an 8-byte boundary.
+//
+//  PackHeader
+//  int32_t    exits[areaCount * 4]     North, East, South, West per area
+//  int32_t    areaIds[areaCount]       Id field of each area record
+//  PackString areaText[areaCount * 2]  Name, description per area
+//  PackString itemNames[itemCount]     Item names in ItemId order
+//  PackRecipe recipes[recipeCount]     Crafted item and its ingredients
+//  int32_t    reqs[reqCount]           Ingredient ItemIds, by recipe
+//  uint16_t   landmarks[areaCount * 2 * landmarkCount]
+//                                      Router's ALT tables (see Router.h)
+//  char       pool[poolSize]           Text referenced by PackStrings
+
+const char PACK_MAGIC[4] = {'C', 'Q', 'W', 'P'};
+const uint32_t PACK_VERSION = 3; //2: landmark tables; 3: only valid worlds
+
+//Location of a string in the pack's text pool
+struct PackString {
+  uint64_t m_offset; //Offset from the start of the pool
+  uint32_t m_length; //Length in bytes
+  uint32_t m_pad; //Keeps the struct 8-byte aligned
+};
+
+//One recipe: the product and a run of entries in the reqs section
+struct PackRecipe {
+  int32_t m_item; //ItemId of the crafted product
+  uint32_t m_firstReq; //Index of the first ingredient in reqs
+  uint32_t m_reqCount; //Number of ingredients
+  uint32_t m_pad; //Keeps the struct 8-byte aligned
+};
+
+struct PackHeader {
+  char m_magic[4]; //PACK_MAGIC
+  uint32_t m_version; //PACK_VERSION
+  uint32_t m_areaCount; //Areas in the map
+  uint32_t m_itemCount; //Registered item names
+  uint32_t m_recipeCount; //Recipes in the craft file
+  uint32_t m_reqCount; //Total ingredient entries
+  uint32_t m_landmarkCount; //Router landmarks (0 = small map, plain BFS)
+  uint32_t m_pad; //Keeps the offsets 8-byte aligned
+  uint64_t m_exitsOffset; //File offsets of each section
+  uint64_t m_areaIdsOffset;
+  uint64_t m_areaTextOffset;
+  uint64_t m_itemNamesOffset;
+  uint64_t m_recipesOffset;
+  uint64_t m_reqsOffset;
+  uint64_t m_landmarksOffset;
+  uint64_t m_poolOffset;
+  uint64_t m_poolSize; //Bytes in the text pool
+  uint64_t m_fileSize; //Total pack size (checked on open)
+};
+
+// Name: CompilePack(const string& mapFile, const string& craftFile,
+//                   const string& packFile, ValidationReport& report,
+//                   string& error)
+// Description: Parses a map file and a craft file, validates the map
+//              (ValidateWorld from area 0) and writes them as a world
+//              pack, with the router's landmark tables precomputed. The
+//              game trusts a pack's exit table, so a map that fails
+//              validation is never packed.
+// Preconditions: Both inputs use the '|' delimited formats.
+// Postconditions: Returns true and writes packFile on success; returns
+//                 false and sets error otherwise (report holds the
+//                 problems when the map is the reason).
+bool CompilePack(const string& mapFile, const string& craftFile,
+                 const string& packFile, ValidationReport& report, string& error);
+
+//Read-only view of a world pack. Open maps the file, validates the header
+//and checks that every exit is NO_EXIT or an area of the pack, in one pass
+//over the exit table; every accessor then reads straight from the
+//mapping, with nothing copied. Other indices inside entries are not
+//checked by Open: text references are bounded by Text and Game::LoadPack
+//checks every recipe before using it. Reachability and the rest of the
+//world check were done by CompilePack.
+class WorldPack {
+public:
+  // Name: WorldPack()
+  // Description: Creates a closed pack.
+  // Preconditions: None.
+  // Postconditions: IsOpen() is false.
+  WorldPack();
+  // Name: Open(const string& path)
+  // Description: Maps a pack and checks its magic, version and layout,
+  //              then makes one pass over the exit table so no exit can
+  //              lead outside the map.
+  // Preconditions: None.
+  // Postconditions: Returns true if the pack is usable.
+  bool Open(const string& path);
+  // Name: IsOpen() const
+  // Description: Reports whether a valid pack is mapped.
+  // Preconditions: None.
+  // Postconditions: Returns true after a successful Open.
+  bool IsOpen() const;
+  // Name: GetAreaCount() const
+  // Description: Number of areas in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the area count.
+  int GetAreaCount() const;
+  // Name: GetAreaId(int index) const
+  // Description: Id field of the area record at index.
+  // Preconditions: 0 <= index < GetAreaCount().
+  // Postconditions: Returns the id.
+  int GetAreaId(int index) const;
+  // Name: GetExits(int index) const
+  // Description: The four exits of the area at index.
+  // Preconditions: 0 <= index < GetAreaCount().
+  // Postconditions: Returns a pointer to North, East, South, West.
+  const int32_t* GetExits(int index) const;
+  // Name: GetAreaName(int index) const
+  // Description: Name of the area at index.
+  // Preconditions: 0 <= index < GetAreaCount().
+  // Postconditions: Returns a view into the mapping.
+  string_view GetAreaName(int index) const;
+  // Name: GetAreaDesc(int index) const
+  // Description: Description of the area at index.
+  // Preconditions: 0 <= index < GetAreaCount().
+  // Postconditions: Returns a view into the mapping.
+  string_view GetAreaDesc(int index) const;
+  // Name: GetItemCount() const
+  // Description: Number of item names in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the item count.
+  int GetItemCount() const;
+  // Name: GetItemName(int id) const
+  // Description: Name of the item with the given ItemId.
+  // Preconditions: 0 <= id < GetItemCount().
+  // Postconditions: Returns a view into the mapping.
+  string_view GetItemName(int id) const;
+  // Name: GetRecipeCount() const
+  // Description: Number of recipes in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the recipe count.
+  int GetRecipeCount() const;
+  // Name: GetRecipe(int index) const
+  // Description: Recipe at index, in craft file order.
+  // Preconditions: 0 <= index < GetRecipeCount().
+  // Postconditions: Returns the recipe entry.
+  const PackRecipe& GetRecipe(int index) const;
+  // Name: GetReqCount() const
+  // Description: Number of ingredient entries in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns the entry count.
+  int GetReqCount() const;
+  // Name: GetReqs(const PackRecipe& recipe) const
+  // Description: Ingredient ids of a recipe.
+  // Preconditions: recipe.m_firstReq + recipe.m_reqCount <= GetReqCount()
+  //                (LoadPack checks every recipe).
+  // Postconditions: Returns a pointer to recipe.m_reqCount ItemIds.
+  const int32_t* GetReqs(const PackRecipe& recipe) const;
+  // Name: GetLandmarkCount() const
+  // Description: Number of router landmarks stored in the pack.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns 0 for maps routed with plain BFS.
+  int GetLandmarkCount() const;
+  // Name: GetLandmarks() const
+  // Description: The router's landmark distance tables, laid out as
+  //              Router::GetLandmarkTable.
+  // Preconditions: IsOpen().
+  // Postconditions: Returns a pointer into the mapping (null when
+  //                 GetLandmarkCount() is 0).
+  const uint16_t* GetLandmarks() const;
+private:
+  // Name: Text(const PackString& ref) const
+  // Description: Resolves a pool reference.
+  // Preconditions: ref came from this pack.
+  // Postconditions: Returns a view into the mapping, or an empty view if
+  //                 ref reaches past the pool (a corrupt pack).
+  string_view Text(const PackString& ref) const;
+  MappedFile m_file; //Mapping of the whole pack
+  const PackHeader* m_header; //Header at the start of the mapping
+  const char* m_base; //Start of the mapping
+};
+
+#endif
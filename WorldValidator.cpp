@@ -0,0 +1,238 @@
+#include "WorldValidator.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+//Findings of one chunk of areas, merged in chunk order
+struct ChunkFindings {
+    vector<ExitRef> m_dangling;
+    vector<int> m_idMismatches;
+    vector<ExitRef> m_oneWay;
+};
+
+// Name: CheckChunk(const World& world, int first, int last, ChunkFindings& found)
+// Description: Per-area checks for areas first .. last - 1.
+// Preconditions: 0 <= first <= last <= world.GetSize().
+// Postconditions: found holds the chunk's findings in area order.
+static void CheckChunk(const World& world, int first, int last, ChunkFindings& found) {
+    int size = world.GetSize();
+    for (int area = first; area < last; area++) {
+        if (world.GetId(area) != area) {
+            found.m_idMismatches.push_back(area);
+        }
+        const int32_t *exits = world.GetExits(area);
+        for (int d = 0; d < EXIT_COUNT; d++) {
+            int target = exits[d];
+            if (target == NO_EXIT) {
+                continue;
+            }
+            if (target < 0 || target >= size) {
+                found.m_dangling.push_back(ExitRef{area, d, target});
+                continue;
+            }
+            //Two-way if any exit of the target leads straight back
+            const int32_t *back = world.GetExits(target);
+            if (back[0] != area && back[1] != area && back[2] != area && back[3] != area) {
+                found.m_oneWay.push_back(ExitRef{area, d, target});
+            }
+        }
+    }
+}
+
+// Name: FindComponents(const World& world, ValidationReport& report)
+// Description: Iterative Tarjan over the CSR adjacency.
+// Preconditions: world.BuildAdjacency() has run.
+// Postconditions: m_component, m_componentCount and m_largestComponent
+//                 are filled.
+static void FindComponents(const World& world, ValidationReport& report) {
+    int size = world.GetSize();
+    vector<int> index(size, -1);
+    vector<int> low(size, 0);
+    vector<char> onStack(size, 0);
+    vector<int> stack;
+    //Explicit DFS stack: area and the next neighbor to try
+    vector<pair<int, int>> calls;
+    report.m_component.assign(size, -1);
+    report.m_componentCount = 0;
+    report.m_largestComponent = 0;
+    int counter = 0;
+    for (int root = 0; root < size; root++) {
+        if (index[root] >= 0) {
+            continue;
+        }
+        calls.push_back(make_pair(root, 0));
+        index[root] = low[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = 1;
+        while (!calls.empty()) {
+            int area = calls.back().first;
+            int count = 0;
+            const int32_t *next = world.GetNeighbors(area, count);
+            if (calls.back().second < count) {
+                int target = next[calls.back().second++];
+                if (index[target] < 0) {
+                    //Descend
+                    index[target] = low[target] = counter++;
+                    stack.push_back(target);
+                    onStack[target] = 1;
+                    calls.push_back(make_pair(target, 0));
+                } else if (onStack[target]) {
+                    low[area] = min(low[area], index[target]);
+                }
+                continue;
+            }
+            //All neighbors done: close a component or return to the parent
+            calls.pop_back();
+            if (!calls.empty()) {
+                int parent = calls.back().first;
+                low[parent] = min(low[parent], low[area]);
+            }
+            if (low[area] == index[area]) {
+                int members = 0;
+                int member = -1;
+                while (member != area) {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member] = 0;
+                    report.m_component[member] = report.m_componentCount;
+                    members++;
+                }
+                report.m_componentCount++;
+                report.m_largestComponent = max(report.m_largestComponent, members);
+            }
+        }
+    }
+}
+
+// Name: ValidateWorld(const World& world, int start, ThreadPool& pool)
+// Description: Checks every exit and measures connectivity. Per-area
+//              checks run in chunks of VALIDATE_CHUNK areas on the pool,
+//              alongside a single task that finds the strongly connected
+//              components (iterative Tarjan); reachability from start is
+//              then a level-synchronous parallel BFS.
+// Preconditions: world.BuildAdjacency() has run.
+// Postconditions: Returns the report; lists are in area order.
+ValidationReport ValidateWorld(const World& world, int start, ThreadPool& pool) {
+    ValidationReport report;
+    int size = world.GetSize();
+    report.m_areaCount = size;
+    report.m_start = start;
+    report.m_componentCount = 0;
+    report.m_largestComponent = 0;
+    if (size == 0 || start < 0 || start >= size) {
+        return report;
+    }
+    //Components on one worker while the others check exits
+    int chunks = (size + VALIDATE_CHUNK - 1) / VALIDATE_CHUNK;
+    vector<ChunkFindings> found(chunks);
+    pool.Submit([&]() { FindComponents(world, report); });
+    for (int c = 0; c < chunks; c++) {
+        pool.Submit([&, c]() {
+            CheckChunk(world, c * VALIDATE_CHUNK, min(size, (c + 1) * VALIDATE_CHUNK), found[c]);
+        });
+    }
+    pool.Wait();
+    for (int c = 0; c < chunks; c++) {
+        report.m_danglingExits.insert(report.m_danglingExits.end(), found[c].m_dangling.begin(),
+                                      found[c].m_dangling.end());
+        report.m_idMismatches.insert(report.m_idMismatches.end(), found[c].m_idMismatches.begin(),
+                                     found[c].m_idMismatches.end());
+        report.m_oneWay.insert(report.m_oneWay.end(), found[c].m_oneWay.begin(),
+                               found[c].m_oneWay.end());
+    }
+    //Reachability: expand each BFS level in chunks; areas are claimed
+    //with an atomic exchange so each joins exactly one next level
+    unique_ptr<atomic<unsigned char>[]> seen(new atomic<unsigned char>[size]());
+    seen[start].store(1, memory_order_relaxed);
+    vector<int> frontier(1, start);
+    while (!frontier.empty()) {
+        int parts = (static_cast<int>(frontier.size()) + VALIDATE_CHUNK - 1) / VALIDATE_CHUNK;
+        vector<vector<int>> next(parts);
+        auto expand = [&](int p) {
+            size_t last = min(frontier.size(), static_cast<size_t>(p + 1) * VALIDATE_CHUNK);
+            for (size_t i = static_cast<size_t>(p) * VALIDATE_CHUNK; i < last; i++) {
+                int count = 0;
+                const int32_t *targets = world.GetNeighbors(frontier[i], count);
+                for (int k = 0; k < count; k++) {
+                    if (seen[targets[k]].exchange(1, memory_order_relaxed) == 0) {
+                        next[p].push_back(targets[k]);
+                    }
+                }
+            }
+        };
+        if (parts == 1) {
+            //Small levels are not worth a round trip through the pool
+            expand(0);
+        } else {
+            pool.ParallelFor(parts, expand);
+        }
+        frontier.clear();
+        for (int p = 0; p < parts; p++) {
+            frontier.insert(frontier.end(), next[p].begin(), next[p].end());
+        }
+    }
+    for (int area = 0; area < size; area++) {
+        if (seen[area].load(memory_order_relaxed) == 0) {
+            report.m_unreachable.push_back(area);
+        }
+    }
+    return report;
+}
+
+  // Name: IsValid() const
+  // Description: Checks for fatal problems.
+  // Preconditions: None.
+  // Postconditions: Returns true if the world is safe to play.
+bool ValidationReport::IsValid() const {
+    return m_areaCount > 0 && m_start >= 0 && m_start < m_areaCount
+        && m_danglingExits.empty() && m_idMismatches.empty();
+}
+
+// Name: PrintExits(OutputSink& out, const char* label, const vector<ExitRef>& exits)
+// Description: Writes one list of exits, capped at REPORT_LIST_LIMIT.
+// Preconditions: None.
+// Postconditions: The list is written to out.
+static void PrintExits(OutputSink& out, const char* label, const vector<ExitRef>& exits) {
+    const char *directionNames[EXIT_COUNT] = {"North", "East", "South", "West"};
+    out << label << ": " << exits.size() << '\n';
+    for (unsigned long i = 0; i < exits.size() && i < REPORT_LIST_LIMIT; i++) {
+        out << "  area " << exits[i].m_area << " " << directionNames[exits[i].m_direction]
+            << " -> " << exits[i].m_target << '\n';
+    }
+}
+
+// Name: PrintAreas(OutputSink& out, const char* label, const vector<int>& areas)
+// Description: Writes one list of areas, capped at REPORT_LIST_LIMIT.
+// Preconditions: None.
+// Postconditions: The list is written to out.
+static void PrintAreas(OutputSink& out, const char* label, const vector<int>& areas) {
+    out << label << ": " << areas.size() << '\n';
+    if (areas.empty()) {
+        return;
+    }
+    out << " ";
+    for (unsigned long i = 0; i < areas.size() && i < REPORT_LIST_LIMIT; i++) {
+        out << " " << areas[i];
+    }
+    out << (areas.size() > static_cast<unsigned long>(REPORT_LIST_LIMIT) ? " ..." : "") << '\n';
+}
+
+// Name: PrintReport(OutputSink& out, const ValidationReport& report)
+// Description: Writes a summary and the first REPORT_LIST_LIMIT entries
+//              of each list.
+// Preconditions: None.
+// Postconditions: The report is written to out.
+void PrintReport(OutputSink& out, const ValidationReport& report) {
+    out << "World check: " << report.m_areaCount << " areas, "
+        << (report.IsValid() ? "OK" : "INVALID") << '\n';
+    if (report.m_areaCount == 0) {
+        out << "The map has no areas" << '\n';
+        return;
+    }
+    PrintExits(out, "Dangling exits", report.m_danglingExits);
+    PrintAreas(out, "Id/position mismatches", report.m_idMismatches);
+    PrintAreas(out, "Unreachable from the start", report.m_unreachable);
+    PrintExits(out, "One-way passages", report.m_oneWay);
+    out << "Strongly connected components: " << report.m_componentCount
+        << " (largest " << report.m_largestComponent << " areas)" << '\n';
+}
@@ -0,0 +1,58 @@
+#ifndef WORLDVALIDATOR_H
+#define WORLDVALIDATOR_H
+#include <iostream>
+#include <vector>
+#include "World.h"
+#include "ThreadPool.h"
+#include "OutputSink.h"
+using namespace std;
+
+const int VALIDATE_CHUNK = 1 << 14; //Areas per parallel validation task
+const int REPORT_LIST_LIMIT = 10; //Entries of each kind PrintReport lists
+
+//One exit named by the area it leaves and its direction
+struct ExitRef {
+  int m_area; //Area index the exit leaves from
+  int m_direction; //0-3: North, East, South, West
+  int m_target; //Value of the exit
+};
+
+//Result of ValidateWorld. Fatal problems (IsValid() false) would crash or
+//strand the hero: exits that point outside the map, id fields that do not
+//match the area's position (Move treats exits as positions), or an empty
+//map. The rest is analysis: areas the hero can never reach from the
+//start, one-way passages and the strongly connected components.
+struct ValidationReport {
+  int m_areaCount; //Areas checked
+  int m_start; //Area reachability is measured from
+  vector<ExitRef> m_danglingExits; //Exits to a missing area (fatal)
+  vector<int> m_idMismatches; //Areas whose id is not their index (fatal)
+  vector<int> m_unreachable; //Areas not reachable from m_start
+  vector<ExitRef> m_oneWay; //Exits with no exit straight back
+  vector<int> m_component; //Strongly connected component per area
+  int m_componentCount; //Number of strongly connected components
+  int m_largestComponent; //Areas in the biggest component
+  // Name: IsValid() const
+  // Description: Checks for fatal problems.
+  // Preconditions: None.
+  // Postconditions: Returns true if the world is safe to play.
+  bool IsValid() const;
+};
+
+// Name: ValidateWorld(const World& world, int start, ThreadPool& pool)
+// Description: Checks every exit and measures connectivity. Per-area
+//              checks run in chunks of VALIDATE_CHUNK areas on the pool,
+//              alongside a single task that finds the strongly connected
+//              components (iterative Tarjan); reachability from start is
+//              then a level-synchronous parallel BFS.
+// Preconditions: world.BuildAdjacency() has run.
+// Postconditions: Returns the report; lists are in area order.
+ValidationReport ValidateWorld(const World& world, int start, ThreadPool& pool);
+// Name: PrintReport(OutputSink& out, const ValidationReport& report)
+// Description: Writes a summary and the first REPORT_LIST_LIMIT entries
+//              of each list.
+// Preconditions: None.
+// Postconditions: The report is written to out.
+void PrintReport(OutputSink& out, const ValidationReport& report);
+
+#endif
@@ -0,0 +1,85 @@
+#include "Game.h"
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+using namespace std;
+
+//Allocation-count test for the loaders. Loads the shipped map and craft
+//files with each text loader and fails if the heap allocations per
+//record go over a fixed bound. The bounds cover the fixed costs (stream
+//buffers, vector growth, one Item and requirement list per recipe and
+//the registry's copy of each new name) spread over the shipped files.
+//They leave no room for another heap copy per record: every shipped
+//description is far too long for the small-string buffer, so copying it
+//once more per area already breaks the map bound.
+//Build: see README (test target). Run: ./cavern_alloc_test (exit 1 = failure)
+
+const char* TEST_MAP = "proj5_map2.txt"; //Shipped map (long descriptions)
+const char* TEST_CRAFT = "proj5_craft.txt"; //Shipped recipes
+const double MAX_MAP_ALLOCS = 4.0; //Allocations per area, both map loaders
+const double MAX_CRAFT_ALLOCS = 7.0; //Allocations per recipe, both craft loaders
+
+//Every heap allocation in the test binary goes through here
+static atomic<long> g_allocCount(0);
+
+void* operator new(size_t size) {
+  g_allocCount++;
+  void *p = malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+// Name: CheckLoader(const string& name, function<long(Game&)> load, double bound)
+// Description: Runs load on a fresh Game and compares the allocations it
+//              made per record (load returns the record count) to bound.
+// Preconditions: The shipped files are in the working directory.
+// Postconditions: One result line is printed; returns true if it passed.
+static bool CheckLoader(const string& name, function<long(Game&)> load, double bound) {
+  Game game(TEST_MAP, TEST_CRAFT);
+  long before = g_allocCount;
+  long records = load(game);
+  long allocs = g_allocCount - before;
+  if (records <= 0) {
+    cout << "FAIL " << name << ": nothing loaded (run from the repo directory)" << endl;
+    return false;
+  }
+  double perRecord = static_cast<double>(allocs) / records;
+  bool passed = perRecord <= bound;
+  cout << (passed ? "PASS " : "FAIL ") << name << ": " << allocs << " allocations / "
+       << records << " records = " << perRecord << " (max " << bound << ")" << endl;
+  return passed;
+}
+
+int main() {
+  bool passed = true;
+  passed &= CheckLoader("LoadMap", [](Game& game) {
+    game.LoadMap();
+    return static_cast<long>(game.GetAreaCount());
+  }, MAX_MAP_ALLOCS);
+  passed &= CheckLoader("LoadMapMapped", [](Game& game) {
+    game.LoadMapMapped();
+    return static_cast<long>(game.GetAreaCount());
+  }, MAX_MAP_ALLOCS);
+  passed &= CheckLoader("LoadCraft", [](Game& game) {
+    game.LoadCraft();
+    return static_cast<long>(game.GetItems().size());
+  }, MAX_CRAFT_ALLOCS);
+  passed &= CheckLoader("LoadCraftMapped", [](Game& game) {
+    game.LoadCraftMapped();
+    return static_cast<long>(game.GetItems().size());
+  }, MAX_CRAFT_ALLOCS);
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include "Bench.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+using namespace std;
+
+//Every heap allocation in the benchmark binary goes through here so the
+//groups can report allocations per operation (atomic: the parallel
+//loader allocates from pool threads)
+static atomic<long> g_allocCount(0);
+
+void* operator new(size_t size) {
+  g_allocCount++;
+  void *p = malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+long AllocCount() {
+  return g_allocCount;
+}
+
+// Name: Percentile(const vector<double>& sorted, int percent)
+// Description: Nearest-rank percentile of sorted samples.
+// Preconditions: sorted is ascending and not empty; 0 < percent <= 100.
+// Postconditions: Returns the sample.
+static double Percentile(const vector<double>& sorted, int percent) {
+  unsigned long rank = (sorted.size() * percent + 99) / 100;
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Name: JsonString(const string& text)
+// Description: Quotes text as a JSON string.
+// Preconditions: None.
+// Postconditions: Returns the literal.
+static string JsonString(const string& text) {
+  string quoted = "\"";
+  for (unsigned long i = 0; i < text.size(); i++) {
+    if (text[i] == '"' || text[i] == '\\') {
+      quoted += '\\';
+    }
+    quoted += text[i];
+  }
+  return quoted + "\"";
+}
+
+// Name: PrintHeader() const
+// Description: Prints the column titles of the result lines.
+// Preconditions: None.
+// Postconditions: One line is written to cout.
+void Bench::PrintHeader() const {
+  cout << left << setw(48) << "benchmark" << right << setw(14) << "best ns/op" << setw(12)
+       << "median" << setw(12) << "p90" << setw(12) << "allocs/op" << endl;
+}
+
+// Name: Record(const string& name, long ops, vector<double>& samples, long allocs)
+// Description: Summarizes one run's ns/op samples, stores and prints it.
+// Preconditions: samples is not empty.
+// Postconditions: m_results has the result; samples is sorted.
+void Bench::Record(const string& name, long ops, vector<double>& samples, long allocs) {
+  sort(samples.begin(), samples.end());
+  BenchResult result;
+  result.m_group = m_group;
+  result.m_name = name;
+  result.m_ops = ops;
+  result.m_reps = static_cast<int>(samples.size());
+  result.m_best = samples[0];
+  result.m_median = Percentile(samples, 50);
+  result.m_p90 = Percentile(samples, 90);
+  result.m_allocs = static_cast<double>(allocs) / samples.size() / (ops > 0 ? ops : 1);
+  m_results.push_back(result);
+  cout << left << setw(48) << name << right << fixed << setprecision(1) << setw(14) << result.m_best
+       << setw(12) << result.m_median << setw(12) << result.m_p90 << setprecision(2) << setw(12)
+       << result.m_allocs << endl;
+}
+
+// Name: WriteJson(const string& path) const
+// Description: Writes every recorded result as a JSON document.
+// Preconditions: path is writable.
+// Postconditions: Returns false if the file could not be written.
+bool Bench::WriteJson(const string& path) const {
+  ofstream out(path);
+  out << "{\n  \"unit\": \"ns/op\",\n  \"results\": [";
+  for (unsigned long i = 0; i < m_results.size(); i++) {
+    const BenchResult& r = m_results[i];
+    out << (i > 0 ? "," : "") << "\n    {\"group\": " << JsonString(r.m_group)
+        << ", \"name\": " << JsonString(r.m_name) << ", \"ops\": " << r.m_ops
+        << ", \"reps\": " << r.m_reps << setprecision(6) << ", \"best\": " << r.m_best
+        << ", \"median\": " << r.m_median << ", \"p90\": " << r.m_p90
+        << ", \"allocs_per_op\": " << r.m_allocs << "}";
+  }
+  out << "\n  ]\n}\n";
+  return static_cast<bool>(out);
+}
+
+//Benchmark groups in run order
+struct BenchGroup {
+  const char *m_name;
+  void (*m_run)(Bench&);
+};
+
+const BenchGroup BENCH_GROUPS[] = {
+  {"map", RunMapBenchmarks},
+  {"load", RunLoadBenchmarks},
+  {"world", RunWorldBenchmarks},
+  {"craft", RunCraftBenchmarks},
+  {"random", RunRandomBenchmarks},
+  {"output", RunOutputBenchmarks},
+  {"snapshot", RunSnapshotBenchmarks},
+  {"journal", RunJournalBenchmarks}
+};
+
+int main(int argc, char *argv[]) {
+  //Optional group filter (substring, e.g. "map") and flags
+  string filter;
+  string jsonPath;
+  int reps = 0;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (arg == "--json" && i + 1 < argc) {
+      jsonPath = argv[++i];
+    } else if (arg == "--reps" && i + 1 < argc) {
+      reps = stoi(argv[++i]);
+    } else if (arg.compare(0, 2, "--") == 0) {
+      cout << "Usage: ./cavern_bench [group] [--reps N] [--json FILE]" << endl;
+      return 1;
+    } else {
+      filter = arg;
+    }
+  }
+  Bench bench(filter);
+  if (reps > 0) {
+    bench.SetRepetitions(reps);
+  }
+  bench.PrintHeader();
+  for (unsigned long i = 0; i < sizeof(BENCH_GROUPS) / sizeof(BENCH_GROUPS[0]); i++) {
+    if (bench.Enabled(BENCH_GROUPS[i].m_name)) {
+      bench.SetGroup(BENCH_GROUPS[i].m_name);
+      BENCH_GROUPS[i].m_run(bench);
+    }
+  }
+  if (!jsonPath.empty() && !bench.WriteJson(jsonPath)) {
+    cout << "Could not write " << jsonPath << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include "Bench.h"
+#include "CraftPlanner.h"
+#include "CraftIndex.h"
+#include "ItemRegistry.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+//Crafting benchmarks on a generated layered recipe graph: each item
+//needs a few items from the layer below, so plain recursion expands
+//shared sub-recipes again and again while the planner sums memoized
+//bills. The craftable-now set is timed as a full CanCraft scan per
+//pickup against the incremental CraftIndex, Hero::CollectItem and
+//CanCraft on their own, and crafting thousands of units one call at a
+//time (including the pickups) against a single batch.
+
+const int CRAFT_RAW = 200; //Raw materials in layer 0
+const int CRAFT_LAYERS = 16; //Crafted layers above the raw materials
+const int CRAFT_WIDTH = 400; //Items per crafted layer
+const int CRAFT_FANIN = 3; //Ingredients per recipe
+const int CRAFT_NAIVE_LAYER = 14; //Layer plain recursion is timed on
+
+// Name: NaiveRaw(ItemId item, const vector<const Item*>& recipes, vector<long long>& counts)
+// Description: Counts raw materials by expanding every recipe (no memo).
+// Preconditions: recipes is indexed by ItemId (nullptr = raw).
+// Postconditions: counts holds item's raw materials added in.
+static void NaiveRaw(ItemId item, const vector<const Item*>& recipes, vector<long long>& counts) {
+  if (recipes[item] == nullptr) {
+    counts[item]++;
+    return;
+  }
+  const vector<ItemId>& reqs = recipes[item]->GetReq();
+  for (unsigned long r = 0; r < reqs.size(); r++) {
+    NaiveRaw(reqs[r], recipes, counts);
+  }
+}
+
+void RunCraftBenchmarks(Bench& bench) {
+  cout << "== Crafting planner ==" << endl;
+  ItemRegistry registry;
+  vector<ItemId> below;
+  for (int i = 0; i < CRAFT_RAW; i++) {
+    below.push_back(registry.Intern("Raw " + to_string(i)));
+  }
+  vector<Item*> items;
+  vector<vector<ItemId>> layers;
+  unsigned int seed = 12345;
+  for (int layer = 1; layer <= CRAFT_LAYERS; layer++) {
+    vector<ItemId> current;
+    for (int i = 0; i < CRAFT_WIDTH; i++) {
+      vector<ItemId> reqs;
+      for (int r = 0; r < CRAFT_FANIN; r++) {
+        seed = seed * 1103515245 + 12345;
+        reqs.push_back(below[(seed >> 8) % below.size()]);
+      }
+      string name = "Item " + to_string(layer) + "-" + to_string(i);
+      ItemId id = registry.Intern(name);
+      items.push_back(new Item(name, id, reqs));
+      current.push_back(id);
+    }
+    layers.push_back(current);
+    below = current;
+  }
+  int itemCount = registry.GetSize();
+  string n = to_string(items.size());
+  bench.Run("Planner/build (sort)/" + n, items.size(), [&]() {
+    CraftPlanner planner(items, itemCount);
+    DoNotOptimize(planner.GetOrder().size());
+  });
+  //Cold: every top-layer bill from an empty memo
+  const vector<ItemId>& top = layers.back();
+  bench.Run("Planner/top bills, cold/" + n, top.size(), [&]() {
+    CraftPlanner planner(items, itemCount);
+    for (unsigned long i = 0; i < top.size(); i++) {
+      DoNotOptimize(planner.GetBill(top[i])->size());
+    }
+  });
+  //Warm: cached lookup plus the inventory diff
+  CraftPlanner planner(items, itemCount);
+  Hero hero("Bench", registry, 1);
+  for (int i = 0; i < CRAFT_RAW; i += 2) {
+    hero.CollectItem(i);
+  }
+  Bill missing;
+  bench.Run("Planner/missing, warm/" + n, top.size(), [&]() {
+    for (unsigned long i = 0; i < top.size(); i++) {
+      planner.GetMissing(top[i], hero, missing);
+      DoNotOptimize(missing.size());
+    }
+  });
+  //Plain recursion against the memo on a shallower layer
+  vector<const Item*> recipes(itemCount, nullptr);
+  for (unsigned long i = 0; i < items.size(); i++) {
+    recipes[items[i]->GetID()] = items[i];
+  }
+  ItemId target = layers[CRAFT_NAIVE_LAYER - 1][0];
+  string layer = "layer " + to_string(CRAFT_NAIVE_LAYER);
+  bench.Run("Bill/plain recursion/" + layer, 1, [&]() {
+    vector<long long> counts(itemCount, 0);
+    NaiveRaw(target, recipes, counts);
+    DoNotOptimize(counts[0]);
+  }, 1);
+  //Includes building the planner, since the memo starts empty
+  bench.Run("Bill/planner, cold/" + layer, 1, [&]() {
+    CraftPlanner cold(items, itemCount);
+    DoNotOptimize(cold.GetBill(target)->size());
+  });
+  //Craftable now after each pickup: rescan every recipe vs the index
+  const int pickups = 1000;
+  bench.Run("Craftable/CanCraft scan per pickup/" + n, pickups, [&]() {
+    Hero scanHero("Scan", registry, 1);
+    int craftable = 0;
+    for (int i = 0; i < pickups; i++) {
+      scanHero.CollectItem(static_cast<ItemId>((i * 7919) % itemCount));
+      craftable = 0;
+      for (unsigned long r = 0; r < items.size(); r++) {
+        craftable += scanHero.CanCraft(*items[r], 1);
+      }
+    }
+    DoNotOptimize(craftable);
+  });
+  CraftIndex index(items, itemCount);
+  bench.Run("Craftable/CraftIndex per pickup/" + n, pickups, [&]() {
+    Hero indexHero("Index", registry, 1);
+    indexHero.SetCraftIndex(&index);
+    unsigned long craftable = 0;
+    for (int i = 0; i < pickups; i++) {
+      indexHero.CollectItem(static_cast<ItemId>((i * 7919) % itemCount));
+      craftable = index.GetCraftable().size();
+    }
+    DoNotOptimize(craftable);
+  });
+  //Hero hot paths on their own: one pickup, one recipe check
+  const int heroOps = 100000;
+  bench.Run("Hero/CollectItem", heroOps, [&]() {
+    Hero collector("Collect", registry, 1);
+    for (int i = 0; i < heroOps; i++) {
+      collector.CollectItem(static_cast<ItemId>(i % itemCount));
+    }
+    DoNotOptimize(collector.GetCount(0));
+  });
+  bench.Run("Hero/CanCraft", heroOps, [&]() {
+    int craftable = 0;
+    for (int i = 0; i < heroOps; i++) {
+      craftable += hero.CanCraft(*items[i % CRAFT_WIDTH], 1);
+    }
+    DoNotOptimize(craftable);
+  });
+  //Thousands of units: one craft per call against one batch
+  const int units = 5000;
+  const Item& first = *items[0];
+  bench.Run("Craft/one at a time/" + to_string(units), units, [&]() {
+    Hero batchHero("Batch", registry, 1);
+    //Silence the "Crafted:" lines
+    NullSink quiet;
+    batchHero.SetOutput(&quiet);
+    for (int i = 0; i < units; i++) {
+      for (unsigned long r = 0; r < first.GetReq().size(); r++) {
+        batchHero.CollectItem(first.GetReq()[r]);
+      }
+    }
+    for (int i = 0; i < units; i++) {
+      batchHero.Craft(first, 1);
+    }
+    DoNotOptimize(batchHero.GetCount(first.GetID()));
+  });
+  bench.Run("Craft/one batch/" + to_string(units), units, [&]() {
+    Hero batchHero("Batch", registry, 1);
+    NullSink quiet;
+    batchHero.SetOutput(&quiet);
+    for (int i = 0; i < units; i++) {
+      for (unsigned long r = 0; r < first.GetReq().size(); r++) {
+        batchHero.CollectItem(first.GetReq()[r]);
+      }
+    }
+    batchHero.Craft(first, batchHero.MaxCraftable(first));
+    DoNotOptimize(batchHero.GetCount(first.GetID()));
+  });
+  for (unsigned long i = 0; i < items.size(); i++) {
+    delete items[i];
+  }
+}
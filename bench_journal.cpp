@@ -0,0 +1,114 @@
+#include "Bench.h"
+#include "Game.h"
+#include "Journal.h"
+#include "OutputSink.h"
+#include "Random.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+using namespace std;
+
+//Journal benchmarks: recording a session the way the game does (one
+//write per command) and in large batches, then replaying the whole
+//journal into a silent hero with no craft index, the way a session is
+//rebuilt on start. The session mixes moves, gathers and the occasional
+//affordable craft on a small generated recipe file.
+
+const int JOURNAL_ACTIONS = 1000000; //Actions in the replayed journal
+const int JOURNAL_FLUSHED_ACTIONS = 100000; //Actions recorded one write each
+const int JOURNAL_BATCH = 4096; //Actions per write when batching
+const int JOURNAL_AREAS = 100; //Areas moves pick from
+const int JOURNAL_RECIPES = 40; //Recipes in the generated craft file
+const char *JOURNAL_FILE = "bench_journal.log"; //Scratch journal
+const char *JOURNAL_CRAFT_FILE = "bench_journal_craft.tmp"; //Scratch craft file
+
+// Name: WriteJournalCraftFile(const string& path)
+// Description: Writes recipes made from gathered products, so a session
+//              can afford some of them.
+// Preconditions: path is writable.
+// Postconditions: path holds JOURNAL_RECIPES records.
+static void WriteJournalCraftFile(const string& path) {
+  ofstream out(path);
+  const vector<string>* kinds[] = {&RawProducts, &NaturalProducts, &FoodProducts, &HuntProducts};
+  for (int i = 0; i < JOURNAL_RECIPES; i++) {
+    const vector<string>& first = *kinds[i % 4];
+    const vector<string>& second = *kinds[(i / 4) % 4];
+    out << "Journal Product " << i << "|" << first[i % first.size()] << "|"
+        << second[(i / 3) % second.size()] << "|None|None|\n";
+  }
+}
+
+// Name: RecordSession(Journal& journal, Hero& hero, const vector<Item*>& items,
+//                     Random& random, int actions, int batch)
+// Description: Plays actions random actions on hero and records them,
+//              writing the journal every batch actions.
+// Preconditions: journal is open; hero uses the items' registry.
+// Postconditions: The journal holds the actions.
+static void RecordSession(Journal& journal, Hero& hero, const vector<Item*>& items,
+                          Random& random, int actions, int batch) {
+  string error;
+  for (int i = 0; i < actions; i++) {
+    uint32_t roll = random.Below(10);
+    if (roll < 2) {
+      journal.RecordMove(static_cast<int>(random.Below(JOURNAL_AREAS)));
+    } else if (roll < 9) {
+      GatherKind kind = static_cast<GatherKind>(random.Below(4));
+      ItemId found = kind == GATHER_RAW ? hero.Raw() : kind == GATHER_NATURAL ? hero.Natural()
+                     : kind == GATHER_FOOD ? hero.Food() : hero.Hunt();
+      journal.RecordGather(kind, found);
+    } else {
+      const Item& item = *items[random.Below(static_cast<uint32_t>(items.size()))];
+      if (hero.Craft(item, 1)) {
+        journal.RecordCraft(item.GetID(), 1);
+      }
+    }
+    if ((i + 1) % batch == 0) {
+      journal.Flush(error);
+    }
+  }
+  journal.Flush(error);
+}
+
+void RunJournalBenchmarks(Bench& bench) {
+  cout << "== Action journal ==" << endl;
+  WriteJournalCraftFile(JOURNAL_CRAFT_FILE);
+  Game game("", JOURNAL_CRAFT_FILE);
+  game.LoadCraft();
+  const ItemRegistry& registry = game.GetRegistry();
+  const vector<Item*>& items = game.GetItems();
+  NullSink quiet;
+  SnapshotStore store(registry);
+  string snapshot;
+  string error;
+  //Each run starts a new journal from the hero as it stands
+  auto record = [&](int actions, int batch) {
+    Hero hero("Bench", registry, 11);
+    hero.SetOutput(&quiet);
+    Random random(5);
+    Journal journal;
+    journal.Open(JOURNAL_FILE, registry, 0, error);
+    store.Encode(hero, 0, journal.GetMark(), snapshot);
+    journal.RecordRestore(snapshot);
+    RecordSession(journal, hero, items, random, actions, batch);
+  };
+  bench.Run("Journal/record, write per action", JOURNAL_FLUSHED_ACTIONS, [&]() {
+    record(JOURNAL_FLUSHED_ACTIONS, 1);
+  });
+  bench.Run("Journal/record, write per " + to_string(JOURNAL_BATCH), JOURNAL_ACTIONS, [&]() {
+    record(JOURNAL_ACTIONS, JOURNAL_BATCH);
+  });
+  JournalReplayer replayer(registry, items, JOURNAL_AREAS);
+  if (!replayer.Open(JOURNAL_FILE, error)) {
+    cout << "  " << error << endl;
+    return;
+  }
+  Hero hero("Replay", registry, 1);
+  hero.SetOutput(&quiet);
+  int area = 0;
+  bench.Run("Journal/replay", JOURNAL_ACTIONS, [&]() {
+    DoNotOptimize(replayer.Replay(replayer.GetStart(), 0, hero, area, error));
+  });
+  cout << "  " << replayer.GetApplied() << " records, " << replayer.GetEnd() << " bytes" << endl;
+  remove(JOURNAL_FILE);
+  remove(JOURNAL_CRAFT_FILE);
+}
@@ -0,0 +1,132 @@
+#include "Bench.h"
+#include "Game.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+using namespace std;
+
+//Loader benchmarks: time and heap allocations per record for
+//Game::LoadMap and Game::LoadCraft on small and large generated files,
+//and the cost of opening the same world as a compiled pack.
+
+// Name: WriteMapFile(const string& path, int areas)
+// Description: Writes a corridor-shaped map in the proj5 map format with
+//              descriptions long enough to need heap storage.
+// Preconditions: path is writable.
+// Postconditions: path holds areas records.
+static void WriteMapFile(const string& path, int areas) {
+  ofstream out(path);
+  string desc(180, 'x');
+  for (int i = 0; i < areas; i++) {
+    int east = i + 1 < areas ? i + 1 : -1;
+    int west = i > 0 ? i - 1 : -1;
+    out << i << "|Generated Area Number " << i << "|" << desc << "|-1|"
+        << east << "|-1|" << west << "|\n";
+  }
+}
+
+// Name: WriteCraftFile(const string& path, int recipes)
+// Description: Writes recipes in the proj5 craft format.
+// Preconditions: path is writable.
+// Postconditions: path holds recipes records.
+static void WriteCraftFile(const string& path, int recipes) {
+  ofstream out(path);
+  for (int i = 0; i < recipes; i++) {
+    out << "Crafted Product " << i << "|Iron Ore|Coal|Generated Ingredient "
+        << i / 2 << "|None|\n";
+  }
+}
+
+void RunLoadBenchmarks(Bench& bench) {
+  cout << "== Loaders ==" << endl;
+  string mapPath = "bench_map.tmp";
+  string craftPath = "bench_craft.tmp";
+  //Small files (the size of the shipped maps): fixed costs dominate
+  const int smallAreas = 100;
+  const int smallRecipes = 50;
+  WriteMapFile(mapPath, smallAreas);
+  WriteCraftFile(craftPath, smallRecipes);
+  bench.Run("LoadMap/stream/" + to_string(smallAreas), smallAreas, [&]() {
+    Game game(mapPath, craftPath);
+    game.LoadMap();
+  }, 20);
+  bench.Run("LoadMap/mapped/" + to_string(smallAreas), smallAreas, [&]() {
+    Game game(mapPath, craftPath);
+    game.LoadMapMapped();
+  }, 20);
+  bench.Run("LoadCraft/stream/" + to_string(smallRecipes), smallRecipes, [&]() {
+    Game game(mapPath, craftPath);
+    game.LoadCraft();
+  }, 20);
+  bench.Run("LoadCraft/mapped/" + to_string(smallRecipes), smallRecipes, [&]() {
+    Game game(mapPath, craftPath);
+    game.LoadCraftMapped();
+  }, 20);
+  const int areas = 100000;
+  const int recipes = 20000;
+  WriteMapFile(mapPath, areas);
+  WriteCraftFile(craftPath, recipes);
+  bench.Run("LoadMap/stream/" + to_string(areas), areas, [&]() {
+    Game game(mapPath, craftPath);
+    game.LoadMap();
+  }, 3);
+  bench.Run("LoadMap/mapped/" + to_string(areas), areas, [&]() {
+    Game game(mapPath, craftPath);
+    game.LoadMapMapped();
+  }, 3);
+  //Scaling of the chunked parser with the worker count
+  for (int threads = 1; threads <= 8; threads *= 2) {
+    bench.Run("LoadMap/parallel/" + to_string(threads) + "t/" + to_string(areas), areas, [&]() {
+      Game game(mapPath, craftPath);
+      game.LoadMapParallel(threads);
+    }, 3);
+  }
+  bench.Run("LoadMapIndex/lazy/" + to_string(areas), areas, [&]() {
+    Game game(mapPath, craftPath);
+    game.SetLoadMode(LOAD_LAZY);
+    game.LoadMapIndex();
+  }, 3);
+  {
+    //Walking the corridor touches every area once through the LRU cache
+    Game game(mapPath, craftPath);
+    game.SetLoadMode(LOAD_LAZY);
+    game.LoadMapIndex();
+    bench.Run("GetArea/lazy first visit/" + to_string(areas), areas, [&]() {
+      for (int i = 0; i < areas; i++) {
+        DoNotOptimize(game.GetArea(i));
+      }
+    }, 1);
+    cout << "  lazy offset index bytes: " << areas * sizeof(long long)
+         << " (text loaded on demand, " << LAZY_CACHE_SIZE << " areas cached)" << endl;
+  }
+  {
+    //Compile once; opening the pack is the whole load
+    string packPath = "bench_world.tmp";
+    string error;
+    ValidationReport report;
+    if (CompilePack(mapPath, craftPath, packPath, report, error)) {
+      bench.Run("LoadPack/open+items/" + to_string(areas), areas, [&]() {
+        Game game(packPath, "");
+        game.SetLoadMode(LOAD_PACK);
+        game.LoadPack();
+      }, 3);
+      WorldPack pack;
+      bench.Run("WorldPack::Open/" + to_string(areas), 1, [&]() {
+        DoNotOptimize(pack.Open(packPath));
+      }, 3);
+    } else {
+      cout << "  pack: " << error << endl;
+    }
+    remove(packPath.c_str());
+  }
+  bench.Run("LoadCraft/stream/" + to_string(recipes), recipes, [&]() {
+    Game game(mapPath, craftPath);
+    game.LoadCraft();
+  }, 3);
+  bench.Run("LoadCraft/mapped/" + to_string(recipes), recipes, [&]() {
+    Game game(mapPath, craftPath);
+    game.LoadCraftMapped();
+  }, 3);
+  remove(mapPath.c_str());
+  remove(craftPath.c_str());
+}
@@ -0,0 +1,225 @@
+#include "Bench.h"
+#include "Map.cpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+using namespace std;
+
+//Map storage benchmarks: insert, hit lookup, update, copy and assign for
+//each storage policy across sizes (10 to 1M keys). Keys look like item
+//names ("Item 1234") and are inserted in a shuffled order so the sorted
+//storages do real work.
+
+// Name: MakeKeys(int count)
+// Description: Builds count distinct item-like keys in a fixed
+//              pseudo-random order (deterministic between runs).
+// Preconditions: count > 0.
+// Postconditions: Returns the shuffled keys.
+static vector<string> MakeKeys(int count) {
+  vector<string> keys;
+  for (int i = 0; i < count; i++) {
+    keys.push_back("Item " + to_string(i));
+  }
+  //Fisher-Yates with a fixed LCG so every run sees the same order
+  unsigned long state = 12345;
+  for (int i = count - 1; i > 0; i--) {
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    int j = static_cast<int>((state >> 33) % (i + 1));
+    swap(keys[i], keys[j]);
+  }
+  return keys;
+}
+
+// Name: BenchStorage(Bench& bench, const string& label, const vector<string>& keys)
+// Description: Times Insert, ValueAt, Update, copy construction and
+//              assignment for one Map<string,int,S> instantiation.
+// Preconditions: keys are distinct.
+// Postconditions: Results are printed.
+template <typename M>
+static void BenchStorage(Bench& bench, const string& label, const vector<string>& keys) {
+  long n = static_cast<long>(keys.size());
+  string suffix = "/" + label + "/" + to_string(n);
+  //Fewer repetitions for the quadratic cases
+  int reps = n >= 10000 ? 1 : 5;
+  bench.Run("Insert" + suffix, n, [&]() {
+    M map;
+    for (long i = 0; i < n; i++) {
+      map.Insert(keys[i], static_cast<int>(i));
+    }
+    DoNotOptimize(map);
+  }, reps);
+  M filled;
+  for (long i = 0; i < n; i++) {
+    filled.Insert(keys[i], static_cast<int>(i));
+  }
+  bench.Run("ValueAt" + suffix, n, [&]() {
+    long sum = 0;
+    for (long i = 0; i < n; i++) {
+      sum += filled.ValueAt(keys[i]);
+    }
+    DoNotOptimize(sum);
+  }, reps);
+  bench.Run("Update" + suffix, n, [&]() {
+    for (long i = 0; i < n; i++) {
+      filled.Update(keys[i], static_cast<int>(i + 1));
+    }
+    DoNotOptimize(filled);
+  }, reps);
+  bench.Run("Copy" + suffix, n, [&]() {
+    M copy(filled);
+    DoNotOptimize(copy);
+  }, reps);
+  M target;
+  target.Insert(keys[0], 0);
+  bench.Run("Assign" + suffix, n, [&]() {
+    target = filled;
+    DoNotOptimize(target);
+  }, reps);
+}
+
+// Name: BenchAllocator(Bench& bench, const string& label, const vector<string>& keys)
+// Description: Times building, assigning and destroying a list-backed
+//              map with allocator A and reports its heap traffic.
+// Preconditions: keys are distinct.
+// Postconditions: Results are printed.
+template <typename A>
+static void BenchAllocator(Bench& bench, const string& label, const vector<string>& keys) {
+  typedef Map<string, int, ListStorage<string, int, A> > ListMap;
+  long n = static_cast<long>(keys.size());
+  string suffix = "/" + label + "/" + to_string(n);
+  //Keys inserted in sorted order so the list walk is cheap and the
+  //allocator dominates
+  vector<string> sorted(keys);
+  sort(sorted.begin(), sorted.end(), greater<string>());
+  ListMap source;
+  for (long i = 0; i < n; i++) {
+    source.Insert(sorted[i], static_cast<int>(i));
+  }
+  bench.Run("Build+Destroy" + suffix, n, [&]() {
+    ListMap map;
+    for (long i = 0; i < n; i++) {
+      map.Insert(sorted[i], static_cast<int>(i));
+    }
+    DoNotOptimize(map);
+  });
+  ListMap target(source);
+  bench.Run("Assign" + suffix, n, [&]() {
+    target = source;
+    DoNotOptimize(target);
+  });
+  const AllocStats& stats = source.GetStorage().GetAllocator().GetStats();
+  cout << "  heap allocations" << suffix << ": " << stats.m_heapAllocs
+       << " for " << stats.m_allocations << " nodes" << endl;
+}
+
+// Name: BenchLookupApi(Bench& bench, const string& label, const vector<string>& keys)
+// Description: Compares the throwing lookup/update pattern Hero used to
+//              rely on (ValueAt + catch, then Update or Insert) with the
+//              single-pass TryGet and Add, on both the hit and miss paths.
+// Preconditions: keys are distinct.
+// Postconditions: Results are printed.
+template <typename M>
+static void BenchLookupApi(Bench& bench, const string& label, const vector<string>& keys) {
+  long n = static_cast<long>(keys.size());
+  string suffix = "/" + label + "/" + to_string(n);
+  //Present keys are the first half, missing keys the second half
+  long half = n / 2;
+  M map;
+  for (long i = 0; i < half; i++) {
+    map.Insert(keys[i], 1);
+  }
+  bench.Run("ValueAt+catch hit" + suffix, half, [&]() {
+    long sum = 0;
+    for (long i = 0; i < half; i++) {
+      try {
+        sum += map.ValueAt(keys[i]);
+      } catch (const out_of_range& e) {
+        sum--;
+      }
+    }
+    DoNotOptimize(sum);
+  });
+  bench.Run("ValueAt+catch miss" + suffix, n - half, [&]() {
+    long sum = 0;
+    for (long i = half; i < n; i++) {
+      try {
+        sum += map.ValueAt(keys[i]);
+      } catch (const out_of_range& e) {
+        sum--;
+      }
+    }
+    DoNotOptimize(sum);
+  });
+  bench.Run("TryGet hit" + suffix, half, [&]() {
+    long sum = 0;
+    for (long i = 0; i < half; i++) {
+      int value = 0;
+      sum += map.TryGet(keys[i], value) ? value : -1;
+    }
+    DoNotOptimize(sum);
+  });
+  bench.Run("TryGet miss" + suffix, n - half, [&]() {
+    long sum = 0;
+    for (long i = half; i < n; i++) {
+      int value = 0;
+      sum += map.TryGet(keys[i], value) ? value : -1;
+    }
+    DoNotOptimize(sum);
+  });
+  //Collecting every key twice: first pass all misses, second all hits
+  bench.Run("Collect via catch (miss+hit)" + suffix, 2 * n, [&]() {
+    M counts;
+    for (int pass = 0; pass < 2; pass++) {
+      for (long i = 0; i < n; i++) {
+        try {
+          int val = counts.ValueAt(keys[i]);
+          counts.Update(keys[i], val + 1);
+        } catch (const out_of_range& e) {
+          counts.Insert(keys[i], 1);
+        }
+      }
+    }
+    DoNotOptimize(counts);
+  });
+  bench.Run("Collect via Add (miss+hit)" + suffix, 2 * n, [&]() {
+    M counts;
+    for (int pass = 0; pass < 2; pass++) {
+      for (long i = 0; i < n; i++) {
+        counts.Add(keys[i], 1);
+      }
+    }
+    DoNotOptimize(counts);
+  });
+}
+
+void RunMapBenchmarks(Bench& bench) {
+  cout << "== Map storage ==" << endl;
+  const int sizes[] = {10, 100, 1000, 10000};
+  for (unsigned long i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    vector<string> keys = MakeKeys(sizes[i]);
+    BenchStorage<Map<string, int> >(bench, "list", keys);
+    BenchStorage<Map<string, int, FlatStorage<string, int> > >(bench, "flat", keys);
+    BenchStorage<Map<string, int, HashStorage<string, int> > >(bench, "hash", keys);
+    BenchStorage<Map<string, int, BTreeStorage<string, int> > >(bench, "btree", keys);
+  }
+  //List and flat inserts are quadratic, so only the tree and hash go big
+  const int bigSizes[] = {100000, 1000000};
+  for (unsigned long i = 0; i < sizeof(bigSizes) / sizeof(bigSizes[0]); i++) {
+    vector<string> keys = MakeKeys(bigSizes[i]);
+    BenchStorage<Map<string, int, HashStorage<string, int> > >(bench, "hash", keys);
+    BenchStorage<Map<string, int, BTreeStorage<string, int> > >(bench, "btree", keys);
+  }
+  cout << "== Map lookup API ==" << endl;
+  vector<string> apiKeys = MakeKeys(200);
+  BenchLookupApi<Map<string, int> >(bench, "list", apiKeys);
+  BenchLookupApi<Map<string, int, HashStorage<string, int> > >(bench, "hash", apiKeys);
+  cout << "== Map node allocator ==" << endl;
+  const int allocSizes[] = {1000, 100000};
+  for (unsigned long i = 0; i < sizeof(allocSizes) / sizeof(allocSizes[0]); i++) {
+    vector<string> keys = MakeKeys(allocSizes[i]);
+    BenchAllocator<HeapAllocator<Node<string, int> > >(bench, "heap", keys);
+    BenchAllocator<PoolAllocator<Node<string, int> > >(bench, "pool", keys);
+  }
+}
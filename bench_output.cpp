@@ -0,0 +1,54 @@
+#include "Bench.h"
+#include "Area.h"
+#include "OutputSink.h"
+#include <fstream>
+#include <string>
+using namespace std;
+
+//Output benchmarks: one menu turn (the nine-line Action menu plus an
+//area description) printed the old way, with endl on an ostream, and
+//through the sinks. The stream is /dev/null, so the endl case measures
+//the per-line flush (one write system call each) rather than a terminal.
+
+const int OUTPUT_TURNS = 20000; //Menu turns per run
+
+//The Action menu, one entry per line
+const char *MENU_LINES[] = {
+  "What would you like to do?", "1. Look", "2. Move", "3. Use Area", "4. Craft Item",
+  "5. Display Inventory", "6. Quit", "7. Travel", "8. Plan Item", "9. Craftable Now"
+};
+
+void RunOutputBenchmarks(Bench& bench) {
+  cout << "== Output ==" << endl;
+  const string name = "A Narrow Pathway";
+  const string desc = "The path continues to the east and west with high walls to the north and south.";
+  Area area(0, name, desc, -1, 1, -1, 2);
+  ofstream devNull("/dev/null");
+  bench.Run("Menu turn/ostream + endl", OUTPUT_TURNS, [&]() {
+    for (int t = 0; t < OUTPUT_TURNS; t++) {
+      for (unsigned long i = 0; i < sizeof(MENU_LINES) / sizeof(MENU_LINES[0]); i++) {
+        devNull << MENU_LINES[i] << endl;
+      }
+      devNull << '\n' << area.GetName() << '\n' << area.GetDesc() << endl;
+      devNull << "Possible Exits: East, West" << endl;
+    }
+  });
+  BufferedSink buffered(devNull);
+  NullSink quiet;
+  CaptureSink capture;
+  OutputSink *sinks[] = {&buffered, &quiet, &capture};
+  const char *sinkNames[] = {"BufferedSink", "NullSink", "CaptureSink"};
+  for (int s = 0; s < 3; s++) {
+    OutputSink& out = *sinks[s];
+    bench.Run(string("Menu turn/") + sinkNames[s], OUTPUT_TURNS, [&]() {
+      for (int t = 0; t < OUTPUT_TURNS; t++) {
+        for (unsigned long i = 0; i < sizeof(MENU_LINES) / sizeof(MENU_LINES[0]); i++) {
+          out << MENU_LINES[i] << '\n';
+        }
+        area.PrintArea(out);
+      }
+      out.Flush();
+      capture.Clear();
+    });
+  }
+}
@@ -0,0 +1,67 @@
+#include "Bench.h"
+#include "Random.h"
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+using namespace std;
+
+//Random engine benchmarks: a bounded draw the way Hero::Gather makes one
+//(five outcomes), with libc rand(), mt19937 and Random, on one thread and
+//on several threads at once (rand() shares one locked state).
+
+const int RANDOM_DRAWS = 1 << 22; //Draws per thread
+const uint32_t RANDOM_BOUND = 5; //Gather outcomes (four items + nothing)
+
+// Name: OnThreads(int threads, F body)
+// Description: Runs body(thread) on threads threads and joins them.
+// Preconditions: threads >= 1.
+// Postconditions: Every call has returned.
+template <typename F>
+static void OnThreads(int threads, F body) {
+  vector<thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back(body, t);
+  }
+  for (unsigned long t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+}
+
+void RunRandomBenchmarks(Bench& bench) {
+  cout << "== Random engines ==" << endl;
+  for (int threads = 1; threads <= 4; threads *= 4) {
+    string suffix = "/" + to_string(threads) + "t";
+    long ops = static_cast<long>(RANDOM_DRAWS) * threads;
+    bench.Run("Gather draw/rand() %" + suffix, ops, [&]() {
+      OnThreads(threads, [](int) {
+        unsigned long sum = 0;
+        for (int i = 0; i < RANDOM_DRAWS; i++) {
+          sum += rand() % RANDOM_BOUND;
+        }
+        DoNotOptimize(sum);
+      });
+    });
+    bench.Run("Gather draw/mt19937 + distribution" + suffix, ops, [&]() {
+      OnThreads(threads, [](int t) {
+        mt19937 engine(t + 1);
+        uniform_int_distribution<uint32_t> pick(0, RANDOM_BOUND - 1);
+        unsigned long sum = 0;
+        for (int i = 0; i < RANDOM_DRAWS; i++) {
+          sum += pick(engine);
+        }
+        DoNotOptimize(sum);
+      });
+    });
+    bench.Run("Gather draw/Random::Below" + suffix, ops, [&]() {
+      OnThreads(threads, [](int t) {
+        Random engine(t + 1);
+        unsigned long sum = 0;
+        for (int i = 0; i < RANDOM_DRAWS; i++) {
+          sum += engine.Below(RANDOM_BOUND);
+        }
+        DoNotOptimize(sum);
+      });
+    });
+  }
+}
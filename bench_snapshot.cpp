@@ -0,0 +1,83 @@
+#include "Bench.h"
+#include "Hero.h"
+#include "ItemRegistry.h"
+#include "OutputSink.h"
+#include "Snapshot.h"
+#include <cstdio>
+#include <string>
+using namespace std;
+
+//Snapshot benchmarks: encoding, decoding, saving and loading a hero
+//snapshot for a small inventory and for one holding tens of thousands
+//of distinct items, plus the checkpoint taken after a command that
+//changed nothing (encode and compare, no write). Files go to the
+//working directory and are removed afterwards.
+
+const int SNAPSHOT_BIG_ITEMS = 50000; //Distinct items held by the big hero
+const int SNAPSHOT_SMALL_ITEMS = 100; //Distinct items held by the small hero
+const int SNAPSHOT_FILE_OPS = 200; //Saves or loads per run
+const char *SNAPSHOT_FILE = "bench_snapshot.sav"; //Scratch file
+
+// Name: RunSnapshotCase(Bench& bench, const string& label, int held)
+// Description: Times one inventory size through every snapshot path.
+// Preconditions: held >= 1.
+// Postconditions: Results are recorded; the scratch file is removed.
+static void RunSnapshotCase(Bench& bench, const string& label, int held) {
+  ItemRegistry registry;
+  for (int i = 0; i < held; i++) {
+    registry.Intern("Item " + to_string(i));
+  }
+  NullSink quiet;
+  Hero hero("Bench", registry, 1);
+  hero.SetOutput(&quiet);
+  //Hold every item: mostly small counts, some large, like a long session
+  Random random(7);
+  vector<int> counts(registry.GetSize());
+  for (unsigned long i = 0; i < counts.size(); i++) {
+    counts[i] = static_cast<int>(random.Below(random.Below(8) == 0 ? 100000 : 20));
+  }
+  hero.RestoreInventory(counts);
+  SnapshotStore store(registry);
+  JournalMark mark = {0, 0};
+  string bytes;
+  store.Encode(hero, 5, mark, bytes);
+  cout << "  " << label << ": " << bytes.size() << " bytes" << endl;
+  int ops = held >= SNAPSHOT_BIG_ITEMS ? 200 : 100000;
+  bench.Run("Snapshot/encode/" + label, ops, [&]() {
+    for (int i = 0; i < ops; i++) {
+      store.Encode(hero, 5, mark, bytes);
+      DoNotOptimize(bytes.size());
+    }
+  });
+  Hero restored("Other", registry, 2);
+  restored.SetOutput(&quiet);
+  int area = 0;
+  string error;
+  bench.Run("Snapshot/decode/" + label, ops, [&]() {
+    for (int i = 0; i < ops; i++) {
+      DoNotOptimize(store.Decode(bytes, 10, restored, area, mark, error));
+    }
+  });
+  bench.Run("Snapshot/save file/" + label, SNAPSHOT_FILE_OPS, [&]() {
+    for (int i = 0; i < SNAPSHOT_FILE_OPS; i++) {
+      DoNotOptimize(store.Save(SNAPSHOT_FILE, hero, 5, mark, error));
+    }
+  });
+  bench.Run("Snapshot/checkpoint, unchanged/" + label, ops, [&]() {
+    for (int i = 0; i < ops; i++) {
+      DoNotOptimize(store.Checkpoint(SNAPSHOT_FILE, hero, 5, mark, error));
+    }
+  });
+  bench.Run("Snapshot/load file/" + label, SNAPSHOT_FILE_OPS, [&]() {
+    for (int i = 0; i < SNAPSHOT_FILE_OPS; i++) {
+      DoNotOptimize(store.Load(SNAPSHOT_FILE, 10, restored, area, mark, error));
+    }
+  });
+  remove(SNAPSHOT_FILE);
+}
+
+void RunSnapshotBenchmarks(Bench& bench) {
+  cout << "== Hero snapshots ==" << endl;
+  RunSnapshotCase(bench, to_string(SNAPSHOT_SMALL_ITEMS) + " items", SNAPSHOT_SMALL_ITEMS);
+  RunSnapshotCase(bench, to_string(SNAPSHOT_BIG_ITEMS) + " items", SNAPSHOT_BIG_ITEMS);
+}
@@ -0,0 +1,207 @@
+#include "Bench.h"
+#include "World.h"
+#include "Router.h"
+#include "ThreadPool.h"
+#include "WorldValidator.h"
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+//World layout benchmarks: whole-graph passes over the old layout (one
+//heap object per area, exits next to the text) against the World
+//structure of arrays (flat exits, exit masks and CSR adjacency), and
+//route queries on a million-area map.
+
+//The pre-World layout: each area its own allocation holding its strings
+struct PointerArea {
+  int m_id;
+  string m_name;
+  string m_desc;
+  int m_direction[4];
+};
+
+// Name: GridExits(int side, int index, int exits[4])
+// Description: Exits of a cell in a side x side grid with every fifth
+//              east-west wall removed, so the graph is not trivial.
+// Preconditions: 0 <= index < side * side.
+// Postconditions: exits holds North, East, South, West.
+static void GridExits(int side, int index, int exits[4]) {
+  int row = index / side;
+  int col = index % side;
+  exits[0] = row > 0 ? index - side : NO_EXIT;
+  exits[1] = col + 1 < side && index % 5 != 4 ? index + 1 : NO_EXIT;
+  exits[2] = row + 1 < side ? index + side : NO_EXIT;
+  exits[3] = col > 0 && (index - 1) % 5 != 4 ? index - 1 : NO_EXIT;
+}
+
+// Name: Bfs(int size, int start, G neighbors)
+// Description: Breadth-first search calling neighbors(area, visit).
+// Preconditions: 0 <= start < size.
+// Postconditions: Returns the number of areas reached.
+template <typename G>
+static int Bfs(int size, int start, G neighbors) {
+  vector<int> queue;
+  queue.reserve(size);
+  vector<char> seen(size, 0);
+  queue.push_back(start);
+  seen[start] = 1;
+  for (unsigned long head = 0; head < queue.size(); head++) {
+    neighbors(queue[head], [&](int next) {
+      if (!seen[next]) {
+        seen[next] = 1;
+        queue.push_back(next);
+      }
+    });
+  }
+  return static_cast<int>(queue.size());
+}
+
+void RunWorldBenchmarks(Bench& bench) {
+  cout << "== World traversal ==" << endl;
+  const int side = 512;
+  const int size = side * side;
+  const string desc(180, 'x');
+  vector<PointerArea*> pointerAreas;
+  World world;
+  world.Reserve(size);
+  for (int i = 0; i < size; i++) {
+    int exits[4];
+    GridExits(side, i, exits);
+    PointerArea *area = new PointerArea;
+    area->m_id = i;
+    area->m_name = "Generated Area Number " + to_string(i);
+    area->m_desc = desc;
+    for (int d = 0; d < 4; d++) {
+      area->m_direction[d] = exits[d];
+    }
+    pointerAreas.push_back(area);
+    world.AddArea(i, area->m_name, area->m_desc, exits);
+  }
+  world.BuildAdjacency();
+  string n = to_string(size);
+  bench.Run("BFS/Area* vector/" + n, size, [&]() {
+    DoNotOptimize(Bfs(size, 0, [&](int at, auto visit) {
+      for (int d = 0; d < 4; d++) {
+        if (pointerAreas[at]->m_direction[d] != NO_EXIT) {
+          visit(pointerAreas[at]->m_direction[d]);
+        }
+      }
+    }));
+  });
+  bench.Run("BFS/World exits/" + n, size, [&]() {
+    DoNotOptimize(Bfs(size, 0, [&](int at, auto visit) {
+      const int32_t *exits = world.GetExits(at);
+      for (int d = 0; d < EXIT_COUNT; d++) {
+        if (exits[d] != NO_EXIT) {
+          visit(exits[d]);
+        }
+      }
+    }));
+  });
+  bench.Run("BFS/World exit mask/" + n, size, [&]() {
+    DoNotOptimize(Bfs(size, 0, [&](int at, auto visit) {
+      const int32_t *exits = world.GetExits(at);
+      for (unsigned mask = world.GetExitMask(at); mask != 0; mask &= mask - 1) {
+        visit(exits[__builtin_ctz(mask)]);
+      }
+    }));
+  });
+  bench.Run("BFS/World CSR/" + n, size, [&]() {
+    DoNotOptimize(Bfs(size, 0, [&](int at, auto visit) {
+      int count = 0;
+      const int32_t *next = world.GetNeighbors(at, count);
+      for (int i = 0; i < count; i++) {
+        visit(next[i]);
+      }
+    }));
+  });
+  //A linear pass: count dead ends (exactly one exit)
+  bench.Run("DeadEnds/Area* vector/" + n, size, [&]() {
+    int deadEnds = 0;
+    for (int i = 0; i < size; i++) {
+      int exits = 0;
+      for (int d = 0; d < 4; d++) {
+        exits += pointerAreas[i]->m_direction[d] != NO_EXIT;
+      }
+      deadEnds += exits == 1;
+    }
+    DoNotOptimize(deadEnds);
+  });
+  bench.Run("DeadEnds/World exit mask/" + n, size, [&]() {
+    int deadEnds = 0;
+    for (int i = 0; i < size; i++) {
+      deadEnds += __builtin_popcount(world.GetExitMask(i)) == 1;
+    }
+    DoNotOptimize(deadEnds);
+  });
+  for (unsigned long i = 0; i < pointerAreas.size(); i++) {
+    delete pointerAreas[i];
+  }
+  //Validation scaling with the worker count
+  for (int threads = 1; threads <= 8; threads *= 2) {
+    ThreadPool pool(threads);
+    bench.Run("Validate/" + to_string(threads) + "t/" + n, size, [&]() {
+      ValidationReport report = ValidateWorld(world, 0, pool);
+      DoNotOptimize(report.m_componentCount);
+    }, 3);
+  }
+  //Routing: one million areas, random pairs
+  const int routeSide = 1024;
+  const int routeSize = routeSide * routeSide;
+  World big;
+  big.Reserve(routeSize);
+  for (int i = 0; i < routeSize; i++) {
+    int exits[4];
+    GridExits(routeSide, i, exits);
+    big.AddAreaView(i, string_view(), string_view(), exits);
+  }
+  big.BuildAdjacency();
+  string m = to_string(routeSize);
+  Router *alt = nullptr;
+  bench.Run("Router build (8 landmarks)/" + m, 1, [&]() {
+    delete alt;
+    alt = new Router(big);
+  }, 1);
+  Router bfs(big, 0);
+  mt19937 rng(42);
+  const int queries = 200;
+  vector<pair<int, int>> pairs;
+  for (int i = 0; i < queries; i++) {
+    pairs.push_back(make_pair(static_cast<int>(rng() % routeSize), static_cast<int>(rng() % routeSize)));
+  }
+  bench.Run("Route/BFS/" + m, queries, [&]() {
+    for (int i = 0; i < queries; i++) {
+      DoNotOptimize(bfs.GetDistance(pairs[i].first, pairs[i].second));
+    }
+  }, 1);
+  long expanded = 0;
+  bench.Run("Route/ALT A*/" + m, queries, [&]() {
+    expanded = 0;
+    for (int i = 0; i < queries; i++) {
+      DoNotOptimize(alt->GetDistance(pairs[i].first, pairs[i].second));
+      expanded += alt->GetLastExpanded();
+    }
+  }, 1);
+  cout << "  ALT areas expanded per query: " << expanded / queries << endl;
+  bench.Run("Route/lower bound/" + m, queries, [&]() {
+    for (int i = 0; i < queries; i++) {
+      DoNotOptimize(alt->GetLowerBound(pairs[i].first, pairs[i].second));
+    }
+  });
+  //Many heroes heading for one place: one table, then O(route) each
+  alt->PrepareTarget(pairs[0].second);
+  vector<int> path;
+  bench.Run("Route/prepared target path/" + m, queries, [&]() {
+    for (int i = 0; i < queries; i++) {
+      alt->FindPath(pairs[i].first, pairs[0].second, path);
+      DoNotOptimize(path);
+    }
+  });
+  bench.Run("Route/prepared target distance/" + m, queries, [&]() {
+    for (int i = 0; i < queries; i++) {
+      DoNotOptimize(alt->GetDistance(pairs[i].first, pairs[0].second));
+    }
+  });
+  delete alt;
+}
@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "CommandLine.h"
+using namespace std;
+
+//Load generator for cavern_server: opens a number of sessions at once,
+//and each plays a fixed command mix like a player: send a command, wait
+//for the prompt that ends its reply, think, send the next (--think 0
+//is a closed loop that finds the peak rate). Every reply's latency is
+//kept, and each step reports throughput and latency percentiles. With
+//several session counts it also reports the largest count whose p99
+//stayed under the limit.
+
+const char *LOADGEN_COMMANDS[] = {
+  "gather raw", "e", "gather natural", "look", "gather food", "w", "inventory",
+  "gather hunt", "craftable", "craft Fire"
+}; //Cycled by every session, each from its own starting point
+const int LOADGEN_COMMAND_COUNT = sizeof(LOADGEN_COMMANDS) / sizeof(LOADGEN_COMMANDS[0]);
+const int LOADGEN_MAX_EVENTS = 512; //Events taken from epoll per wait
+const int LOADGEN_CONNECT_SECONDS = 10; //Longest wait for every welcome
+const char LOADGEN_PROMPT[] = "> "; //Ends every server reply (SERVER_PROMPT)
+
+//Where the server listens
+struct LoadTarget {
+  int m_port; //TCP port on 127.0.0.1 (-1 = use m_unixPath)
+  string m_unixPath; //Unix socket path
+};
+
+//One client session
+struct LoadSession {
+  int m_fd; //Non-blocking socket (-1 = failed)
+  bool m_ready; //The last reply is complete
+  char m_tail[2]; //Last two bytes received, to spot the prompt
+  int m_next; //Next command in LOADGEN_COMMANDS
+  chrono::steady_clock::time_point m_sent; //When the pending command went out
+  chrono::steady_clock::time_point m_due; //When the next command goes out
+};
+
+//Results of one step
+struct LoadStep {
+  int m_sessions; //Sessions asked for
+  int m_connected; //Sessions that got the welcome
+  long long m_replies; //Replies timed
+  double m_seconds; //Length of the timed window
+  vector<long long> m_latencies; //Reply latencies (ns)
+};
+
+// Name: Connect(const LoadTarget& target)
+// Description: Starts a non-blocking connection to the server.
+// Preconditions: None.
+// Postconditions: Returns the socket, or -1 on failure.
+static int Connect(const LoadTarget& target) {
+  int fd = -1;
+  int result = -1;
+  if (target.m_port >= 0) {
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+      return -1;
+    }
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(target.m_port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    result = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  } else {
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+      return -1;
+    }
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, target.m_unixPath.c_str(), sizeof(address.sun_path) - 1);
+    result = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  }
+  if (result != 0 && errno != EINPROGRESS && errno != EAGAIN) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Name: Receive(LoadSession& session)
+// Description: Reads what the socket holds and notes whether it ended
+//              with the prompt.
+// Preconditions: session.m_fd is open.
+// Postconditions: Returns false if the connection failed or closed.
+static bool Receive(LoadSession& session) {
+  char buffer[1 << 14];
+  while (true) {
+    ssize_t got = read(session.m_fd, buffer, sizeof(buffer));
+    if (got < 0 && (errno == EAGAIN || errno == EINTR)) {
+      return true;
+    } else if (got <= 0) {
+      return false;
+    }
+    //Keep the last two bytes seen, across reads
+    for (ssize_t i = max<ssize_t>(0, got - 2); i < got; i++) {
+      session.m_tail[0] = session.m_tail[1];
+      session.m_tail[1] = buffer[i];
+    }
+    session.m_ready = session.m_tail[0] == LOADGEN_PROMPT[0] && session.m_tail[1] == LOADGEN_PROMPT[1];
+  }
+}
+
+// Name: SendNext(LoadSession& session)
+// Description: Sends the session's next command and starts its clock.
+// Preconditions: session.m_ready.
+// Postconditions: Returns false if the command could not be sent whole.
+static bool SendNext(LoadSession& session) {
+  string line = string(LOADGEN_COMMANDS[session.m_next]) + "\n";
+  session.m_next = (session.m_next + 1) % LOADGEN_COMMAND_COUNT;
+  session.m_ready = false;
+  session.m_tail[0] = session.m_tail[1] = 0;
+  session.m_sent = chrono::steady_clock::now();
+  return send(session.m_fd, line.data(), line.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(line.size());
+}
+
+// Name: Percentile(const vector<long long>& sorted, double fraction)
+// Description: Value below which fraction of the samples fall.
+// Preconditions: sorted is ascending.
+// Postconditions: Returns the sample (0 if there are none).
+static long long Percentile(const vector<long long>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  unsigned long index = static_cast<unsigned long>(fraction * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+// Name: RunStep(const LoadTarget& target, int sessions, double seconds, double thinkMs)
+// Description: Connects sessions clients, waits for every welcome, then
+//              plays the command mix for seconds, pausing thinkMs after
+//              each reply, and closes them all.
+// Preconditions: The server is listening at target.
+// Postconditions: Returns the step's counts and sorted latencies (no
+//                 replies when no session connected).
+static LoadStep RunStep(const LoadTarget& target, int sessions, double seconds, double thinkMs) {
+  LoadStep step;
+  step.m_sessions = sessions;
+  step.m_connected = 0;
+  step.m_replies = 0;
+  step.m_seconds = 0;
+  int epoll = epoll_create1(EPOLL_CLOEXEC);
+  vector<LoadSession> clients(sessions);
+  for (int i = 0; i < sessions; i++) {
+    LoadSession& client = clients[i];
+    client.m_fd = Connect(target);
+    client.m_ready = false;
+    client.m_tail[0] = client.m_tail[1] = 0;
+    client.m_next = i % LOADGEN_COMMAND_COUNT;
+    if (client.m_fd >= 0) {
+      epoll_event event;
+      event.events = EPOLLIN;
+      event.data.u32 = static_cast<uint32_t>(i);
+      epoll_ctl(epoll, EPOLL_CTL_ADD, client.m_fd, &event);
+    }
+  }
+  epoll_event events[LOADGEN_MAX_EVENTS];
+  typedef chrono::steady_clock Clock;
+  //Phase 1: wait for every welcome (nothing is timed yet)
+  int waiting = 0;
+  for (int i = 0; i < sessions; i++) {
+    waiting += clients[i].m_fd >= 0 ? 1 : 0;
+  }
+  Clock::time_point deadline = Clock::now() + chrono::seconds(LOADGEN_CONNECT_SECONDS);
+  while (waiting > 0 && Clock::now() < deadline) {
+    int ready = epoll_wait(epoll, events, LOADGEN_MAX_EVENTS, 10);
+    for (int e = 0; e < ready; e++) {
+      LoadSession& client = clients[events[e].data.u32];
+      if (client.m_fd < 0 || client.m_ready) {
+        continue;
+      }
+      if (!Receive(client)) {
+        close(client.m_fd);
+        client.m_fd = -1;
+        waiting--;
+      } else if (client.m_ready) {
+        waiting--;
+      }
+    }
+  }
+  for (int i = 0; i < sessions; i++) {
+    if (clients[i].m_fd >= 0 && !clients[i].m_ready) {
+      close(clients[i].m_fd);
+      clients[i].m_fd = -1;
+    }
+    step.m_connected += clients[i].m_fd >= 0 ? 1 : 0;
+  }
+  if (step.m_connected == 0) {
+    close(epoll);
+    return step;
+  }
+  //Phase 2: each session sends, waits for the reply, thinks, sends again.
+  //Think time is the same for all, so sessions come due in the order
+  //they were queued and a FIFO is enough. First sends are spread over
+  //one think time so they do not all arrive at once.
+  Clock::time_point start = Clock::now();
+  Clock::time_point end = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds));
+  Clock::duration think = chrono::duration_cast<Clock::duration>(chrono::duration<double>(thinkMs / 1000));
+  deque<int> due;
+  for (int i = 0; i < sessions; i++) {
+    if (clients[i].m_fd >= 0) {
+      clients[i].m_due = start + think * i / sessions;
+      due.push_back(i);
+    }
+  }
+  Clock::time_point now = start;
+  while (now < end) {
+    while (!due.empty() && clients[due.front()].m_due <= now) {
+      LoadSession& client = clients[due.front()];
+      due.pop_front();
+      if (client.m_fd >= 0 && !SendNext(client)) {
+        close(client.m_fd);
+        client.m_fd = -1;
+      }
+    }
+    int ready = epoll_wait(epoll, events, LOADGEN_MAX_EVENTS, 1);
+    now = Clock::now();
+    for (int e = 0; e < ready; e++) {
+      int index = static_cast<int>(events[e].data.u32);
+      LoadSession& client = clients[index];
+      if (client.m_fd < 0) {
+        continue;
+      }
+      if (!Receive(client)) {
+        close(client.m_fd);
+        client.m_fd = -1;
+        continue;
+      }
+      if (client.m_ready) {
+        step.m_latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(now - client.m_sent).count());
+        client.m_due = now + think;
+        due.push_back(index);
+      }
+    }
+  }
+  step.m_seconds = chrono::duration<double>(now - start).count();
+  step.m_replies = static_cast<long long>(step.m_latencies.size());
+  for (int i = 0; i < sessions; i++) {
+    if (clients[i].m_fd >= 0) {
+      close(clients[i].m_fd);
+    }
+  }
+  close(epoll);
+  sort(step.m_latencies.begin(), step.m_latencies.end());
+  return step;
+}
+
+// Name: PrintUsage()
+// Description: Prints the command line options.
+// Preconditions: None.
+// Postconditions: Two lines are written to cout.
+static void PrintUsage() {
+  cout << "Usage: ./cavern_loadgen [--port N | --unix PATH] [--sessions 100,1000,5000,10000]" << endl;
+  cout << "                        [--seconds S] [--think MS] [--p99 MS]" << endl;
+}
+
+// Name: ParseSessions(const string& list, vector<int>& steps)
+// Description: Parses a comma separated list of session counts.
+// Preconditions: None.
+// Postconditions: Returns false unless every entry is a number of at
+//                 least 1; steps holds the counts in order.
+static bool ParseSessions(const string& list, vector<int>& steps) {
+  steps.clear();
+  stringstream entries(list);
+  string count;
+  while (getline(entries, count, ',')) {
+    int sessions = 0;
+    if (!ParseNumber(count.c_str(), sessions) || sessions < 1) {
+      return false;
+    }
+    steps.push_back(sessions);
+  }
+  return !steps.empty();
+}
+
+int main(int argc, char *argv[]) {
+  LoadTarget target;
+  target.m_port = 4000;
+  vector<int> steps = {100, 1000, 5000, 10000};
+  double seconds = 5;
+  double thinkMs = 1000;
+  double limitMs = 10;
+  //Every flag takes a value
+  for (int i = 1; i < argc; i++) {
+    string flag = argv[i];
+    if (i + 1 >= argc) {
+      PrintUsage();
+      return 1;
+    } else if (flag == "--unix") {
+      target.m_unixPath = argv[++i];
+      target.m_port = -1;
+    } else if (flag == "--port" || flag == "--sessions" || flag == "--seconds"
+               || flag == "--think" || flag == "--p99") {
+      const char *value = argv[++i];
+      bool parsed = flag == "--port" ? ParseNumber(value, target.m_port)
+                                       && target.m_port >= 1 && target.m_port <= 65535
+          : flag == "--sessions" ? ParseSessions(value, steps)
+          : flag == "--seconds" ? ParseNumber(value, seconds) && seconds > 0
+          : flag == "--think" ? ParseNumber(value, thinkMs)
+          : ParseNumber(value, limitMs);
+      if (!parsed) {
+        cout << "Bad value for " << flag << ": " << value << endl;
+        PrintUsage();
+        return 1;
+      }
+    } else {
+      cout << "Unknown option: " << flag << endl;
+      return 1;
+    }
+  }
+  //The client needs a socket per session too
+  rlimit files;
+  if (getrlimit(RLIMIT_NOFILE, &files) == 0) {
+    files.rlim_cur = files.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &files);
+  }
+  cout << setw(9) << "sessions" << setw(11) << "connected" << setw(12) << "replies/s"
+       << setw(10) << "p50 us" << setw(10) << "p99 us" << setw(10) << "max us" << endl;
+  int supported = 0;
+  for (unsigned long s = 0; s < steps.size(); s++) {
+    LoadStep step = RunStep(target, steps[s], seconds, thinkMs);
+    //An empty step means there is no server, not a measurement
+    if (step.m_connected == 0) {
+      cout << "Error: no session could connect to "
+           << (target.m_port >= 0 ? "127.0.0.1:" + to_string(target.m_port) : target.m_unixPath)
+           << " (is cavern_server running?)" << endl;
+      return 1;
+    }
+    double p99 = Percentile(step.m_latencies, 0.99) / 1000.0;
+    cout << setw(9) << step.m_sessions << setw(11) << step.m_connected
+         << setw(12) << static_cast<long long>(step.m_replies / max(step.m_seconds, 1e-9))
+         << setw(10) << Percentile(step.m_latencies, 0.50) / 1000
+         << setw(10) << static_cast<long long>(p99)
+         << setw(10) << (step.m_latencies.empty() ? 0 : step.m_latencies.back() / 1000) << endl;
+    if (step.m_connected == step.m_sessions && step.m_replies > 0 && p99 <= limitMs * 1000) {
+      supported = max(supported, step.m_sessions);
+    }
+  }
+  cout << "Sessions supported with p99 under " << limitMs << " ms: " << supported << endl;
+  return 0;
+}
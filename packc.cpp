@@ -0,0 +1,28 @@
+#include "WorldPack.h"
+#include "WorldValidator.h"
+#include <iostream>
+#include <string>
+using namespace std;
+
+//World pack compiler: turns a map file and a craft file into a binary
+//pack that the game can open with --pack. The map is validated here; a
+//map that is not playable is reported and not packed.
+int main(int argc, char *argv[]) {
+  if (argc != 4) {
+    cout << "Usage: ./packc proj5_map2.txt proj5_craft.txt world.pack" << endl;
+    return 1;
+  }
+  string error;
+  ValidationReport report;
+  report.m_areaCount = 0;
+  if (!CompilePack(argv[1], argv[2], argv[3], report, error)) {
+    if (report.m_areaCount > 0 && !report.IsValid()) {
+      PrintReport(GetConsole(), report);
+      GetConsole().Flush();
+    }
+    cout << "packc: " << error << endl;
+    return 1;
+  }
+  cout << "Wrote " << argv[3] << endl;
+  return 0;
+}
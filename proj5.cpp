@@ -1,22 +1,120 @@
+#include "CommandLine.h"
 #include "Game.h"
 #include <iostream>
-#include <cstdlib>
 #include <string>
 #include <ctime>
 using namespace std;
 
+// Name: PrintUsage()
+// Description: Prints the command line options.
+// Preconditions: None.
+// Postconditions: Four lines are written to cout.
+static void PrintUsage() {
+  cout << "Usage: ./proj5 proj5_map1.txt proj5_craft.txt [--mmap | --lazy [--cache N] | --threads N] [--validate] [--seed N] [--script FILE|-] [--save FILE]" << endl;
+  cout << "                [--journal FILE [--replay N]]" << endl;
+  cout << "   or: ./proj5 --pack world.pack [--seed N] [--script FILE|-] [--save FILE]" << endl;
+  cout << "                [--journal FILE [--replay N]]" << endl;
+}
+
 int main(int argc, char *argv[]) {
-  if( argc != 3) {
+  if( argc < 3) {
     cout << "This requires a map file and a craft file to be loaded." << endl;
-    cout << "Usage: ./proj5 proj5_map1.txt proj5_craft.txt" << endl;
+    PrintUsage();
+    return 1;
   }
+  //A compiled world pack replaces both text files
+  bool usePack = string(argv[1]) == "--pack";
 
-  cout << "Loading file: " << argv[1] << endl << endl;
+  cout << "Loading file: " << (usePack ? argv[2] : argv[1]) << endl << endl;
 
-  string mapName = argv[1];
-  string craftName = argv[2];
-  srand (time(NULL));
+  string mapName = usePack ? argv[2] : argv[1];
+  string craftName = usePack ? "" : argv[2];
   Game g(mapName, craftName);
+  //A fresh session each run unless --seed asks for a replay
+  g.SetSeed(static_cast<uint64_t>(time(NULL)));
+  if (usePack) {
+    g.SetLoadMode(LOAD_PACK);
+  }
+  bool hasJournal = false;
+  bool replayOnly = false;
+  bool lazy = false; //The last load mode flag was --lazy
+  bool hasCache = false;
+  //Optional flags after the two files
+  for (int i = 3; i < argc; i++) {
+    string flag = argv[i];
+    //Pack areas are views into the mapping, so --cache has nothing to size,
+    //and packc validated the map when it built the pack
+    if (usePack && flag != "--seed" && flag != "--script"
+        && flag != "--save" && flag != "--journal" && flag != "--replay") {
+      cout << "Only --seed, --script, --save, --journal and --replay can be combined with --pack" << endl;
+      return 1;
+    } else if (flag == "--mmap") {
+      g.SetLoadMode(LOAD_MAPPED);
+      lazy = false;
+    } else if (flag == "--lazy") {
+      g.SetLoadMode(LOAD_LAZY);
+      lazy = true;
+    } else if (flag == "--threads" && i + 1 < argc) {
+      g.SetLoadMode(LOAD_PARALLEL);
+      lazy = false;
+      //0 uses every hardware thread; negative counts do not parse
+      int threads = 0;
+      if (!ParseNumber(argv[++i], threads)) {
+        cout << "Bad number for --threads: " << argv[i] << endl;
+        PrintUsage();
+        return 1;
+      }
+      g.SetThreadCount(threads);
+    } else if (flag == "--validate") {
+      g.SetReportOnly(true);
+    } else if (flag == "--seed" && i + 1 < argc) {
+      uint64_t seed = 0;
+      if (!ParseNumber(argv[++i], seed)) {
+        cout << "Bad number for --seed: " << argv[i] << endl;
+        PrintUsage();
+        return 1;
+      }
+      g.SetSeed(seed);
+    } else if (flag == "--script" && i + 1 < argc) {
+      g.SetScript(argv[++i]);
+    } else if (flag == "--save" && i + 1 < argc) {
+      g.SetSaveFile(argv[++i]);
+    } else if (flag == "--journal" && i + 1 < argc) {
+      g.SetJournalFile(argv[++i]);
+      hasJournal = true;
+    } else if (flag == "--replay" && i + 1 < argc) {
+      //0 replays the whole journal; negative counts do not parse
+      long long limit = 0;
+      if (!ParseNumber(argv[++i], limit)) {
+        cout << "Bad number for --replay: " << argv[i] << endl;
+        PrintUsage();
+        return 1;
+      }
+      g.SetReplayOnly(limit);
+      replayOnly = true;
+    } else if (flag == "--cache" && i + 1 < argc) {
+      int size = 0;
+      if (!ParseNumber(argv[++i], size) || size < 1) {
+        cout << "Bad number for --cache: " << argv[i] << " (at least 1 area)" << endl;
+        PrintUsage();
+        return 1;
+      }
+      g.SetLazyCacheSize(size);
+      hasCache = true;
+    } else {
+      cout << "Unknown option: " << flag << endl;
+      return 1;
+    }
+  }
+  if (replayOnly && !hasJournal) {
+    cout << "--replay needs --journal FILE" << endl;
+    return 1;
+  }
+  //Only the lazy loader keeps an area cache to size
+  if (hasCache && !lazy) {
+    cout << "--cache needs --lazy" << endl;
+    return 1;
+  }
   g.StartGame();
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "CommandLine.h"
+#include "Game.h"
+#include "Server.h"
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+using namespace std;
+
+//Game server: loads a map and craft file once, then serves a session per
+//connection on 127.0.0.1 (--port) and/or a Unix socket (--unix) until
+//interrupted, on --workers threads. Sessions take script commands, or
+//play the console's menus with --menus. Try it with: nc 127.0.0.1 4000
+GameServer *g_server = nullptr; //For the signal handler
+
+// Name: StopServer(int signal)
+// Description: SIGINT/SIGTERM handler; lets Run return.
+// Preconditions: None.
+// Postconditions: The server is asked to stop.
+static void StopServer(int) {
+  if (g_server != nullptr) {
+    g_server->Stop();
+  }
+}
+
+// Name: PrintUsage()
+// Description: Prints the command line options.
+// Preconditions: None.
+// Postconditions: One line is written to cout.
+static void PrintUsage() {
+  cout << "Usage: ./cavern_server proj5_map2.txt proj5_craft.txt [--port N] [--unix PATH] [--seed N]"
+       << " [--workers N] [--menus]" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    PrintUsage();
+    return 1;
+  }
+  int port = -1;
+  string unixPath;
+  uint64_t seed = 1;
+  int workers = 0;
+  SessionMode mode = SESSION_COMMANDS;
+  //Optional flags after the two files
+  for (int i = 3; i < argc; i++) {
+    string flag = argv[i];
+    if (flag == "--menus") {
+      mode = SESSION_MENUS;
+    } else if (i + 1 >= argc) {
+      cout << "Missing value for " << flag << endl;
+      return 1;
+    } else if (flag == "--port" || flag == "--seed" || flag == "--workers") {
+      //0 is a free port or one worker per hardware thread
+      const char *value = argv[++i];
+      bool parsed = flag == "--port" ? ParseNumber(value, port) && port <= MAX_TCP_PORT
+          : flag == "--seed" ? ParseNumber(value, seed)
+          : ParseNumber(value, workers);
+      if (!parsed) {
+        cout << "Bad number for " << flag << ": " << value
+             << (flag == "--port" ? " (0 - " + to_string(MAX_TCP_PORT) + ")" : "") << endl;
+        PrintUsage();
+        return 1;
+      }
+    } else if (flag == "--unix") {
+      unixPath = argv[++i];
+    } else {
+      cout << "Unknown option: " << flag << endl;
+      return 1;
+    }
+  }
+  if (port < 0 && unixPath.empty()) {
+    port = 4000;
+  }
+  //Each session is a socket, so allow as many as the hard limit does
+  rlimit files;
+  if (getrlimit(RLIMIT_NOFILE, &files) == 0) {
+    files.rlim_cur = files.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &files);
+  }
+  //Load once; every session shares the world and recipes (each worker
+  //makes its own router and planner over them)
+  Game game(argv[1], argv[2]);
+  game.LoadMapMapped();
+  game.LoadCraftMapped();
+  if (!game.CheckWorld()) {
+    cout << "This map cannot be served." << endl;
+    return 1;
+  }
+  game.BuildRouter();
+  game.BuildPlanner();
+  GameServer server(game, seed, mode);
+  string error;
+  if (port >= 0 && !server.ListenTcp(port, error)) {
+    cout << "cavern_server: " << error << endl;
+    return 1;
+  }
+  if (!unixPath.empty() && !server.ListenUnix(unixPath, error)) {
+    cout << "cavern_server: " << error << endl;
+    return 1;
+  }
+  if (server.GetTcpPort() >= 0) {
+    cout << "Listening on 127.0.0.1:" << server.GetTcpPort() << endl;
+  }
+  if (!unixPath.empty()) {
+    cout << "Listening on " << unixPath << endl;
+  }
+  g_server = &server;
+  signal(SIGINT, StopServer);
+  signal(SIGTERM, StopServer);
+  server.Run(workers);
+  ServerStats stats = server.GetStats();
+  cout << "Served " << stats.m_accepted << " sessions (at most " << stats.m_peak << " at once), "
+       << stats.m_commands << " commands." << endl;
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include "CommandLine.h"
+#include "Game.h"
+#include "Simulation.h"
+#include <iostream>
+#include <string>
+using namespace std;
+
+// Name: PrintUsage()
+// Description: Prints the command line options.
+// Preconditions: None.
+// Postconditions: Two lines are written to cout.
+static void PrintUsage() {
+  cout << "Usage: ./cavern_sim proj5_map2.txt proj5_craft.txt [--agents N] [--steps N] [--threads N]" << endl;
+  cout << "       [--policy random|greedy] [--script raw,natural,craft,move] [--seed N]" << endl;
+}
+
+//Headless balance simulator: loads a map and craft file, then plays many
+//silent agents in parallel and prints aggregated statistics.
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    PrintUsage();
+    return 1;
+  }
+  SimConfig config;
+  config.m_agents = 10000;
+  config.m_steps = 500;
+  config.m_policy = POLICY_RANDOM;
+  config.m_seed = 1;
+  int threads = 0;
+  //Optional flags after the two files
+  for (int i = 3; i < argc; i++) {
+    string flag = argv[i];
+    if (i + 1 >= argc) {
+      cout << "Missing value for " << flag << endl;
+      return 1;
+    } else if (flag == "--agents" || flag == "--steps" || flag == "--threads" || flag == "--seed") {
+      const char *value = argv[++i];
+      bool parsed = flag == "--agents" ? ParseNumber(value, config.m_agents)
+          : flag == "--steps" ? ParseNumber(value, config.m_steps)
+          : flag == "--threads" ? ParseNumber(value, threads)
+          : ParseNumber(value, config.m_seed);
+      if (!parsed) {
+        cout << "Bad number for " << flag << ": " << value << endl;
+        PrintUsage();
+        return 1;
+      }
+    } else if (flag == "--policy") {
+      string policy = argv[++i];
+      if (policy == "random") {
+        config.m_policy = POLICY_RANDOM;
+      } else if (policy == "greedy") {
+        config.m_policy = POLICY_GREEDY;
+      } else {
+        cout << "Unknown policy: " << policy << endl;
+        return 1;
+      }
+    } else if (flag == "--script") {
+      if (!ParseSimScript(argv[++i], config.m_script)) {
+        cout << "Bad script: " << argv[i] << " (actions: move, raw, natural, food, hunt, craft)" << endl;
+        return 1;
+      }
+      config.m_policy = POLICY_SCRIPT;
+    } else {
+      cout << "Unknown option: " << flag << endl;
+      return 1;
+    }
+  }
+  if (config.m_agents < 1 || config.m_steps < 1) {
+    cout << "--agents and --steps must be at least 1" << endl;
+    return 1;
+  }
+  //Load once; every agent shares the world and recipes read-only
+  Game game(argv[1], argv[2]);
+  game.SetThreadCount(threads);
+  game.LoadMapMapped();
+  game.LoadCraftMapped();
+  if (!game.CheckWorld()) {
+    cout << "This map cannot be simulated." << endl;
+    return 1;
+  }
+  ThreadPool pool(threads);
+  SimStats stats = RunSimulation(game.GetWorld(), game.GetItems(), game.GetRegistry(), config, pool);
+  cout << "Threads: " << pool.GetThreadCount() << endl;
+  PrintSimStats(cout, stats, game.GetRegistry(), config);
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "CommandLine.h"
+#include "WorldGen.h"
+#include <iostream>
+#include <string>
+using namespace std;
+
+//Synthetic input generator: writes a map file or a craft file of any size
+//from a seed, for benchmarks, the simulator and capacity tests.
+int main(int argc, char *argv[]) {
+  string kind = argc >= 3 ? argv[1] : "";
+  if (kind != "map" && kind != "craft") {
+    cout << "Usage: ./worldgen map big_map.txt [--areas N] [--shape corridor|grid|maze] [--loops P]" << endl;
+    cout << "                  [--desc MIN-MAX] [--seed N]" << endl;
+    cout << "       ./worldgen craft big_craft.txt [--items N] [--layers N] [--ingredients N] [--seed N]" << endl;
+    return 1;
+  }
+  MapGenConfig map;
+  map.m_areas = 10000;
+  map.m_shape = SHAPE_MAZE;
+  map.m_loops = 10;
+  map.m_minDesc = 80;
+  map.m_maxDesc = 240;
+  map.m_seed = 1;
+  CraftGenConfig craft;
+  craft.m_items = 2000;
+  craft.m_layers = 20;
+  craft.m_maxIngredients = 3;
+  craft.m_seed = 1;
+  //Optional flags after the file name
+  for (int i = 3; i < argc; i++) {
+    string flag = argv[i];
+    if (i + 1 >= argc) {
+      cout << "Missing value for " << flag << endl;
+      return 1;
+    }
+    string value = argv[++i];
+    //Counts are checked against their limits by GenerateMap/GenerateCraft
+    bool parsed = true;
+    if (flag == "--seed") {
+      parsed = ParseNumber(value.c_str(), map.m_seed);
+      craft.m_seed = map.m_seed;
+    } else if (kind == "map" && flag == "--areas") {
+      parsed = ParseNumber(value.c_str(), map.m_areas);
+    } else if (kind == "map" && flag == "--shape") {
+      if (!ParseMapShape(value, map.m_shape)) {
+        cout << "Unknown shape: " << value << endl;
+        return 1;
+      }
+    } else if (kind == "map" && flag == "--loops") {
+      parsed = ParseNumber(value.c_str(), map.m_loops);
+    } else if (kind == "map" && flag == "--desc") {
+      //MIN-MAX, or one length for both
+      unsigned long dash = value.find('-');
+      string low = value.substr(0, dash);
+      string high = dash == string::npos ? low : value.substr(dash + 1);
+      parsed = ParseNumber(low.c_str(), map.m_minDesc) && ParseNumber(high.c_str(), map.m_maxDesc)
+          && map.m_minDesc <= map.m_maxDesc;
+    } else if (kind == "craft" && flag == "--items") {
+      parsed = ParseNumber(value.c_str(), craft.m_items);
+    } else if (kind == "craft" && flag == "--layers") {
+      parsed = ParseNumber(value.c_str(), craft.m_layers);
+    } else if (kind == "craft" && flag == "--ingredients") {
+      parsed = ParseNumber(value.c_str(), craft.m_maxIngredients);
+    } else {
+      cout << "Unknown option for " << kind << ": " << flag << endl;
+      return 1;
+    }
+    if (!parsed) {
+      cout << "Bad value for " << flag << ": " << value << endl;
+      return 1;
+    }
+  }
+  string error;
+  bool written = kind == "map" ? GenerateMap(argv[2], map, error) : GenerateCraft(argv[2], craft, error);
+  if (!written) {
+    cout << "worldgen: " << error << endl;
+    return 1;
+  }
+  cout << "Wrote " << argv[2] << endl;
+  return 0;
+}